@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+#
+# Generates the lookup tables of the table driven fxp16 functions
+# (CONFIG_FXP16_LUT).
+#
+# Every table has 2^bits + 1 entries, so the linear interpolation between
+# entry i and i + 1 never needs a wrap around:
+#
+#     $ gen_fxp16_lut.py --bits 8 --output fxp16_lut.h
+
+import argparse
+import math
+
+
+def q(value, frac, lo, hi):
+    return max(lo, min(hi, int(math.floor(value * (1 << frac) + 0.5))))
+
+
+def tables(bits):
+    n = 1 << bits
+    x = [i / n for i in range(n + 1)]
+    return [
+        ('int16_t', 'fxp16_lut_sin',
+         'sin(x*pi/2), Q1.15',
+         [q(math.sin(t * math.pi / 2), 15, -32768, 32767) for t in x]),
+        ('int16_t', 'fxp16_lut_atan',
+         'atan(x)/pi, Q1.15 (pi-normalized angle)',
+         [q(math.atan(t) / math.pi, 15, -32768, 32767) for t in x]),
+        ('uint16_t', 'fxp16_lut_exp2',
+         '2^x, Q2.14',
+         [q(2.0 ** t, 14, 0, 65535) for t in x]),
+        ('uint16_t', 'fxp16_lut_log2',
+         'log2(1+x), Q1.15',
+         [q(math.log2(1.0 + t), 15, 0, 65535) for t in x]),
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generates the fxp16 lookup tables.')
+    parser.add_argument('--bits', type=int, required=True,
+                        help='log2 of the number of table intervals')
+    parser.add_argument('--output', required=True, help='header to write')
+    args = parser.parse_args()
+
+    if not 4 <= args.bits <= 12:
+        parser.error('--bits must be in 4..12')
+
+    out = [
+        '/* Generated by gen_fxp16_lut.py, do not edit. */',
+        '',
+        '#ifndef _FXP16_LUT_H_',
+        '#define _FXP16_LUT_H_',
+        '',
+        '#include <stdint.h>',
+        '',
+        '#define FXP16_LUT_BITS %d' % args.bits,
+        '',
+    ]
+    for ctype, name, desc, values in tables(args.bits):
+        out.append('/* %s for x = i/2^%d */' % (desc, args.bits))
+        out.append('static const %s %s[%d] = {' % (ctype, name, len(values)))
+        for i in range(0, len(values), 8):
+            out.append('    ' + ', '.join('%d' % v for v in values[i:i + 8]) + ',')
+        out.append('};')
+        out.append('')
+    out.append('#endif /* _FXP16_LUT_H_ */')
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -35,11 +35,75 @@
 */
 
 #include "fxp16.h"
+#include "fxp32.h"
 #include <math.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+
+#if FXP16CONF_LUT
+
+#include "fxp16_lut.h"
+
+/*
+ * The tables have FXP16_LUT_SIZE intervals. A position in a table is a 16 bit
+ * fraction of its range, the upper FXP16_LUT_BITS select the interval and the
+ * lower FXP16_LUT_SHIFT bits interpolate within it.
+ */
+#define FXP16_LUT_SIZE      (1L << FXP16_LUT_BITS)
+#define FXP16_LUT_SHIFT     (16 - FXP16_LUT_BITS)
+#define FXP16_LUT_MASK      ((1L << FXP16_LUT_SHIFT) - 1)
+#define FXP16_LUT_ONE       (1L << 16)
+
+static inline fxp32_t fxp16_lut_lerp(fxp32_t y0, fxp32_t y1, uint32_t w)
+{
+    return y0 + (((y1 - y0) * (fxp32_t)w + (1L << (FXP16_LUT_SHIFT - 1))) >> FXP16_LUT_SHIFT);
+}
+
+/* Interpolates table tab at pos in [0,FXP16_LUT_ONE]. */
+#define fxp16_lut_interp_m(tab,pos)                                             \
+    (((pos) >= FXP16_LUT_ONE) ? (fxp32_t)(tab)[FXP16_LUT_SIZE] :                \
+        fxp16_lut_lerp((tab)[(pos) >> FXP16_LUT_SHIFT],                         \
+                       (tab)[((pos) >> FXP16_LUT_SHIFT) + 1],                   \
+                       (pos) & FXP16_LUT_MASK))
+
+/* log2(e) in Q2.14 */
+#define FXP16_LUT_LOG2E_Q14     (23637)
+
+/*
+ * The angle is π-normalized Q1.15, so as uint16_t one full turn is 2^16 and the
+ * upper two bits are the quadrant. The table holds the first quadrant only.
+ */
+static fxp16_t fxp16_lut_sin_q15_pi(uint16_t u)
+{
+    uint32_t p = u & 0x3FFF;
+    fxp32_t s;
+
+    if (u & 0x4000)
+    {
+        p = 0x4000 - p;
+    }
+    s = fxp16_lut_interp_m(fxp16_lut_sin, p << 2);
+    return (u & 0x8000) ? (fxp16_t)-s : (fxp16_t)s;
+}
+
+static void fxp16_lut_sin_cos_q15_pi(fxp16_t angle_q15, fxp16_t* sin_q15, fxp16_t* cos_q15)
+{
+    *sin_q15 = fxp16_lut_sin_q15_pi((uint16_t)angle_q15);
+    *cos_q15 = fxp16_lut_sin_q15_pi((uint16_t)((uint16_t)angle_q15 + 0x4000));
+}
+
+    #define fxp16_sin_cos_q15_pi(angle,s,c) fxp16_lut_sin_cos_q15_pi(angle,s,c)
+#else
+    #define fxp16_sin_cos_q15_pi(angle,s,c) cordic_sin_cos_q15_pi(angle,s,c)
+#endif
 
 
 
@@ -532,16 +596,24 @@ void cordic_sin_cos_q15_pi(fxp16_t angle_q15, fxp16_t* sin_q15, fxp16_t* cos_q15
 
 fxp16_t fxp16_sin(fxp16_t rad)
 {
+#if FXP16CONF_LUT
+    return fxp16_lut_sin_q15_pi((uint16_t)rad);
+#else
     fxp16_t sin_q15, cos_q15;
     cordic_sin_cos_q15_pi(rad, &sin_q15, &cos_q15);
     return sin_q15;
+#endif
 }
 
 fxp16_t fxp16_cos(fxp16_t rad)
 {
+#if FXP16CONF_LUT
+    return fxp16_lut_sin_q15_pi((uint16_t)((uint16_t)rad + 0x4000));
+#else
     fxp16_t sin_q15,cos_q15;
     cordic_sin_cos_q15_pi(rad , &sin_q15, &cos_q15);
     return cos_q15;
+#endif
 }
 
 
@@ -560,7 +632,7 @@ fxp16_t fxp16_tan(fxp16_t fp, uint8_t frac)
             return INT16_MIN;
     }
 
-    cordic_sin_cos_q15_pi(fp, &sin_q15, &cos_q15);
+    fxp16_sin_cos_q15_pi(fp, &sin_q15, &cos_q15);
 
     x = (sin_q15<<FXP16_Q15)/cos_q15;
 
@@ -588,6 +660,33 @@ fxp16_t fxp16_atan2(fxp16_t y_in, fxp16_t x_in)
         return (y_in > 0) ? half_pi : (fxp16_t)(-half_pi);
     }
 
+#if FXP16CONF_LUT
+    // Oktant über das Verhältnis der Beträge, atan(t)/π aus der Tabelle
+    uint32_t ax = (x_in < 0) ? (uint32_t)(-(int32_t)x_in) : (uint32_t)x_in;
+    uint32_t ay = (y_in < 0) ? (uint32_t)(-(int32_t)y_in) : (uint32_t)y_in;
+    fxp32_t a;
+
+    if (ay <= ax)
+    {
+        a = fxp16_lut_interp_m(fxp16_lut_atan, (ay << 16) / ax);
+    }
+    else
+    {
+        a = FXP16_Q15_NORM_HALF_PI - fxp16_lut_interp_m(fxp16_lut_atan, (ax << 16) / ay);
+    }
+
+    if (x_in < 0)
+    {
+        a = (fxp32_t)FXP32_Q15_ONE - a;       // π - a
+    }
+    if (y_in < 0)
+    {
+        a = -a;
+    }
+
+    fxp16_sat_m(a);
+    return (fxp16_t)a;
+#else
     // Merke Original-Vorzeichen für Quadrantenkorrektur
     const int y_orig_nonneg = (y_in >= 0);
     const int x_orig_neg    = (x_in < 0);
@@ -634,6 +733,7 @@ fxp16_t fxp16_atan2(fxp16_t y_in, fxp16_t x_in)
     // End-Sättigung und Rückgabe
     fxp16_sat_m(Z);
     return (fxp16_t)(int16_t)Z;
+#endif
 }
 
 
@@ -699,105 +799,6 @@ fxp16_t fxp16_acos(fxp16_t x)
     return fxp16_atan2(c, (fxp16_t)xi);
 }
 
-#define FXP32_Q15         (15)
-#define FXP32_SAT_MAX     (INT32_MAX)
-#define FXP32_SAT_MIN     (INT32_MIN)
-
-/*!
-    \brief      Saturating arithmetic left shift
-    \details    Shifts the 32-bit value \p v left by \p n bits and saturates the result
-                to the range [FXP32_SAT_MIN, FXP32_SAT_MAX].
-                If \p n <= 0, \p v is returned unchanged.
-                If \p n >= 31, the result is immediately saturated depending on the sign of \p v.
-
-    \param[in]  v    32-bit input value (e.g. fixed-point number).
-    \param[in]  n    Number of bits to shift (n ≥ 0).
-
-    \returns    v << n with saturation, equivalent to saturating v · 2ⁿ.
-*/
-static inline fxp32_t fxp32_sat_shl(fxp32_t v, int n) {
-    if (n <= 0) return v;
-    if (n >= 31) return (v >= 0) ? FXP32_SAT_MAX : FXP32_SAT_MIN;
-    int64_t w = (int64_t)v << n;
-    if (w > FXP32_SAT_MAX) return FXP32_SAT_MAX;
-    if (w < FXP32_SAT_MIN) return FXP32_SAT_MIN;
-    return (fxp32_t)w;
-}
-
-/*!
-    \brief      Arithmetic right shift with rounding toward +∞ for non-negative values
-    \details    Shifts the 32-bit integer \p v right by \p n bits arithmetically.
-                For \p v >= 0, adds 2^(n-1) before shifting to round toward +∞.
-                For \p v < 0, performs a plain arithmetic shift (no +0.5 rounding).
-                If \p n <= 0, returns \p v unchanged. If \p n >= 31, the result is
-                0 for non-negative \p v, or -1 for negative \p v (all bits shifted out).
-                Useful for fixed-point scaling equivalent to division by 2^n.
-
-    \param[in]  v    32-bit signed input value (e.g., fixed-point).
-    \param[in]  n    Number of bits to shift right (n ≥ 0).
-
-    \returns    \p v >> n with arithmetic semantics; for \p v >= 0 the result is
-                rounded toward +∞, otherwise no rounding is applied.
-*/
-static inline fxp32_t fxp32_shr_r(fxp32_t v, int n) {
-    if (n <= 0) return v;
-    if (n >= 31) return (v >= 0) ? 0 : -1; /* alles weg */
-    if (v >= 0) return (v + (1 << (n - 1))) >> n;
-    else        return (v >> n); /* negatives: arithmetisch, kein +0.5 Rundung */
-}
-
-/*!
-    \brief      Q15 multiply with 64-bit intermediate and rounding
-    \details    Multiplies two signed Q15 fixed-point values \p a and \p b using a 64-bit
-                intermediate (Q30), adds 2^(Q15-1) for rounding, then shifts right by Q15.
-                The final result is saturated to [FXP32_SAT_MIN, FXP32_SAT_MAX].
-
-    \param[in]  a    32-bit signed Q15 operand.
-    \param[in]  b    32-bit signed Q15 operand.
-
-    \returns    Q15 product of \p a and \p b, rounded (via bias + shift) and saturated.
-*/
-static inline fxp32_t fxp32_mul_q15(fxp32_t a, fxp32_t b) {
-    int64_t t = (int64_t)a * (int64_t)b;          // Q30
-    t += (int64_t)1 << (FXP32_Q15 - 1);                 // rundung
-    t >>= FXP32_Q15;
-    if (t > FXP32_SAT_MAX) return FXP32_SAT_MAX;
-    if (t < FXP32_SAT_MIN) return FXP32_SAT_MIN;
-    return (fxp32_t)t;
-}
-
-/*!
-    \brief      Q15 scaling by power of two
-    \details    Scales \p v by 2^n in Q15 format:
-                for \p n >= 0 uses saturating left shift (fxp32_sat_shl),
-                for \p n < 0 uses arithmetic right shift with rounding (fxp32_shr_r).
-
-    \param[in]  v    32-bit signed Q15 value to scale.
-    \param[in]  n    Power-of-two exponent; n >= 0 ⇒ left shift, n < 0 ⇒ right shift.
-
-    \returns    \p v · 2^n in Q15, with saturation for left shifts and rounding on right shifts.
-*/
-static inline fxp32_t fxp32_scale_pow2_q15(fxp32_t v, int n) {
-    if (n >= 0) return fxp32_sat_shl(v, n);
-    else        return fxp32_shr_r(v, -n);
-}
-
-
-/*!
-    \brief      Saturating 32-bit addition without 64-bit intermediate
-    \details    Adds \p a and \p b using 32-bit arithmetic and clamps the result to
-                [FXP32_SAT_MIN, FXP32_SAT_MAX] on overflow or underflow. No int64 is used.
-
-    \param[in]  a    32-bit signed addend.
-    \param[in]  b    32-bit signed addend.
-
-    \returns    a + b if representable; otherwise FXP32_SAT_MAX or FXP32_SAT_MIN.
-*/
-static inline fxp32_t fxp32_add_sat32(fxp32_t a, fxp32_t b) {
-    if (b > 0 && a > FXP32_SAT_MAX - b) return FXP32_SAT_MAX;
-    if (b < 0 && a < FXP32_SAT_MIN - b) return FXP32_SAT_MIN;
-    return a + b;
-}
 
 /*!
     \brief      Sign-aware saturation to Q15 limits for sinh/cosh
@@ -966,38 +967,6 @@ static void fxp32_cordic_cosh_sinh_q15(fxp32_t x, fxp32_t *out_cosh, fxp32_t *ou
     *out_sinh = sinh_x;
 }
 
-/*!
-    \brief      Q15 division with rounding and saturation to (-1, 1)
-    \details    Computes (num / den) in Q15. Uses a 64-bit intermediate:
-                (num << Q15) / den, with sign-aware ±0.5 bias for rounding to nearest.
-                den == 0 returns the maximum magnitude less than 1 with the sign of num.
-                Result is saturated to (-1, 1) in Q15 (i.e., ±(1 − 1/2^15)).
-
-    \param[in]  num   Q15 numerator (signed 32-bit).
-    \param[in]  den   Q15 denominator (signed 32-bit).
-
-    \returns    Rounded Q15 quotient in (-1, 1), saturated on overflow or den == 0.
-*/
-static  inline fxp32_t fxp32_div_q15(fxp32_t num, fxp32_t den) {
-    if (den == 0) return (num >= 0) ? (FXP32_Q15_ONE - 1) : -(FXP32_Q15_ONE - 1);
-
-    /* Runden zum nächsten: Vorzeichen von Zähler/Nenner beachten */
-    int64_t n = (int64_t)num << FXP32_Q15;      // Q15-Nenner-Ziel
-    if (( (num ^ den) & 0x80000000 ) == 0) {
-        // gleiches Vorzeichen -> +0.5 zum Runden
-        n += (den >= 0 ? (den >> 1) : -((-(int64_t)den) >> 1));
-    } else {
-        // unterschiedliches Vorzeichen -> -0.5 zum Runden
-        n -= (den >= 0 ? (den >> 1) : -((-(int64_t)den) >> 1));
-    }
-
-    int64_t q = n / den;
-
-    /* Begrenzen in (-1,1) auf Q15: tanh erreicht nie exakt ±1 */
-    if (q >= (int64_t)FXP32_Q15_ONE)     q = FXP32_Q15_ONE - 1;
-    if (q <= -(int64_t)FXP32_Q15_ONE)    q = -(FXP32_Q15_ONE - 1);
-    return (fxp32_t)q;
-}
 
 #define TANH_EARLY_SAT_Q15  ( (fxp32_t)(12 * FXP32_Q15_ONE) )  /* ~|x|>=12 -> ±1 */
 
@@ -1090,6 +1059,32 @@ fxp16_t fxp16_tanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 */
 fxp16_t fxp16_exp(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 {
+#if FXP16CONF_LUT
+    /* e^x = 2^(x*log2(e)) = 2^n * 2^f, z hat x_frac+14 Nachkommabits */
+    fxp32_t z = (fxp32_t)x * FXP16_LUT_LOG2E_Q14;
+    int zfrac = x_frac + 14;
+    int n = z >> zfrac;                                         /* floor */
+    uint32_t f = (uint32_t)z & ((1UL << zfrac) - 1);
+
+    /* Bruchteil als 16-Bit-Position in der Tabelle */
+    f = (zfrac >= 16) ? (f >> (zfrac - 16)) : (f << (16 - zfrac));
+
+    /* 2^f in Q14, [1.0, 2.0] */
+    fxp32_t e = fxp16_lut_interp_m(fxp16_lut_exp2, f);
+    int shift = n + y_frac - 14;
+
+    if (shift > 1)
+    {
+        return INT16_MAX;
+    }
+    if (shift < -16)
+    {
+        return 0;
+    }
+    fpxx_ashift_m(e, -shift);
+    fxp16_sat_m(e);
+    return (fxp16_t)e;
+#else
     fxp32_t fxp32_x = x;          /* Promotion nach 32 Bit */
     fxp32_t c, s;                  /* cosh und sinh in Q15 */
     fxp32_t e;                     /* e^x in Q15 */
@@ -1108,6 +1103,7 @@ fxp16_t fxp16_exp(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
     fxp16_sat_m(e);
 
     return (fxp16_t)e;
+#endif
 }
 
 
@@ -1130,6 +1126,13 @@ static fxp32_t fxp32_log2_q15(fxp32_t x)
     /* 1) Normieren: x = m * 2^p, mit m in [1,2) (alles in Q15-Repr.) */
     uint32_t ux = (uint32_t)x;
     int p = msb_u32(ux);
+
+#if FXP16CONF_LUT
+    /* Bits unterhalb des MSB als 16-Bit-Position, log2(m) aus der Tabelle */
+    uint32_t f = (p >= 16) ? (ux >> (p - 16)) : (ux << (16 - p));
+
+    return (((fxp32_t)(p - 15)) << 15) + fxp16_lut_interp_m(fxp16_lut_log2, f & 0xFFFF);
+#else
     fxp32_t m_q15;
     {
         int sh = 15 - p;
@@ -1158,6 +1161,7 @@ static fxp32_t fxp32_log2_q15(fxp32_t x)
     }
 
     return acc_q15;
+#endif
 }
 
 
@@ -1356,3 +1360,147 @@ fxp16_t fxp16_fma (fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, fxp16_t z
    return (fxp16_t)result;
 }
 
+
+
+/* Vector operations */
+
+#if defined(__ARM_FEATURE_SIMD32)
+
+/* Loads two numbers into one register, the arrays need not be word aligned. */
+static inline int16x2_t fxp16_vld2(const fxp16_t *p)
+{
+    int16x2_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void fxp16_vst2(fxp16_t *p, int16x2_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+#define fxp16_vop2_m(dst,a,b,n,op)                                              \
+    do{                                                                         \
+        for (; (n) >= 2; (n) -= 2, (dst) += 2, (a) += 2, (b) += 2){             \
+            fxp16_vst2((dst), op(fxp16_vld2(a), fxp16_vld2(b)));                \
+        }}while(0)
+
+#endif
+
+
+void fxp16_vadd(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    fxp16_vop2_m(dst, a, b, n, __sadd16);
+#endif
+    for (size_t i = 0; i < n; i++){
+        dst[i] = (fxp16_t)(a[i] + b[i]);
+    }
+}
+
+void fxp16_vadd_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    fxp16_vop2_m(dst, a, b, n, __qadd16);
+#endif
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fxp16_sat((fxp32_t)a[i] + b[i]);
+    }
+}
+
+void fxp16_vsub(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    fxp16_vop2_m(dst, a, b, n, __ssub16);
+#endif
+    for (size_t i = 0; i < n; i++){
+        dst[i] = (fxp16_t)(a[i] - b[i]);
+    }
+}
+
+void fxp16_vsub_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    fxp16_vop2_m(dst, a, b, n, __qsub16);
+#endif
+    for (size_t i = 0; i < n; i++){
+        dst[i] = fxp16_sat((fxp32_t)a[i] - b[i]);
+    }
+}
+
+void fxp16_vmul(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++){
+        fxp32_t result = (fxp32_t)a[i]*(fxp32_t)b[i];
+        fpxx_arshift_m(result, frac);
+        dst[i] = (fxp16_t)result;
+    }
+}
+
+void fxp16_vmul_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++){
+        fxp32_t result = (fxp32_t)a[i]*(fxp32_t)b[i];
+        fpxx_arshift_m(result, frac);
+        dst[i] = fxp16_sat(result);
+    }
+}
+
+void fxp16_vfma(fxp16_t *dst, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++){
+        fxp32_t result = (fxp32_t)x[i]*(fxp32_t)y[i];
+        fpxx_arshift_m(result, frac);
+        dst[i] = (fxp16_t)(result + z[i]);
+    }
+}
+
+void fxp16_vfma_sat(fxp16_t *dst, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++){
+        fxp32_t result = (fxp32_t)x[i]*(fxp32_t)y[i];
+        fpxx_arshift_m(result, frac);
+        dst[i] = fxp16_sat(result + z[i]);
+    }
+}
+
+fxp32_t fxp16_vdot(const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+    uint32_t acc = 0;
+
+#if defined(__ARM_FEATURE_SIMD32)
+    for (; n >= 2; n -= 2, a += 2, b += 2){
+        acc = (uint32_t)__smlad(fxp16_vld2(a), fxp16_vld2(b), (int32_t)acc);
+    }
+#endif
+    for (size_t i = 0; i < n; i++){
+        acc += (uint32_t)((fxp32_t)a[i]*(fxp32_t)b[i]);
+    }
+    return (fxp32_t)acc;
+}
+
+fxp16_t fxp16_vdot_sat(const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac)
+{
+    return fxp64_to_fxp16(fxp16_acc_mac(0, a, b, n), frac);
+}
+
+fxp64_t fxp16_acc_add(fxp64_t acc, const fxp16_t *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++){
+        acc += x[i];
+    }
+    return acc;
+}
+
+fxp64_t fxp16_acc_mac(fxp64_t acc, const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+#if defined(__ARM_FEATURE_SIMD32)
+    for (; n >= 2; n -= 2, a += 2, b += 2){
+        acc = __smlald(fxp16_vld2(a), fxp16_vld2(b), acc);
+    }
+#endif
+    for (size_t i = 0; i < n; i++){
+        acc += (fxp32_t)a[i]*(fxp32_t)b[i];
+    }
+    return acc;
+}
@@ -46,6 +46,7 @@
 #warning "This lib is still in development"
 
 #include <stdint.h>
+#include <stddef.h>
 #include <limits.h>
 
 #define FXP16_RADIX 2
@@ -737,6 +738,17 @@ fxp16_t fxp16_sat(fxp32_t fxp32);
 
 #define FXP16CONF_ARSHIFT_W_ROUNDING 1
 
+/*!
+    \brief      Use the lookup tables for sin/cos/tan/atan2/exp/log instead of CORDIC
+    \details    Set by CONFIG_FXP16_LUT. The tables are generated at build time by
+                scripts/gen_fxp16_lut.py into fxp16_lut.h.
+*/
+#if defined(CONFIG_FXP16_LUT)
+    #define FXP16CONF_LUT 1
+#else
+    #define FXP16CONF_LUT 0
+#endif
+
 #if FXP16CONF_ARSHIFT_W_ROUNDING
 
     #define fpxx_arshift_m(result,rshift)                                           \
@@ -866,6 +878,77 @@ fxp16_t fxp16_mult(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2);
 fxp16_t fxp16_div(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t frac2);
 
 
+/*!
+    \defgroup   fxp16_vector Vector operations
+    \brief      Element-wise and dot product operations on fxp16_t arrays.
+    \details    All arrays hold n numbers of the same fixed point format. The destination
+                may be one of the sources.
+
+            **Provided APIs**
+            - \ref fxp16_vadd, \ref fxp16_vsub – element-wise sum and difference.
+            - \ref fxp16_vmul – element-wise product.
+            - \ref fxp16_vfma – element-wise fused multiply-add x*y+z.
+            - \ref fxp16_vdot – dot product.
+
+            Every function comes in a wrapping variant, whose results wrap around like
+            int16_t arithmetic, and a saturating variant with the suffix _sat, whose results
+            are the same as the ones of the scalar functions (fxp16_add(), fxp16_mult(), ...).
+
+            **Implementation**
+            - If the compiler provides the ACLE SIMD32 intrinsics (__ARM_FEATURE_SIMD32,
+              i.e. Cortex-M4/M7 with DSP extension), additions and subtractions process two
+              numbers per instruction (SADD16/QADD16) and the dot products two products per
+              instruction (SMLAD/SMLALD).
+            - The DSP extension has no packed multiply with a 16 bit result, so fxp16_vmul and
+              fxp16_vfma use the scalar path on all cores.
+            - Without SIMD32 (e.g. Cortex-M0+) all functions use the scalar path.
+
+@{
+*/
+
+void fxp16_vadd(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n);
+void fxp16_vadd_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n);
+void fxp16_vsub(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n);
+void fxp16_vsub_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n);
+
+/*!
+    \brief      Multiplies two arrays element-wise
+    \details    dst[i] = a[i]*b[i], rounded like fxp16_mult(a[i],frac,b[i],frac).
+    \param      frac    Number of fractional bits of all arrays
+*/
+void fxp16_vmul(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac);
+void fxp16_vmul_sat(fxp16_t *dst, const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac);
+
+/*!
+    \brief      Fused multiply-add of three arrays element-wise
+    \details    dst[i] = x[i]*y[i]+z[i], like fxp16_fma(x[i],frac,y[i],frac,z[i],frac).
+    \param      frac    Number of fractional bits of all arrays
+*/
+void fxp16_vfma(fxp16_t *dst, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z, size_t n, uint8_t frac);
+void fxp16_vfma_sat(fxp16_t *dst, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z, size_t n, uint8_t frac);
+
+/*!
+    \brief      Dot product of two arrays
+    \details    Sums up the products in a 32 bit accumulator, which wraps around on overflow.
+                The products are not shifted, i.e. the result has twice the fractional bits of
+                the arrays.
+    \returns    Sum of a[i]*b[i]
+*/
+fxp32_t fxp16_vdot(const fxp16_t *a, const fxp16_t *b, size_t n);
+
+/*!
+    \brief      Dot product of two arrays with saturated result
+    \details    Sums up the products in a 64 bit accumulator, then shifts the sum by frac
+                with rounding and saturates it. Unlike a chain of fxp16_fma() calls, only the
+                final sum is rounded.
+    \param      frac    Number of fractional bits of both arrays and the result
+    \returns    Sum of a[i]*b[i]
+*/
+fxp16_t fxp16_vdot_sat(const fxp16_t *a, const fxp16_t *b, size_t n, uint8_t frac);
+
+/*! @} */
+
+
 /*!
     \defgroup   fxp16_trig Trigonometric functions (π-normalized fixed-point)
     \brief      CORDIC-based trig for Q1.15 with π-normalized angles.
@@ -891,6 +974,23 @@ fxp16_t fxp16_div(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t frac
     - Pre-scaled CORDIC gain: `K ≈ 0.607252935` (Q1.15 `0x4DBA`).
     - Lookup: `atan(2^-i)/π` table in Q1.15 for i=0..13.
 
+    ## Table driven implementation (CONFIG_FXP16_LUT)
+    fxp16_sin, fxp16_cos, fxp16_tan and fxp16_atan2 as well as fxp16_exp and the
+    fxp16_log family interpolate linearly in tables of 2^CONFIG_FXP16_LUT_BITS intervals:
+    a quarter sine wave, atan(t)/π for t in [0,1], 2^f and log2(1+f) for f in [0,1].
+    The call costs one table lookup and one multiplication instead of 14-16 iterations,
+    atan2 needs one division in addition.
+
+    Maximum error against libm over all inputs (atan2 over a grid of both arguments):
+    | Function                 | CORDIC       | LUT_BITS=6 | LUT_BITS=8 | LUT_BITS=12 |
+    |--------------------------|--------------|------------|------------|-------------|
+    | sin, cos (Q1.15 LSB)     | 12           | 3.5        | 1.0        | 1.0         |
+    | atan2 (Q1.15 LSB)        | 605 (2 rms)  | 1.2        | 1.1        | 1.0         |
+    | exp, Q12 in/out (LSB)    | 12           | 1.3        | 1.4        | 1.4         |
+    | log, Q8 in, Q11 out (LSB)| 1.0          | 1.0        | 1.0        | 1.0         |
+
+    The CORDIC atan2 loses its precision for arguments below about 32 LSB.
+
 @{ */
 
 /*!
@@ -1345,4 +1445,110 @@ fxp16_t fxp16_fma (fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, fxp16_t z
 */
 #define fxp16_signbit(x) (x<0)
 
+
+
+/* Inline Q-format specialized arithmetic */
+
+
+/*!
+    \brief      Adds two fixed point numbers (inline)
+    \details    Same as fxp16_add(), but expanded at the call site.
+*/
+static inline fxp16_t fxp16_add_inline(fxp16_t summand1, fxp16_t summand2)
+{
+    fxp32_t result = (fxp32_t)summand1 + summand2;
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+/*!
+    \brief      Subtracts two fixed point numbers (inline)
+    \details    Same as fxp16_sub(), but expanded at the call site.
+*/
+static inline fxp16_t fxp16_sub_inline(fxp16_t minuend, fxp16_t subtrahend)
+{
+    fxp32_t result = (fxp32_t)minuend - subtrahend;
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+
+/*!
+    \brief      Rounding right shift by a constant, same as fpxx_arshift_m()
+    \details    Does not shift by a negative count if q is 0.
+*/
+#if FXP16CONF_ARSHIFT_W_ROUNDING
+    #define fxp16_qn_arshift_m(result,q)                                            \
+        do{                                                                         \
+            if ((q) > 0){                                                           \
+            result = (result)>>((q) > 0 ? (q)-1 : 0);                               \
+            result = fxp16_signbit(result)?(result>>1):((result>>1) + (result&1));  \
+            }}while(0)
+#else
+    #define fxp16_qn_arshift_m(result,q) do{result>>=(q);}while(0)
+#endif
+
+
+/*!
+    \brief      Defines the inline arithmetic for one Q format
+    \details    For q fractional bits this defines
+
+                - fxp16_int2fp_q<q>(intpart)  same as fxp16_int2fp(intpart,q)
+                - fxp16_mult_q<q>(a,b)        same as fxp16_mult(a,q,b,q)
+                - fxp16_div_q<q>(a,b)         same as fxp16_div(a,q,b,q)
+                - fxp16_fma_q<q>(x,y,z)       same as fxp16_fma(x,q,y,q,z,q)
+
+                The results are bit-identical to the out-of-line functions, but the
+                shifts are compile time constants, so the compiler folds the shifts
+                and the rounding and inlines the saturation. Use these in inner loops
+                whose operands all have the same format.
+
+    \param      q   Number of fractional bits, a literal from 0 to 15
+*/
+#define FXP16_QN_INLINE_DEFINE(q)                                                   \
+    static inline fxp16_t fxp16_int2fp_q##q(int16_t intpart)                          \
+    {                                                                               \
+        fxp32_t result = (fxp32_t)intpart * (1L << (q));                            \
+        fxp16_sat_m(result);                                                        \
+        return (fxp16_t)result;                                                     \
+    }                                                                               \
+    static inline fxp16_t fxp16_mult_q##q(fxp16_t mult1, fxp16_t mult2)               \
+    {                                                                               \
+        fxp32_t result = (fxp32_t)mult1 * (fxp32_t)mult2;                           \
+        fxp16_qn_arshift_m(result, (q));                                            \
+        fxp16_sat_m(result);                                                        \
+        return (fxp16_t)result;                                                     \
+    }                                                                               \
+    static inline fxp16_t fxp16_div_q##q(fxp16_t divident, fxp16_t divisor)           \
+    {                                                                               \
+        fxp32_t result = ((fxp32_t)divident * (1L << (q))) / divisor;               \
+        fxp16_sat_m(result);                                                        \
+        return (fxp16_t)result;                                                     \
+    }                                                                               \
+    static inline fxp16_t fxp16_fma_q##q(fxp16_t x, fxp16_t y, fxp16_t z)             \
+    {                                                                               \
+        fxp32_t result = (fxp32_t)x * (fxp32_t)y;                                   \
+        fxp16_qn_arshift_m(result, (q));                                            \
+        result += z;                                                                \
+        fxp16_sat_m(result);                                                        \
+        return (fxp16_t)result;                                                     \
+    }
+
+FXP16_QN_INLINE_DEFINE(0)
+FXP16_QN_INLINE_DEFINE(1)
+FXP16_QN_INLINE_DEFINE(2)
+FXP16_QN_INLINE_DEFINE(3)
+FXP16_QN_INLINE_DEFINE(4)
+FXP16_QN_INLINE_DEFINE(5)
+FXP16_QN_INLINE_DEFINE(6)
+FXP16_QN_INLINE_DEFINE(7)
+FXP16_QN_INLINE_DEFINE(8)
+FXP16_QN_INLINE_DEFINE(9)
+FXP16_QN_INLINE_DEFINE(10)
+FXP16_QN_INLINE_DEFINE(11)
+FXP16_QN_INLINE_DEFINE(12)
+FXP16_QN_INLINE_DEFINE(13)
+FXP16_QN_INLINE_DEFINE(14)
+FXP16_QN_INLINE_DEFINE(15)
+
 #endif /* _FXP16_H_ */
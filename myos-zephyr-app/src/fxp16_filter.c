@@ -0,0 +1,108 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*!
+    \file   fxp16_filter.c
+
+    \brief  FIR, biquad and decimation filters on fxp16 samples
+
+    \details
+*/
+
+#include "fxp16_filter.h"
+
+
+fxp16_t fxp16_fir_dot(const fxp16_t *delay, size_t taps, size_t head, const fxp16_t *coeffs, uint8_t frac)
+{
+    /* delay[head..taps) are the older, delay[0..head) the newer samples */
+    fxp64_t acc = fxp16_acc_mac(0, delay + head, coeffs, taps - head);
+    acc = fxp16_acc_mac(acc, delay, coeffs + (taps - head), head);
+    return fxp64_to_fxp16(acc, frac);
+}
+
+
+void fxp16_biquad_df1_init(fxp16_biquad_df1_t *bq, const fxp16_biquad_coeffs_t *coeffs)
+{
+    bq->coeffs = coeffs;
+    bq->x1 = bq->x2 = 0;
+    bq->y1 = bq->y2 = 0;
+}
+
+fxp16_t fxp16_biquad_df1(fxp16_biquad_df1_t *bq, fxp16_t x)
+{
+    const fxp16_biquad_coeffs_t *c = bq->coeffs;
+    fxp64_t acc = (fxp32_t)c->b0 * x;
+    fxp16_t y;
+
+    acc += (fxp32_t)c->b1 * bq->x1;
+    acc += (fxp32_t)c->b2 * bq->x2;
+    acc -= (fxp32_t)c->a1 * bq->y1;
+    acc -= (fxp32_t)c->a2 * bq->y2;
+    y = fxp64_to_fxp16(acc, c->frac);
+
+    bq->x2 = bq->x1;
+    bq->x1 = x;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+
+void fxp16_biquad_df1_block(fxp16_biquad_df1_t *bq, const fxp16_t *in, fxp16_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = fxp16_biquad_df1(bq, in[i]);
+    }
+}
+
+
+void fxp16_biquad_df2t_init(fxp16_biquad_df2t_t *bq, const fxp16_biquad_coeffs_t *coeffs)
+{
+    bq->coeffs = coeffs;
+    bq->s1 = bq->s2 = 0;
+}
+
+fxp16_t fxp16_biquad_df2t(fxp16_biquad_df2t_t *bq, fxp16_t x)
+{
+    const fxp16_biquad_coeffs_t *c = bq->coeffs;
+    fxp16_t y = fxp64_to_fxp16((fxp64_t)((fxp32_t)c->b0 * x) + bq->s1, c->frac);
+
+    /* All terms have the fractional bits of the input plus frac */
+    bq->s1 = (fxp64_t)((fxp32_t)c->b1 * x) - (fxp64_t)((fxp32_t)c->a1 * y) + bq->s2;
+    bq->s2 = (fxp64_t)((fxp32_t)c->b2 * x) - (fxp64_t)((fxp32_t)c->a2 * y);
+    return y;
+}
+
+void fxp16_biquad_df2t_block(fxp16_biquad_df2t_t *bq, const fxp16_t *in, fxp16_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = fxp16_biquad_df2t(bq, in[i]);
+    }
+}
@@ -0,0 +1,290 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*!
+    \file   fxp16_filter.h
+
+    \brief  FIR, biquad and decimation filters on fxp16 samples
+
+    \details All filters keep a wide accumulator per output sample, so the sum of products
+             is rounded and saturated once instead of after every fxp16_mult()/fxp16_add().
+             Samples and coefficients may have different formats: the output has the format
+             of the input, the coefficients have \p frac fractional bits, e.g. FXP16_Q15 for
+             FIR coefficients below 1.0 or FXP16_Q14 for biquad coefficients below 2.0.
+
+             - FIR: the delay line is a ringbuffer (ringbuffer.h) which is kept full. The
+               sum of products runs over its two contiguous halves with fxp16_acc_mac(),
+               i.e. two samples per instruction on cores with SIMD32.
+             - Biquads: Direct-Form-I with fxp16 state, and transposed Direct-Form-II with
+               64 bit state for high-Q sections.
+             - Decimation: a FIR which only computes every factor-th output.
+
+             Every filter has a per sample and a block interface. PROCESS_FXP16_FILTER()
+             runs a filter as a protothread stage between two channels (channel.h).
+
+    Usage Example:
+    \code
+        // 8 tap moving average, Q15 coefficients
+        static const fxp16_t avg_coeffs[8] = { 4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096 };
+
+        FXP16_FIR_TYPEDEF(avg, 8);
+        static FXP16_FIR_T(avg) avg;
+
+        CHANNEL_TYPEDEF_POW2(samples, fxp16_t, 5);
+        static CHANNEL_T(samples) raw, smooth;
+
+        PROCESS_THREAD(smoother)
+        {
+            fxp16_t x, y;
+
+            PROCESS_BEGIN();
+            FXP16_FIR_INIT(avg, avg_coeffs, FXP16_Q15, 1);
+            PROCESS_FXP16_FILTER(raw, smooth, x, y, FXP16_FIR_STEP(avg, x, y));
+            PROCESS_END();
+        }
+    \endcode
+*/
+
+#ifndef _FXP16_FILTER_H_
+#define _FXP16_FILTER_H_
+
+#include "fxp16.h"
+#include "fxp32.h"
+#include "myos.h"
+#include "ringbuffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*!
+    \defgroup   fxp16_fir FIR filters and decimators
+    \brief      FIR filters with a ringbuffer delay line.
+    \details    The coefficients are in time reversed order, i.e. coeffs[0] is applied to
+                the oldest and coeffs[taps-1] to the newest sample (like CMSIS-DSP).
+                Symmetric (linear phase) filters are not affected.
+
+@{
+*/
+
+/*!
+    \brief      Declares a FIR filter type
+    \param      name    Name of the filter type, the type is name##_fir_t
+    \param      taps    Number of coefficients
+*/
+#define FXP16_FIR_TYPEDEF(name,taps)                                                \
+    RINGBUFFER_TYPEDEF(name##_fir_delay, fxp16_t, taps);                            \
+    typedef struct {                                                                \
+        RINGBUFFER_T(name##_fir_delay) delay;                                       \
+        const fxp16_t *coeffs;                                                      \
+        uint8_t frac;                                                               \
+        uint8_t factor;                                                             \
+        uint8_t phase;                                                              \
+    } name##_fir_t
+
+/*!
+    \brief      FIR filter type declared by FXP16_FIR_TYPEDEF()
+*/
+#define FXP16_FIR_T(name) \
+    name##_fir_t
+
+/*!
+    \brief      Initializes a FIR filter with an all zero delay line
+    \param      fir         The filter instance
+    \param      coeffsptr   Coefficients, must stay valid while the filter is used
+    \param      coeffsfrac  Number of fractional bits of the coefficients
+    \param      decimation  Decimation factor for FXP16_FIR_DECIMATE(), 1 otherwise
+*/
+#define FXP16_FIR_INIT(fir,coeffsptr,coeffsfrac,decimation)                         \
+    do{                                                                             \
+        RINGBUFFER_INIT((fir).delay);                                               \
+        while (!RINGBUFFER_FULL((fir).delay)){                                      \
+            RINGBUFFER_WRITE((fir).delay, 0);                                       \
+        }                                                                           \
+        (fir).coeffs = (coeffsptr);                                                 \
+        (fir).frac = (coeffsfrac);                                                  \
+        (fir).factor = (decimation);                                                \
+        (fir).phase = 0;                                                            \
+    }while(0)
+
+/*!
+    \brief      Shifts one sample into the delay line without computing an output
+*/
+#define FXP16_FIR_PUSH(fir,x)                                                       \
+    do{                                                                             \
+        RINGBUFFER_POP((fir).delay);                                                \
+        RINGBUFFER_WRITE((fir).delay, (x));                                         \
+    }while(0)
+
+/*!
+    \brief      Output of a FIR filter for the samples in the delay line
+*/
+#define FXP16_FIR_OUTPUT(fir)                                                       \
+    fxp16_fir_dot(RINGBUFFER_ITEMS((fir).delay), RINGBUFFER_SIZE((fir).delay),      \
+                  RINGBUFFER_HEAD((fir).delay), (fir).coeffs, (fir).frac)
+
+/*!
+    \brief      Filters one sample
+    \param      fir     The filter instance
+    \param      x       Input sample
+    \param      y       Lvalue which receives the output sample
+*/
+#define FXP16_FIR_STEP(fir,x,y)                                                     \
+    do{                                                                             \
+        FXP16_FIR_PUSH(fir, x);                                                     \
+        (y) = FXP16_FIR_OUTPUT(fir);                                                \
+    }while(0)
+
+/*!
+    \brief      Filters a block of samples
+    \details    in and out may be the same array.
+    \param      fir     The filter instance
+    \param      in      Input samples
+    \param      out     Output samples, n of them
+    \param      n       Number of samples
+*/
+#define FXP16_FIR_BLOCK(fir,in,out,n)                                               \
+    do{                                                                             \
+        for (size_t fxp16_fir_i_ = 0; fxp16_fir_i_ < (n); fxp16_fir_i_++){          \
+            FXP16_FIR_STEP(fir, (in)[fxp16_fir_i_], (out)[fxp16_fir_i_]);           \
+        }                                                                           \
+    }while(0)
+
+/*!
+    \brief      Filters and decimates a block of samples
+    \details    Only every factor-th output is computed, the others are only shifted into
+                the delay line. The phase carries over from block to block. in and out may
+                be the same array.
+    \param      fir     The filter instance, initialized with the decimation factor
+    \param      in      Input samples
+    \param      n       Number of input samples
+    \param      out     Output samples, at most n/factor+1 of them
+    \param      nout    Lvalue which receives the number of output samples
+*/
+#define FXP16_FIR_DECIMATE(fir,in,n,out,nout)                                       \
+    do{                                                                             \
+        size_t fxp16_fir_n_ = 0;                                                    \
+        for (size_t fxp16_fir_i_ = 0; fxp16_fir_i_ < (n); fxp16_fir_i_++){          \
+            FXP16_FIR_PUSH(fir, (in)[fxp16_fir_i_]);                                \
+            if (++(fir).phase >= (fir).factor){                                     \
+                (fir).phase = 0;                                                    \
+                (out)[fxp16_fir_n_++] = FXP16_FIR_OUTPUT(fir);                      \
+            }                                                                       \
+        }                                                                           \
+        (nout) = fxp16_fir_n_;                                                      \
+    }while(0)
+
+/*!
+    \brief      Sum of products of a full FIR delay line
+    \details    Used by the FIR macros. The oldest sample is at delay[head].
+    \returns    Output sample in the format of the delay line
+*/
+fxp16_t fxp16_fir_dot(const fxp16_t *delay, size_t taps, size_t head, const fxp16_t *coeffs, uint8_t frac);
+
+/*! @} */
+
+
+/*!
+    \defgroup   fxp16_biquad Biquad filters
+    \brief      Second order IIR sections.
+    \details    H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+
+                The signs of a1 and a2 are as in the transfer function (like scipy and
+                MATLAB, unlike CMSIS-DSP). Higher orders are cascades of sections, each
+                block is passed through all sections in turn.
+
+@{
+*/
+
+/*!
+    \brief      Coefficients of a biquad, shareable by several filters
+*/
+typedef struct {
+    fxp16_t b0, b1, b2;
+    fxp16_t a1, a2;
+    uint8_t frac;
+} fxp16_biquad_coeffs_t;
+
+/*!
+    \brief      Direct-Form-I biquad
+    \details    The state holds the last two inputs and outputs, so no internal node can
+                overflow.
+*/
+typedef struct {
+    const fxp16_biquad_coeffs_t *coeffs;
+    fxp16_t x1, x2;
+    fxp16_t y1, y2;
+} fxp16_biquad_df1_t;
+
+/*!
+    \brief      Transposed Direct-Form-II biquad
+    \details    The two state variables keep the full precision of the products, which
+                keeps the noise of sections with poles near the unit circle low.
+*/
+typedef struct {
+    const fxp16_biquad_coeffs_t *coeffs;
+    fxp64_t s1, s2;
+} fxp16_biquad_df2t_t;
+
+void fxp16_biquad_df1_init(fxp16_biquad_df1_t *bq, const fxp16_biquad_coeffs_t *coeffs);
+fxp16_t fxp16_biquad_df1(fxp16_biquad_df1_t *bq, fxp16_t x);
+void fxp16_biquad_df1_block(fxp16_biquad_df1_t *bq, const fxp16_t *in, fxp16_t *out, size_t n);
+
+void fxp16_biquad_df2t_init(fxp16_biquad_df2t_t *bq, const fxp16_biquad_coeffs_t *coeffs);
+fxp16_t fxp16_biquad_df2t(fxp16_biquad_df2t_t *bq, fxp16_t x);
+void fxp16_biquad_df2t_block(fxp16_biquad_df2t_t *bq, const fxp16_t *in, fxp16_t *out, size_t n);
+
+/*! @} */
+
+
+/*!
+    \brief      Runs a filter as a protothread stage between two channels
+    \details    Waits until the input channel has a sample and the output channel has room,
+                then filters as many samples as possible in one go. Never returns.
+
+    \param      in      Input channel of fxp16_t samples
+    \param      out     Output channel of fxp16_t samples
+    \param      x       fxp16_t variable for the input sample, may be automatic
+    \param      y       fxp16_t variable for the output sample, may be automatic
+    \param      filter  Statement computing y from x, e.g. FXP16_FIR_STEP(fir, x, y) or
+                        y = fxp16_biquad_df1(&bq, x)
+*/
+#define PROCESS_FXP16_FILTER(in,out,x,y,filter)                                     \
+    while(1){                                                                       \
+        PT_WAIT_UNTIL(&PROCESS_PT(),                                                \
+                      channel_wait(&(in).reader, !CHANNEL_EMPTY(in)) &&             \
+                      channel_wait(&(out).writer, !CHANNEL_FULL(out)));             \
+        while (!CHANNEL_EMPTY(in) && !CHANNEL_FULL(out)){                           \
+            CHANNEL_READ(in, x);                                                    \
+            filter;                                                                 \
+            CHANNEL_WRITE(out, y);                                                  \
+        }                                                                           \
+    }
+
+#endif /* _FXP16_FILTER_H_ */
@@ -0,0 +1,124 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp32.c
+
+    \brief  Signed 32 bit fixed point companion of fxp16
+
+    \details
+*/
+
+#include "fxp32.h"
+#include <math.h>
+
+
+fxp32_t fxp32_mult(fxp32_t mult1, uint8_t frac1, fxp32_t mult2, uint8_t frac2)
+{
+    int64_t result = (int64_t)mult1*(int64_t)mult2;
+    fpxx_arshift_m(result,frac2);
+    fxp32_sat_m(result);
+    return (fxp32_t)result;
+}
+
+
+fxp32_t fxp32_div(fxp32_t divident, uint8_t frac1, fxp32_t divisor, uint8_t frac2)
+{
+    if (divisor == 0)
+    {
+        return (divident < 0) ? FXP32_SAT_MIN : FXP32_SAT_MAX;
+    }
+
+    int64_t result = ((int64_t)divident * ((int64_t)1 << frac2))/divisor;
+    fxp32_sat_m(result);
+    return (fxp32_t)result;
+}
+
+
+fxp32_t fxp32_fma(fxp32_t x, uint8_t xfrac, fxp32_t y, uint8_t yfrac, fxp32_t z, uint8_t zfrac)
+{
+    int64_t result = (int64_t)x*(int64_t)y;
+    int8_t relshift = xfrac+yfrac-zfrac;
+
+    fpxx_ashift_m(result,relshift);
+    result += z;
+    fxp32_sat_m(result);
+    return (fxp32_t)result;
+}
+
+
+fxp32_t fxp32_flt2fp(float var, uint8_t frac)
+{
+    double result = round((double)var * ((int64_t)1 << frac));
+    fxp32_sat_m(result);
+    return (fxp32_t)result;
+}
+
+
+float fxp32_fp2flt(fxp32_t var, uint8_t frac)
+{
+    return (float)((double)var / ((int64_t)1 << frac));
+}
+
+
+fxp32_t fxp16_to_fxp32(fxp16_t x, uint8_t xfrac, uint8_t frac)
+{
+    int64_t result = x;
+    fpxx_ashift_m(result, xfrac - frac);
+    fxp32_sat_m(result);
+    return (fxp32_t)result;
+}
+
+
+fxp16_t fxp32_to_fxp16(fxp32_t x, uint8_t xfrac, uint8_t frac)
+{
+    int64_t result = x;
+    fpxx_ashift_m(result, xfrac - frac);
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+
+fxp64_t fxp32_acc_add(fxp64_t acc, const fxp32_t *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        acc += x[i];
+    }
+    return acc;
+}
+
+
+fxp64_t fxp32_acc_mac(fxp64_t acc, const fxp32_t *a, const fxp32_t *b, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        acc += (fxp64_t)a[i]*(fxp64_t)b[i];
+    }
+    return acc;
+}
@@ -0,0 +1,366 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*!
+    \file   fxp32.h
+
+    \brief  Signed 32 bit fixed point companion of fxp16
+
+    \details fxp32_t numbers (e.g. Q16.16, Q1.31 or Q17.15) keep the precision that long
+             accumulations of fxp16_t numbers need. Products use 64 bit intermediates, and
+             block accumulations sum up in fxp64_t, a 64 bit accumulator, so a FIR sum or
+             an integrator is only rounded and saturated once at the end.
+
+             Like fxp16, all functions take the number of fractional bits as argument and
+             saturate their results to the limits of the result type.
+*/
+
+#ifndef _FXP32_H_
+#define _FXP32_H_
+
+#include "fxp16.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*!
+    \brief      64 bit accumulator type
+*/
+typedef int64_t fxp64_t;
+
+#define FXP32_Q15         (15)
+#define FXP32_Q16         (16)
+#define FXP32_Q31         (31)
+#define FXP32_SAT_MAX     (INT32_MAX)
+#define FXP32_SAT_MIN     (INT32_MIN)
+
+#define FXP32_Q16_ONE           (65536)         // 1.0
+#define FXP32_Q31_ALMOST_ONE    (INT32_MAX)     // 1.0 - 2^-31
+
+/*!
+    \brief      Saturating arithmetic left shift
+    \details    Shifts the 32-bit value \p v left by \p n bits and saturates the result
+                to the range [FXP32_SAT_MIN, FXP32_SAT_MAX].
+                If \p n <= 0, \p v is returned unchanged.
+                If \p n >= 31, the result is immediately saturated depending on the sign of \p v.
+
+    \param[in]  v    32-bit input value (e.g. fixed-point number).
+    \param[in]  n    Number of bits to shift (n ≥ 0).
+
+    \returns    v << n with saturation, equivalent to saturating v · 2ⁿ.
+*/
+static inline fxp32_t fxp32_sat_shl(fxp32_t v, int n) {
+    if (n <= 0) return v;
+    if (n >= 31) return (v >= 0) ? FXP32_SAT_MAX : FXP32_SAT_MIN;
+    int64_t w = (int64_t)v << n;
+    if (w > FXP32_SAT_MAX) return FXP32_SAT_MAX;
+    if (w < FXP32_SAT_MIN) return FXP32_SAT_MIN;
+    return (fxp32_t)w;
+}
+
+/*!
+    \brief      Arithmetic right shift with rounding toward +∞ for non-negative values
+    \details    Shifts the 32-bit integer \p v right by \p n bits arithmetically.
+                For \p v >= 0, adds 2^(n-1) before shifting to round toward +∞.
+                For \p v < 0, performs a plain arithmetic shift (no +0.5 rounding).
+                If \p n <= 0, returns \p v unchanged. If \p n >= 31, the result is
+                0 for non-negative \p v, or -1 for negative \p v (all bits shifted out).
+                Useful for fixed-point scaling equivalent to division by 2^n.
+
+    \param[in]  v    32-bit signed input value (e.g., fixed-point).
+    \param[in]  n    Number of bits to shift right (n ≥ 0).
+
+    \returns    \p v >> n with arithmetic semantics; for \p v >= 0 the result is
+                rounded toward +∞, otherwise no rounding is applied.
+*/
+static inline fxp32_t fxp32_shr_r(fxp32_t v, int n) {
+    if (n <= 0) return v;
+    if (n >= 31) return (v >= 0) ? 0 : -1; /* alles weg */
+    if (v >= 0) return (v + (1 << (n - 1))) >> n;
+    else        return (v >> n); /* negatives: arithmetisch, kein +0.5 Rundung */
+}
+
+/*!
+    \brief      Q15 multiply with 64-bit intermediate and rounding
+    \details    Multiplies two signed Q15 fixed-point values \p a and \p b using a 64-bit
+                intermediate (Q30), adds 2^(Q15-1) for rounding, then shifts right by Q15.
+                The final result is saturated to [FXP32_SAT_MIN, FXP32_SAT_MAX].
+
+    \param[in]  a    32-bit signed Q15 operand.
+    \param[in]  b    32-bit signed Q15 operand.
+
+    \returns    Q15 product of \p a and \p b, rounded (via bias + shift) and saturated.
+*/
+static inline fxp32_t fxp32_mul_q15(fxp32_t a, fxp32_t b) {
+    int64_t t = (int64_t)a * (int64_t)b;          // Q30
+    t += (int64_t)1 << (FXP32_Q15 - 1);                 // rundung
+    t >>= FXP32_Q15;
+    if (t > FXP32_SAT_MAX) return FXP32_SAT_MAX;
+    if (t < FXP32_SAT_MIN) return FXP32_SAT_MIN;
+    return (fxp32_t)t;
+}
+
+/*!
+    \brief      Q15 scaling by power of two
+    \details    Scales \p v by 2^n in Q15 format:
+                for \p n >= 0 uses saturating left shift (fxp32_sat_shl),
+                for \p n < 0 uses arithmetic right shift with rounding (fxp32_shr_r).
+
+    \param[in]  v    32-bit signed Q15 value to scale.
+    \param[in]  n    Power-of-two exponent; n >= 0 ⇒ left shift, n < 0 ⇒ right shift.
+
+    \returns    \p v · 2^n in Q15, with saturation for left shifts and rounding on right shifts.
+*/
+static inline fxp32_t fxp32_scale_pow2_q15(fxp32_t v, int n) {
+    if (n >= 0) return fxp32_sat_shl(v, n);
+    else        return fxp32_shr_r(v, -n);
+}
+
+
+/*!
+    \brief      Saturating 32-bit addition without 64-bit intermediate
+    \details    Adds \p a and \p b using 32-bit arithmetic and clamps the result to
+                [FXP32_SAT_MIN, FXP32_SAT_MAX] on overflow or underflow. No int64 is used.
+
+    \param[in]  a    32-bit signed addend.
+    \param[in]  b    32-bit signed addend.
+
+    \returns    a + b if representable; otherwise FXP32_SAT_MAX or FXP32_SAT_MIN.
+*/
+static inline fxp32_t fxp32_add_sat32(fxp32_t a, fxp32_t b) {
+    if (b > 0 && a > FXP32_SAT_MAX - b) return FXP32_SAT_MAX;
+    if (b < 0 && a < FXP32_SAT_MIN - b) return FXP32_SAT_MIN;
+    return a + b;
+}
+
+/*!
+    \brief      Q15 division with rounding and saturation to (-1, 1)
+    \details    Computes (num / den) in Q15. Uses a 64-bit intermediate:
+                (num << Q15) / den, with sign-aware ±0.5 bias for rounding to nearest.
+                den == 0 returns the maximum magnitude less than 1 with the sign of num.
+                Result is saturated to (-1, 1) in Q15 (i.e., ±(1 − 1/2^15)).
+
+    \param[in]  num   Q15 numerator (signed 32-bit).
+    \param[in]  den   Q15 denominator (signed 32-bit).
+
+    \returns    Rounded Q15 quotient in (-1, 1), saturated on overflow or den == 0.
+*/
+static inline fxp32_t fxp32_div_q15(fxp32_t num, fxp32_t den) {
+    if (den == 0) return (num >= 0) ? (FXP32_Q15_ONE - 1) : -(FXP32_Q15_ONE - 1);
+
+    /* Runden zum nächsten: Vorzeichen von Zähler/Nenner beachten */
+    int64_t n = (int64_t)num << FXP32_Q15;      // Q15-Nenner-Ziel
+    if (( (num ^ den) & 0x80000000 ) == 0) {
+        // gleiches Vorzeichen -> +0.5 zum Runden
+        n += (den >= 0 ? (den >> 1) : -((-(int64_t)den) >> 1));
+    } else {
+        // unterschiedliches Vorzeichen -> -0.5 zum Runden
+        n -= (den >= 0 ? (den >> 1) : -((-(int64_t)den) >> 1));
+    }
+
+    int64_t q = n / den;
+
+    /* Begrenzen in (-1,1) auf Q15: tanh erreicht nie exakt ±1 */
+    if (q >= (int64_t)FXP32_Q15_ONE)     q = FXP32_Q15_ONE - 1;
+    if (q <= -(int64_t)FXP32_Q15_ONE)    q = -(FXP32_Q15_ONE - 1);
+    return (fxp32_t)q;
+}
+
+
+/*!
+    \brief      Saturating 32-bit subtraction without 64-bit intermediate
+    \details    Subtracts \p b from \p a and clamps the result to [FXP32_SAT_MIN, FXP32_SAT_MAX].
+
+    \returns    a - b if representable; otherwise FXP32_SAT_MAX or FXP32_SAT_MIN.
+*/
+static inline fxp32_t fxp32_sub_sat32(fxp32_t a, fxp32_t b) {
+    if (b < 0 && a > FXP32_SAT_MAX + b) return FXP32_SAT_MAX;
+    if (b > 0 && a < FXP32_SAT_MIN + b) return FXP32_SAT_MIN;
+    return a - b;
+}
+
+/*!
+    \brief      Q16.16 multiply with 64-bit intermediate and rounding
+    \details    Same as fxp32_mul_q15(), for Q16.16 operands.
+*/
+static inline fxp32_t fxp32_mul_q16(fxp32_t a, fxp32_t b) {
+    int64_t t = (int64_t)a * (int64_t)b;          // Q32
+    t += (int64_t)1 << (FXP32_Q16 - 1);
+    t >>= FXP32_Q16;
+    fxp32_sat_m(t);
+    return (fxp32_t)t;
+}
+
+/*!
+    \brief      Q1.31 multiply with 64-bit intermediate and rounding
+    \details    Same as fxp32_mul_q15(), for Q1.31 operands. (-1.0)*(-1.0) saturates
+                to FXP32_Q31_ALMOST_ONE.
+*/
+static inline fxp32_t fxp32_mul_q31(fxp32_t a, fxp32_t b) {
+    int64_t t = (int64_t)a * (int64_t)b;          // Q62
+    t += (int64_t)1 << (FXP32_Q31 - 1);
+    t >>= FXP32_Q31;
+    fxp32_sat_m(t);
+    return (fxp32_t)t;
+}
+
+
+/* Basic math operations */
+
+/*!
+    \brief      Adds two fixed point numbers of the same format, saturated
+*/
+#define fxp32_add(summand1,summand2)    fxp32_add_sat32(summand1,summand2)
+
+/*!
+    \brief      Subtracts two fixed point numbers of the same format, saturated
+*/
+#define fxp32_sub(minuend,subtrahend)   fxp32_sub_sat32(minuend,subtrahend)
+
+/*!
+    \brief      Multiplies two fixed point numbers
+    \details    The product is computed in 64 bits and rounded like fxp16_mult(). The result
+                is in the format of the multiplicator and saturated.
+*/
+fxp32_t fxp32_mult(fxp32_t mult1, uint8_t frac1, fxp32_t mult2, uint8_t frac2);
+
+/*!
+    \brief      Divides two fixed point numbers
+    \details    result = divident/divisor in the format of the divident, saturated. A division
+                by zero saturates with the sign of the divident.
+*/
+fxp32_t fxp32_div(fxp32_t divident, uint8_t frac1, fxp32_t divisor, uint8_t frac2);
+
+/*!
+    \brief      Fused multiply-add x*y+z
+    \details    Like fxp16_fma(), the product is shifted to the format of z before the addition
+                and the sum is saturated. Only one rounding occurs.
+*/
+fxp32_t fxp32_fma(fxp32_t x, uint8_t xfrac, fxp32_t y, uint8_t yfrac, fxp32_t z, uint8_t zfrac);
+
+/*!
+    \brief      Natural, binary or decimal logarithm in Q15
+    \details    Returns log2(x)*logscale for x > 0 in Q15, both x and logscale being Q15.
+                For x <= 0 errno is set to EDOM and INT32_MIN returned.
+*/
+fxp32_t fxp32_logN_q15(fxp32_t x, fxp32_t logscale);
+
+
+/* Conversions */
+
+fxp32_t fxp32_flt2fp(float var, uint8_t frac);
+float fxp32_fp2flt(fxp32_t var, uint8_t frac);
+
+/*!
+    \brief      Converts a fxp16 number into a fxp32 number
+    \param      x       Number to convert
+    \param      xfrac   Number of fractional bits of x
+    \param      frac    Number of fractional bits of the result
+    \returns    x with frac fractional bits, saturated
+*/
+fxp32_t fxp16_to_fxp32(fxp16_t x, uint8_t xfrac, uint8_t frac);
+
+/*!
+    \brief      Converts a fxp32 number into a fxp16 number
+    \details    Rounds like fxp16_arshift() if bits are dropped.
+    \param      x       Number to convert
+    \param      xfrac   Number of fractional bits of x
+    \param      frac    Number of fractional bits of the result
+    \returns    x with frac fractional bits, saturated
+*/
+fxp16_t fxp32_to_fxp16(fxp32_t x, uint8_t xfrac, uint8_t frac);
+
+
+/*!
+    \defgroup   fxp32_accumulate Block accumulation
+    \brief      Sums and sums of products of whole arrays in a 64 bit accumulator.
+    \details    The accumulator holds the exact sum, i.e. the fractional bits of a sum are
+                the ones of the array and those of a sum of products the sum of the
+                fractional bits of both arrays. The accumulation functions take the
+                accumulator of the previous block and return the new one, so a long sum
+                can be split into blocks. fxp64_to_fxp32() and fxp64_to_fxp16() round and
+                saturate the final sum once.
+
+                The fxp16 variants sum up to 2^33 products of two Q15 numbers without
+                overflow, the fxp32 ones 2 products of two Q31 numbers or 2^31 of two Q16
+                numbers below 1.0. On Cortex-M4/M7 fxp16_acc_mac() uses SMLALD.
+
+    Usage Example:
+    \code
+        fxp64_t acc = 0;
+
+        while (block_next(&x, &n)) {
+            acc = fxp16_acc_mac(acc, x, coeff, n);
+        }
+        y = fxp64_to_fxp16(acc, 15);    // Q15*Q15 = Q30 -> Q15
+    \endcode
+
+@{
+*/
+
+fxp64_t fxp16_acc_add(fxp64_t acc, const fxp16_t *x, size_t n);
+fxp64_t fxp16_acc_mac(fxp64_t acc, const fxp16_t *a, const fxp16_t *b, size_t n);
+fxp64_t fxp32_acc_add(fxp64_t acc, const fxp32_t *x, size_t n);
+fxp64_t fxp32_acc_mac(fxp64_t acc, const fxp32_t *a, const fxp32_t *b, size_t n);
+
+/*!
+    \brief      Adds the product of two numbers to an accumulator
+*/
+static inline fxp64_t fxp32_mac(fxp64_t acc, fxp32_t a, fxp32_t b) {
+    return acc + (fxp64_t)a * (fxp64_t)b;
+}
+
+/*!
+    \brief      Shifts an accumulator right and saturates it to fxp32_t
+    \details    Rounds like fxp32_arshift().
+    \param      acc     Accumulator
+    \param      rshift  Number of fractional bits to drop
+*/
+static inline fxp32_t fxp64_to_fxp32(fxp64_t acc, uint8_t rshift) {
+    fpxx_arshift_m(acc, rshift);
+    fxp32_sat_m(acc);
+    return (fxp32_t)acc;
+}
+
+/*!
+    \brief      Shifts an accumulator right and saturates it to fxp16_t
+    \details    Rounds like fxp16_arshift().
+    \param      acc     Accumulator
+    \param      rshift  Number of fractional bits to drop
+*/
+static inline fxp16_t fxp64_to_fxp16(fxp64_t acc, uint8_t rshift) {
+    fpxx_arshift_m(acc, rshift);
+    fxp16_sat_m(acc);
+    return (fxp16_t)acc;
+}
+
+/*! @} */
+
+#endif /* _FXP32_H_ */
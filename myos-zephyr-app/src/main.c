@@ -9,6 +9,7 @@
 
 #include "myos.h"
 #include "mandelbrot.h"
+#include "sampler.h"
 
 LOG_MODULE_REGISTER(myos, LOG_LEVEL_INF);
 
@@ -27,8 +28,8 @@ void rtimer_callback(void* data)
 	if( cnt++ < 10 )
 	{
 		rtimer_t* rt = (rtimer_t*)data;	
+		// Re-arming keeps the rtimer lock, the join waits for the last callback.
 		rtimer_reset(rt);
-		rtimer_lock();
 	}
 
 	LOG_INF("Rtimer callback fired %d",cnt);
@@ -70,11 +71,11 @@ void myos_scheduler(void)
 	myos_init();
 
 	process_start(&counter,NULL);
+#if defined(CONFIG_SAMPLER)
+	process_start(&sampler,NULL);
+#endif
 
-	for(;;)
-	{
-		process_run();
-	}
+	myos_run_forever();
 }
  
 
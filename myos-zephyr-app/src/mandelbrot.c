@@ -1,101 +1,298 @@
 #include "mandelbrot.h"
 #include "fxp16.h"
+#include "fxp32.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_DECLARE(myos);
 
 #define XRES 80
 #define YRES 40
 #define MAGNIFY 1
 
-#define FP_0_7      0x00b3
-#define FP_0_5      0x0080
-#define FP_3_0      0x0300
 #define FP_2_0      0x0200
 #define FP_100_0    0x6400
 
+#define FP16_0_7    45875       // 0.7 in Q16
+
 #define FP_FRAC     8
-    
+
+#define TILES       CONFIG_MANDELBROT_TILES
+#define TILE_ROWS   ((YRES + TILES - 1) / TILES)
+
+BUILD_ASSERT((TILES - 1) * TILE_ROWS < YRES, "a tile would be empty");
+
+static const char cols[] = "`^\",:;Il!i~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
+
+#define ITERMAX     (sizeof(cols) - 2)
+
+/* Constants of the pixel columns and rows, computed once. */
+static fxp16_t cx_table[XRES];
+static fxp16_t cy_table[YRES];
+
+static char frame[YRES][XRES];
+
+#if defined(CONFIG_MYOS_UARTSINK)
+/* Posted by the uartsink process whenever a transfer has completed. */
+#define MANDELBROT_EVENT_TX     0x40
+#endif
+
+/*
+ * A tile is a band of rows. Its state lives here and not in static variables of the
+ * protothread, because all tile processes share the same thread function.
+ */
+typedef struct {
+    uint8_t first;
+    uint8_t rows;
+    uint8_t hx, hy;
+    uint32_t slices;
+    uint32_t busy;
+    bool done;
+#if defined(CONFIG_MANDELBROT_OFFLOAD)
+    offload_t job;
+#endif
+} tile_t;
+
+static tile_t tiles[TILES];
+
+
+/*
+ * cx = (hx/XRES - 0.5)/MAGNIFY*3.0 - 0.7, cy = (hy/YRES - 0.5)/MAGNIFY*3.0
+ *
+ * Both grow linearly, so they are accumulated in Q16 and only rounded to Q8 per entry.
+ */
+static void mandelbrot_tables_init(void)
+{
+    fxp32_t step, c;
+
+    step = fxp32_div(3 * FXP32_Q16_ONE, FXP32_Q16, XRES * MAGNIFY * FXP32_Q16_ONE, FXP32_Q16);
+    c = fxp32_sub(fxp32_div(-FXP32_Q16_ONE * 3 / 2, FXP32_Q16, MAGNIFY * FXP32_Q16_ONE, FXP32_Q16),
+                  FP16_0_7);
+    for (int hx = 0; hx < XRES; hx++, c += step)
+    {
+        cx_table[hx] = fxp32_to_fxp16(c, FXP32_Q16, FP_FRAC);
+    }
+
+    step = fxp32_div(3 * FXP32_Q16_ONE, FXP32_Q16, YRES * MAGNIFY * FXP32_Q16_ONE, FXP32_Q16);
+    c = fxp32_div(-FXP32_Q16_ONE * 3 / 2, FXP32_Q16, MAGNIFY * FXP32_Q16_ONE, FXP32_Q16);
+    for (int hy = 0; hy < YRES; hy++, c += step)
+    {
+        cy_table[hy] = fxp32_to_fxp16(c, FXP32_Q16, FP_FRAC);
+    }
+}
+
+/* Returns the number of iterations until the point escapes, at most ITERMAX. */
+static uint8_t mandelbrot_pixel(fxp16_t cx, fxp16_t cy)
+{
+    fxp16_t x = 0, y = 0, xx, yy, tmp;
+    uint8_t iteration;
+
+    for (iteration = 0; iteration < ITERMAX; iteration++)
+    {
+        // xx = x*x-y*y+cx;
+        xx = fxp16_mult_q8(x,x);
+        yy = fxp16_mult_q8(y,y);
+        tmp = fxp16_add_inline(fxp16_sub_inline(xx,yy),cx);
+
+        // y = 2.0*x*y+cy;
+        y = fxp16_mult_q8(x,y);
+        y = fxp16_mult_q8(FP_2_0,y);
+        y = fxp16_add_inline(y,cy);
+
+        x = tmp;
+
+        xx = fxp16_mult_q8(x,x);
+        yy = fxp16_mult_q8(y,y);
+        if (fxp16_add_inline(xx,yy) > FP_100_0)
+        {
+            break;
+        }
+    }
+    return iteration;
+}
+
+/* Renders the next pixel of a tile, returns false once the tile is complete. */
+static bool tile_render_pixel(tile_t *tile)
+{
+    uint32_t t0 = k_cycle_get_32();
+
+    frame[tile->hy][tile->hx] = cols[mandelbrot_pixel(cx_table[tile->hx], cy_table[tile->hy])];
+    tile->busy += k_cycle_get_32() - t0;
+
+    if (++tile->hx == XRES)
+    {
+        tile->hx = 0;
+        tile->hy++;
+    }
+    return tile->hy < tile->first + tile->rows;
+}
+
+static void tile_reset(tile_t *tile)
+{
+    tile->hx = 0;
+    tile->hy = tile->first;
+    tile->slices = 0;
+    tile->busy = 0;
+    tile->done = false;
+}
+
+static bool tiles_done(void)
+{
+    for (int i = 0; i < TILES; i++)
+    {
+#if defined(CONFIG_MANDELBROT_OFFLOAD)
+        if (!offload_done(&tiles[i].job))
+#else
+        if (!tiles[i].done)
+#endif
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+#if defined(CONFIG_MANDELBROT_OFFLOAD)
+
+/* Renders a whole tile unsliced in an offload worker thread. */
+static void tile_render(void *arg)
+{
+    tile_t *tile = arg;
+
+    while (tile_render_pixel(tile))
+    {
+    }
+    tile->slices = 1;
+}
+
+#else
+
+/* Renders a tile in slices of CONFIG_MANDELBROT_SLICE_PIXELS pixels. */
+PROCESS_THREAD(mandelbrot_tile)
+{
+    tile_t *tile = PROCESS_DATA();
+
+    PROCESS_BEGIN();
+
+    for (;;)
+    {
+        bool more = true;
+
+        for (int i = 0; more && i < CONFIG_MANDELBROT_SLICE_PIXELS; i++)
+        {
+            more = tile_render_pixel(tile);
+        }
+        tile->slices++;
+        if (!more)
+        {
+            break;
+        }
+        PROCESS_YIELD();
+    }
+
+    tile->done = true;
+    process_poll(&mandelbrot);
+
+    PROCESS_END();
+}
+
+#define MANDELBROT_TILE_PROCESS(i, _)   PROCESS(mandelbrot_tile_##i, mandelbrot_tile)
+#define MANDELBROT_TILE_PTR(i, _)       &mandelbrot_tile_##i
+
+LISTIFY(TILES, MANDELBROT_TILE_PROCESS, (;));
+
+static process_t *const tile_processes[TILES] = { LISTIFY(TILES, MANDELBROT_TILE_PTR, (,)) };
+
+#endif
+
+
+static void mandelbrot_report(uint32_t cycles)
+{
+    uint32_t slices = 0, busy = 0;
+    uint64_t us = k_cyc_to_us_floor64(cycles);
+
+    for (int i = 0; i < TILES; i++)
+    {
+        slices += tiles[i].slices;
+        busy += tiles[i].busy;
+    }
+
+    LOG_INF("mandelbrot: %d tiles, %d pixels in %u us, %u pixels/s",
+            TILES, XRES * YRES, (uint32_t)us,
+            us ? (uint32_t)((uint64_t)XRES * YRES * 1000000 / us) : 0);
+#if !defined(CONFIG_MANDELBROT_OFFLOAD)
+    /* Everything not spent on pixels went to the scheduler and the other processes. */
+    LOG_INF("mandelbrot: %u events, %u cycles scheduler overhead per event",
+            slices, cycles > busy ? (cycles - busy) / slices : 0);
+#endif
+}
+
+
 PROCESS(mandelbrot,mandelbrot);
 PROCESS_THREAD(mandelbrot)
 {
-    static fxp16_t   x,tmp1,tmp2,y,cx,cy;
-    static uint8_t  hx,hy,iteration;
-    static uint8_t itermax;                 /* how many iterations to do	*/
-    
-    const char *cols = "`^\",:;Il!i~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$";
-    
+    static uint32_t start;
+#if defined(CONFIG_MYOS_UARTSINK)
+    static int row;
+#endif
+
     PROCESS_BEGIN();
 
-    itermax = strlen(cols)-1;
+#if defined(CONFIG_MYOS_UARTSINK)
+    uartsink_notify(PROCESS_THIS(), MANDELBROT_EVENT_TX);
+#endif
+
+    mandelbrot_tables_init();
+    for (int i = 0; i < TILES; i++)
+    {
+        tiles[i].first = i * TILE_ROWS;
+        tiles[i].rows = MIN(TILE_ROWS, YRES - tiles[i].first);
+    }
 
     for(;;)
     {
-        for (hy=0; hy < YRES; hy++)  
+        start = k_cycle_get_32();
+
+        for (int i = 0; i < TILES; i++)
         {
-            for (hx=0; hx < XRES; hx++)  
-            {
-                //cx = (((float)hx)/((float)hxres)-0.5)/magnify*3.0-0.7;
-                tmp1 = fxp16_int2fp(hx,FP_FRAC);
-                tmp2 = fxp16_int2fp(XRES,FP_FRAC);
-                cx = fxp16_div(tmp1,FP_FRAC,tmp2,FP_FRAC);
-                cx = fxp16_sub(cx,FP_0_5);
-                tmp1 = fxp16_int2fp(MAGNIFY,FP_FRAC);
-                cx = fxp16_div(cx,FP_FRAC,tmp1,FP_FRAC);
-                cx = fxp16_mult(cx,FP_FRAC,FP_3_0,FP_FRAC);
-                cx = fxp16_sub(cx,FP_0_7);
-
-
-                
-                
-                //cy = (((float)hy)/((float)hyres)-0.5)/magnify*3.0;                  
-                tmp1 = fxp16_int2fp(hy,FP_FRAC);
-                tmp2 = fxp16_int2fp(YRES,FP_FRAC);
-                cy = fxp16_div(tmp1,FP_FRAC,tmp2,FP_FRAC);
-                cy = fxp16_sub(cy,FP_0_5);
-                tmp1 = fxp16_int2fp(MAGNIFY,FP_FRAC);
-                cy = fxp16_div(cy,FP_FRAC,tmp1,FP_FRAC);
-                cy = fxp16_mult(cy,FP_FRAC,FP_3_0,FP_FRAC);
-     
-                
-                x = y = 0;              
-
-                for (iteration = 0;iteration < itermax; iteration++)  
-                {      
-                    // xx = x*x-y*y+cx;
-                    tmp1 = fxp16_mult(x,FP_FRAC,x,FP_FRAC);
-                    tmp2 = fxp16_mult(y,FP_FRAC,y,FP_FRAC);
-                    tmp1 = fxp16_sub(tmp1,tmp2);                       
-                    tmp1 = fxp16_add(tmp1,cx);
-
-                    
-                    // y = 2.0*x*y+cy;
-                    y = fxp16_mult(x,FP_FRAC,y,FP_FRAC);
-                    y = fxp16_mult(FP_2_0,FP_FRAC,y,FP_FRAC);
-                    y = fxp16_add(y,cy);
-                    
-                    x = tmp1;
-
-                    
-                    tmp1 = fxp16_mult(x,FP_FRAC,x,FP_FRAC);
-                    tmp2 = fxp16_mult(y,FP_FRAC,y,FP_FRAC);
-                    
-                    
-                    
-                    if (fxp16_add(tmp1,tmp2) > FP_100_0)
-                    {
-                        break;    // check if this works with protothreads!              
-                    }
-                    
-                    PROCESS_YIELD();
-                    
-                }
-                
-                
-                putchar(cols[iteration]);                
-            }
+            tile_reset(&tiles[i]);
+#if defined(CONFIG_MANDELBROT_OFFLOAD)
+            offload_submit(&tiles[i].job, tile_render, &tiles[i]);
+#else
+            process_start(tile_processes[i], &tiles[i]);
+#endif
+        }
+
+        PROCESS_WAIT_EVENT_UNTIL(tiles_done());
 
+        mandelbrot_report(k_cycle_get_32() - start);
 
+#if defined(CONFIG_MYOS_UARTSINK)
+        /* The rows go out by DMA while the next frame is rendered. */
+        for (row = 0; row < YRES; row++)
+        {
+            if (uartsink_space() < XRES + 1)
+            {
+                PROCESS_WAIT_EVENT_UNTIL(uartsink_space() >= XRES + 1);
+            }
+            uartsink_write(frame[row], XRES);
+            uartsink_putc('\n');
+        }
+#else
+        for (int hy = 0; hy < YRES; hy++)
+        {
+            for (int hx = 0; hx < XRES; hx++)
+            {
+                putchar(frame[hy][hx]);
+            }
             putchar('\n');
         }
-    }   
-    
+#endif
+    }
+
     PROCESS_END();
-}
\ No newline at end of file
+}
@@ -0,0 +1,171 @@
+#include "sampler.h"
+#include "fxp16.h"
+#include "fxp16_filter.h"
+
+#include <zephyr/drivers/adc.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_DECLARE(myos);
+
+#define BLOCK           CONFIG_SAMPLER_BLOCK
+#define INTERVAL_US     (1000000 / CONFIG_SAMPLER_RATE_HZ)
+
+/* About one report per second. */
+#define REPORT_BLOCKS   MAX(1, CONFIG_SAMPLER_RATE_HZ / BLOCK)
+
+BUILD_ASSERT(INTERVAL_US > 0, "CONFIG_SAMPLER_RATE_HZ is above 1 MHz");
+
+static const struct adc_dt_spec adc = ADC_DT_SPEC_GET_BY_IDX(DT_PATH(zephyr_user), 0);
+
+/*
+ * Both halves are filled by one ADC sequence of 2 * BLOCK samplings. The raw samples are
+ * converted to fxp16 and filtered in place.
+ */
+static fxp16_t samples[2][BLOCK];
+
+/* Bit n is set from the posting of half n until the process has filtered it. */
+static atomic_t filled;
+static atomic_t overruns;
+
+static struct k_poll_signal done;
+
+/* 2nd order Butterworth low pass at 1/20 of the sample rate, Q14 */
+static const fxp16_biquad_coeffs_t lowpass_coeffs = {
+    .b0 = 329, .b1 = 658, .b2 = 329,
+    .a1 = -25576, .a2 = 10508,
+    .frac = FXP16_Q14,
+};
+
+static fxp16_biquad_df1_t lowpass;
+
+
+/* Runs in the ADC interrupt after every conversion. */
+static enum adc_action sampler_callback(const struct device *dev,
+                                        const struct adc_sequence *sequence,
+                                        uint16_t sampling_index)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(sequence);
+
+    if ((sampling_index + 1) % BLOCK == 0)
+    {
+        int half = sampling_index / BLOCK;
+        bool overrun = atomic_test_and_set_bit(&filled, half);
+
+        /* A half which is still being filtered has been overwritten. */
+        if (overrun)
+        {
+            atomic_inc(&overruns);
+        }
+
+        /*
+         * The event of the second half restarts the sequence, so it is posted in any case.
+         * At most one event per half is pending, the mailbox never fills up with them.
+         * process_post_isr() belongs to the rtimer interrupt, which may preempt this one.
+         */
+        if (!overrun || half)
+        {
+            process_post_remote(&sampler, SAMPLER_EVENT_BLOCK, samples[half]);
+        }
+    }
+
+    return ADC_ACTION_CONTINUE;
+}
+
+static const struct adc_sequence_options sampler_options = {
+    .interval_us = INTERVAL_US,
+    .callback = sampler_callback,
+    .extra_samplings = 2 * BLOCK - 1,
+};
+
+/* adc_sequence_init_dt() fills in the channel, the resolution and the oversampling. */
+static struct adc_sequence sequence = {
+    .options = &sampler_options,
+    .buffer = samples,
+    .buffer_size = sizeof(samples),
+};
+
+/* Starts filling both halves again, from the first one. */
+static bool sampler_start(void)
+{
+    int err;
+
+    k_poll_signal_reset(&done);
+    err = adc_read_async(adc.dev, &sequence, &done);
+    if (err)
+    {
+        LOG_ERR("sampler: adc_read_async failed (%d)", err);
+        return false;
+    }
+    return true;
+}
+
+
+PROCESS(sampler,sampler);
+PROCESS_THREAD(sampler)
+{
+    static uint32_t blocks;
+
+    PROCESS_BEGIN();
+
+    if (!adc_is_ready_dt(&adc) || adc_channel_setup_dt(&adc) || adc_sequence_init_dt(&adc, &sequence))
+    {
+        LOG_ERR("sampler: ADC channel not available");
+        PT_EXIT(&PROCESS_PT());
+    }
+
+    if (adc.resolution == 0 || adc.resolution > 16)
+    {
+        LOG_ERR("sampler: %u bit resolution not supported", adc.resolution);
+        PT_EXIT(&PROCESS_PT());
+    }
+
+    fxp16_biquad_df1_init(&lowpass, &lowpass_coeffs);
+    k_poll_signal_init(&done);
+
+    if (!sampler_start())
+    {
+        PT_EXIT(&PROCESS_PT());
+    }
+
+    LOG_INF("sampler: %d Hz, %d samples per block", CONFIG_SAMPLER_RATE_HZ, BLOCK);
+
+    for(;;)
+    {
+        PROCESS_WAIT_EVENT(SAMPLER_EVENT_BLOCK);
+
+        fxp16_t *block = PROCESS_EVENT_DATA();
+        int half = block == samples[1];
+
+        /*
+         * The sequence has completed with the second half. It is restarted before that
+         * half is filtered, the first half has been filtered already.
+         */
+        if (half)
+        {
+            sampler_start();
+        }
+
+        /* Unsigned raw samples to Q15, 0 to just below 1.0. A 16 bit ADC loses its LSB. */
+        int shift = 15 - adc.resolution;
+
+        for (int i = 0; i < BLOCK; i++)
+        {
+            uint16_t raw = (uint16_t)block[i];
+
+            block[i] = (fxp16_t)(shift >= 0 ? raw << shift : raw >> -shift);
+        }
+        fxp16_biquad_df1_block(&lowpass, block, block, BLOCK);
+
+        if (++blocks % REPORT_BLOCKS == 0)
+        {
+            LOG_INF("sampler: %u blocks, filtered %d, %d overruns",
+                    blocks, block[BLOCK - 1], (int)atomic_get(&overruns));
+        }
+
+        atomic_clear_bit(&filled, half);
+    }
+
+    PROCESS_END();
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2025 Marco Bacchi
+ */
+
+/*
+ * Block sampling of an ADC channel.
+ *
+ * The ADC driver times the conversions and writes them into the two halves of a
+ * double buffer. Each filled half is posted once, with SAMPLER_EVENT_BLOCK, to the
+ * sampler process, which filters it as a block with the fxp16 filters. The
+ * scheduler sees one event per CONFIG_SAMPLER_BLOCK samples instead of one per sample.
+ *
+ * The channel is the first entry of the io-channels of the zephyr,user node.
+ */
+
+#ifndef SAMPLER_H
+#define	SAMPLER_H
+
+#include "myos.h"
+
+/* Posted from the ADC interrupt, the event data is the filled half of the buffer. */
+#define SAMPLER_EVENT_BLOCK     0x41
+
+EXTERN_PROCESS(sampler);
+
+#endif	/* SAMPLER_H */
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2025 Marco Bacchi
+ */
+
+/*
+ * Cycle counts of the MyOS primitives.
+ *
+ * Every benchmark runs BENCH_ROUNDS rounds of n operations and prints the mean
+ * cost of one operation as a JSON object. The cost of reading the cycle counter
+ * is subtracted, the loop overhead is not.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+
+#include "myos.h"
+#include "itempool.h"
+#include "hash.h"
+#include "fxp16.h"
+
+#define BENCH_ROUNDS    16
+#define BENCH_EVENTS    64
+#define BENCH_POOL      32
+#define BENCH_FXP       256
+#define BENCH_HASH      64
+
+BUILD_ASSERT(BENCH_EVENTS <= CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE, "event queue too small for the benchmark");
+
+static timing_t bench_t0;
+static uint64_t bench_overhead;
+static uint64_t bench_total;
+
+static inline void bench_start(void)
+{
+	bench_t0 = timing_counter_get();
+}
+
+static inline void bench_stop(void)
+{
+	timing_t t1 = timing_counter_get();
+	uint64_t cycles = timing_cycles_get(&bench_t0, &t1);
+
+	bench_total += cycles > bench_overhead ? cycles - bench_overhead : 0;
+}
+
+static void bench_report(const char *name, uint32_t n, uint32_t ops)
+{
+	printk("{\"bench\":\"%s\",\"n\":%u,\"cycles\":%u}\n", name, n,
+	       (uint32_t)((bench_total + ops / 2) / ops));
+	bench_total = 0;
+}
+
+static void bench_calibrate(void)
+{
+	uint64_t min = UINT64_MAX;
+
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		bench_overhead = 0;
+		bench_total = 0;
+		bench_start();
+		bench_stop();
+		if (bench_total < min) {
+			min = bench_total;
+		}
+	}
+	bench_overhead = min;
+	bench_total = 0;
+}
+
+/* Drains the event queue without measuring. */
+static void bench_drain(void)
+{
+	while (process_run()) {
+	}
+}
+
+
+static uint32_t sink_count;
+
+PROCESS(sink, sink);
+PROCESS_THREAD(sink)
+{
+	PROCESS_BEGIN();
+
+	while (1) {
+		PROCESS_WAIT_ANY_EVENT();
+		sink_count++;
+	}
+
+	PROCESS_END();
+}
+
+static uint32_t pingpong_left;
+
+PROCESS_EXTERN(pong);
+
+PROCESS(ping, ping);
+PROCESS_THREAD(ping)
+{
+	PROCESS_BEGIN();
+
+	while (1) {
+		PROCESS_WAIT_EVENT(PROCESS_EVENT_CONTINUE);
+		if (pingpong_left) {
+			pingpong_left--;
+			process_post(&pong, PROCESS_EVENT_CONTINUE, NULL);
+		}
+	}
+
+	PROCESS_END();
+}
+
+PROCESS(pong, pong);
+PROCESS_THREAD(pong)
+{
+	PROCESS_BEGIN();
+
+	while (1) {
+		PROCESS_WAIT_EVENT(PROCESS_EVENT_CONTINUE);
+		process_post(&ping, PROCESS_EVENT_CONTINUE, NULL);
+	}
+
+	PROCESS_END();
+}
+
+
+static void bench_process(void)
+{
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		bench_start();
+		for (int i = 0; i < BENCH_EVENTS; i++) {
+			process_post(&sink, PROCESS_EVENT_CONTINUE, NULL);
+		}
+		bench_stop();
+		bench_drain();
+	}
+	bench_report("process_post", BENCH_EVENTS, BENCH_ROUNDS * BENCH_EVENTS);
+
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_EVENTS; i++) {
+			process_post(&sink, PROCESS_EVENT_CONTINUE, NULL);
+		}
+		bench_start();
+		for (int i = 0; i < BENCH_EVENTS; i++) {
+			process_run();
+		}
+		bench_stop();
+		bench_drain();
+	}
+	bench_report("process_run", BENCH_EVENTS, BENCH_ROUNDS * BENCH_EVENTS);
+
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		bench_start();
+		for (int i = 0; i < BENCH_EVENTS; i++) {
+			process_post_sync(&sink, PROCESS_EVENT_CONTINUE, NULL);
+		}
+		bench_stop();
+	}
+	bench_report("process_post_sync", BENCH_EVENTS, BENCH_ROUNDS * BENCH_EVENTS);
+
+	/* Every round trip switches twice between the two protothreads. */
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		pingpong_left = BENCH_EVENTS;
+		process_post(&ping, PROCESS_EVENT_CONTINUE, NULL);
+		bench_start();
+		bench_drain();
+		bench_stop();
+	}
+	bench_report("context_switch", BENCH_EVENTS, BENCH_ROUNDS * (2 * BENCH_EVENTS + 1));
+}
+
+
+static ptimer_t bench_ptimers[128];
+static uint32_t bench_ptimer_fired;
+
+static void bench_ptimer_handler(ptimer_t *ptimer)
+{
+	ARG_UNUSED(ptimer);
+	bench_ptimer_fired++;
+}
+
+static void bench_ptimer(uint32_t n)
+{
+	uint32_t lcg = 12345;
+	uint32_t measured = 0;
+
+	/* Insert n timers with pseudo-random deadlines far in the future. */
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		bench_start();
+		for (uint32_t i = 0; i < n; i++) {
+			lcg = lcg * 1103515245 + 12345;
+			ptimer_start(&bench_ptimers[i], 1000 + (lcg >> 16) % 10000, bench_ptimer_handler);
+		}
+		bench_stop();
+		for (uint32_t i = 0; i < n; i++) {
+			ptimer_stop(&bench_ptimers[i]);
+		}
+	}
+	bench_report("ptimer_start", n, BENCH_ROUNDS * n);
+
+	/* Expire n timers, which are all due, in one run of the ptimer process. */
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		bench_ptimer_fired = 0;
+		for (uint32_t i = 0; i < n; i++) {
+			ptimer_start(&bench_ptimers[i], 0, bench_ptimer_handler);
+		}
+		/* The tick may already have expired some of them. */
+		bench_drain();
+		uint32_t before = bench_ptimer_fired;
+
+		bench_start();
+		process_poll(&ptimer_process);
+		bench_drain();
+		bench_stop();
+		measured += bench_ptimer_fired - before;
+
+		while (bench_ptimer_fired < n) {
+			process_poll(&ptimer_process);
+			bench_drain();
+		}
+	}
+	bench_report("ptimer_expire", n, measured ? measured : 1);
+}
+
+
+typedef struct {
+	uint32_t payload[4];
+} bench_item_t;
+
+ITEMPOOL_TYPEDEF(bench_pool_scan, bench_item_t, BENCH_POOL);
+ITEMPOOL_TYPEDEF_FREELIST(bench_pool_freelist, bench_item_t, BENCH_POOL);
+ITEMPOOL_TYPEDEF_BITMAP(bench_pool_bitmap, bench_item_t, BENCH_POOL);
+
+static ITEMPOOL_T(bench_pool_scan) bench_pool_scan;
+static ITEMPOOL_T(bench_pool_freelist) bench_pool_freelist;
+static ITEMPOOL_T(bench_pool_bitmap) bench_pool_bitmap;
+
+static bench_item_t *bench_items[BENCH_POOL];
+
+#define BENCH_ITEMPOOL(pool, allocname, freename) \
+	do { \
+		ITEMPOOL_INIT(pool); \
+		for (int r = 0; r < BENCH_ROUNDS; r++) { \
+			bench_start(); \
+			for (int i = 0; i < BENCH_POOL; i++) { \
+				bench_items[i] = ITEMPOOL_ALLOC(pool); \
+			} \
+			bench_stop(); \
+			for (int i = 0; i < BENCH_POOL; i++) { \
+				ITEMPOOL_FREE(pool, bench_items[i]); \
+			} \
+		} \
+		bench_report(allocname, BENCH_POOL, BENCH_ROUNDS * BENCH_POOL); \
+		for (int r = 0; r < BENCH_ROUNDS; r++) { \
+			for (int i = 0; i < BENCH_POOL; i++) { \
+				bench_items[i] = ITEMPOOL_ALLOC(pool); \
+			} \
+			bench_start(); \
+			for (int i = 0; i < BENCH_POOL; i++) { \
+				ITEMPOOL_FREE(pool, bench_items[i]); \
+			} \
+			bench_stop(); \
+		} \
+		bench_report(freename, BENCH_POOL, BENCH_ROUNDS * BENCH_POOL); \
+	} while (0)
+
+static void bench_itempool(void)
+{
+	BENCH_ITEMPOOL(bench_pool_scan, "itempool_alloc_scan", "itempool_free_scan");
+	BENCH_ITEMPOOL(bench_pool_freelist, "itempool_alloc_freelist", "itempool_free_freelist");
+	BENCH_ITEMPOOL(bench_pool_bitmap, "itempool_alloc_bitmap", "itempool_free_bitmap");
+}
+
+
+/* Keeps the compiler from dropping the results. */
+static volatile fxp16_t bench_sink_fxp;
+
+#define BENCH_FXP16(name, expr) \
+	do { \
+		for (int r = 0; r < BENCH_ROUNDS; r++) { \
+			fxp16_t acc = 0; \
+			bench_start(); \
+			for (int i = 0; i < BENCH_FXP; i++) { \
+				fxp16_t x = (fxp16_t)(i * 97 + 1); \
+				acc ^= (expr); \
+			} \
+			bench_stop(); \
+			bench_sink_fxp = acc; \
+		} \
+		bench_report(name, BENCH_FXP, BENCH_ROUNDS * BENCH_FXP); \
+	} while (0)
+
+static fxp16_t bench_fxp_a[BENCH_FXP];
+static fxp16_t bench_fxp_b[BENCH_FXP];
+static fxp16_t bench_fxp_dst[BENCH_FXP];
+
+/* Reports the cost per element of an operation on whole arrays. */
+#define BENCH_FXP16V(name, stmt) \
+	do { \
+		for (int r = 0; r < BENCH_ROUNDS; r++) { \
+			bench_start(); \
+			stmt; \
+			bench_stop(); \
+			bench_sink_fxp = bench_fxp_dst[r]; \
+		} \
+		bench_report(name, BENCH_FXP, BENCH_ROUNDS * BENCH_FXP); \
+	} while (0)
+
+static void bench_fxp16(void)
+{
+	for (int i = 0; i < BENCH_FXP; i++) {
+		bench_fxp_a[i] = (fxp16_t)(i * 97 + 1);
+		bench_fxp_b[i] = (fxp16_t)(0x0180 - i);
+	}
+
+	BENCH_FXP16("fxp16_add", fxp16_add(x, 0x0123));
+	BENCH_FXP16("fxp16_mult", fxp16_mult(x, 8, 0x0180, 8));
+	BENCH_FXP16("fxp16_mult_q8", fxp16_mult_q8(x, 0x0180));
+	BENCH_FXP16("fxp16_div", fxp16_div(x, 8, 0x0180, 8));
+	BENCH_FXP16("fxp16_sqrt", fxp16_sqrt(x & 0x7fff, 8));
+	BENCH_FXP16("fxp16_sin", fxp16_sin(x));
+
+	BENCH_FXP16V("fxp16_vadd_sat", fxp16_vadd_sat(bench_fxp_dst, bench_fxp_a, bench_fxp_b, BENCH_FXP));
+	BENCH_FXP16V("fxp16_vmul_sat", fxp16_vmul_sat(bench_fxp_dst, bench_fxp_a, bench_fxp_b, BENCH_FXP, 8));
+	BENCH_FXP16V("fxp16_vdot_sat", bench_fxp_dst[r] = fxp16_vdot_sat(bench_fxp_a, bench_fxp_b, BENCH_FXP, 8));
+}
+
+
+static volatile uint32_t bench_sink_hash;
+static uint8_t bench_hash_key[BENCH_HASH];
+
+/* Reports the cost of hashing a key of n bytes. */
+#define BENCH_HASH_FN(name, n, expr) \
+	do { \
+		for (int r = 0; r < BENCH_ROUNDS; r++) { \
+			bench_start(); \
+			bench_sink_hash = (expr); \
+			bench_stop(); \
+		} \
+		bench_report(name, n, BENCH_ROUNDS); \
+	} while (0)
+
+static void bench_hash_size(size_t n)
+{
+	BENCH_HASH_FN("hash_sdbm", n, hash_sdbm(0, bench_hash_key, n));
+	BENCH_HASH_FN("hash_fnv1a", n, hash_fnv1a(HASH_FNV1A_SEED, bench_hash_key, n));
+	BENCH_HASH_FN("hash_murmur3", n, hash_murmur3(0, bench_hash_key, n));
+	BENCH_HASH_FN("hash_crc32", n, hash_crc32(HASH_CRC32_SEED, bench_hash_key, n));
+}
+
+static void bench_hash(void)
+{
+	for (int i = 0; i < BENCH_HASH; i++) {
+		bench_hash_key[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	bench_hash_size(4);
+	bench_hash_size(16);
+	bench_hash_size(BENCH_HASH);
+}
+
+
+int main(void)
+{
+	timing_init();
+	timing_start();
+
+	myos_init();
+	process_start(&sink, NULL);
+	process_start(&ping, NULL);
+	process_start(&pong, NULL);
+	bench_drain();
+
+	bench_calibrate();
+
+	printk("MYOS-BENCH-BEGIN {\"board\":\"%s\",\"cycles_per_sec\":%u}\n", CONFIG_BOARD,
+	       (uint32_t)timing_freq_get());
+
+	bench_process();
+	bench_ptimer(8);
+	bench_ptimer(32);
+	bench_ptimer(128);
+	bench_itempool();
+	bench_fxp16();
+	bench_hash();
+
+	printk("MYOS-BENCH-END\n");
+
+	timing_stop();
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+#
+# Decodes a MyOS binary event trace (CONFIG_MYOS_TRACE).
+#
+# The input is either a raw copy of the trace_buffer symbol, e.g. from GDB:
+#
+#     (gdb) dump binary value trace.bin trace_buffer
+#     $ myos_trace.py trace.bin --elf build/zephyr/zephyr.elf
+#
+# or a console log containing the hex dump printed by trace_dump():
+#
+#     $ myos_trace.py console.log --elf build/zephyr/zephyr.elf
+
+import argparse
+import bisect
+import re
+import struct
+import subprocess
+import sys
+
+HEADER = struct.Struct('<4sBBBBIII')
+RECORD = struct.Struct('<IBBHII')
+
+TYPES = {
+    1: 'post',
+    2: 'post_isr',
+    3: 'post_remote',
+    4: 'deliver',
+    5: 'done',
+    6: 'ptimer',
+    7: 'rtimer',
+    8: 'post_edf',
+    9: 'filtered',
+    10: 'suspended',
+}
+
+PT_STATES = {1: 'waiting', 0xff: 'terminated'}
+
+
+def load(path):
+    data = open(path, 'rb').read()
+    if data[:4] == b'MYTR':
+        return data
+    text = data.decode('ascii', 'replace')
+    match = re.search(r'MYOS-TRACE-BEGIN\s*\n(.*?)MYOS-TRACE-END', text, re.S)
+    if not match:
+        sys.exit(f'{path}: neither a raw trace buffer nor a trace_dump() log')
+    # Strip anything a logger may have prefixed to the lines.
+    hexdigits = ''.join(re.findall(r'([0-9a-fA-F]+)\s*$', match.group(1), re.M))
+    return bytes.fromhex(hexdigits)
+
+
+class Symbols:
+    def __init__(self, elf, nm):
+        self.addrs, self.names = [], []
+        if not elf:
+            return
+        out = subprocess.run([nm, '-S', '--defined-only', elf],
+                             capture_output=True, text=True, check=True).stdout
+        syms = []
+        for line in out.splitlines():
+            parts = line.split()
+            if len(parts) == 4:
+                syms.append((int(parts[0], 16), int(parts[1], 16), parts[3]))
+        for addr, size, name in sorted(syms):
+            self.addrs.append(addr)
+            self.names.append((addr, size, name))
+
+    def name(self, value):
+        if value == 0:
+            return '-'
+        i = bisect.bisect_right(self.addrs, value & ~1) - 1
+        if i >= 0:
+            addr, size, name = self.names[i]
+            offset = (value & ~1) - addr
+            if offset < max(size, 1):
+                return name if offset == 0 else f'{name}+{offset}'
+        return f'0x{value:08x}'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('trace', help='raw trace_buffer copy or console log')
+    parser.add_argument('--elf', help='ELF file to name processes, timers and callbacks')
+    parser.add_argument('--nm', default='arm-zephyr-eabi-nm', help='nm of the toolchain')
+    args = parser.parse_args()
+
+    data = load(args.trace)
+    magic, version, record_size, ts_bits, _, ticks, size, count = HEADER.unpack_from(data)
+    if magic != b'MYTR' or version != 1 or record_size != RECORD.size:
+        sys.exit('unsupported trace buffer layout')
+
+    syms = Symbols(args.elf, args.nm)
+
+    # Oldest record first, the ring only holds the last `size` records.
+    first = max(0, count - size)
+    if first:
+        print(f'# {first} older records were overwritten')
+
+    mask = (1 << ts_bits) - 1
+    last = None
+    time = 0
+    for n in range(first, count):
+        offset = HEADER.size + (n % size) * RECORD.size
+        ts, rtype, evtid, arg, a, b = RECORD.unpack_from(data, offset)
+        # Unwrap the timestamps, records are written in time order.
+        if last is not None:
+            time += (ts - last) & mask
+        last = ts
+
+        name = TYPES.get(rtype, f'user{rtype - 0x80}' if rtype >= 0x80 else f'type{rtype}')
+        if rtype == 1:
+            detail = f'evt={evtid} prio={arg} {syms.name(a)} -> {syms.name(b)}'
+        elif rtype == 8:
+            detail = f'evt={evtid} deadline={arg} {syms.name(a)} -> {syms.name(b)}'
+        elif rtype in (2, 3, 4, 5):
+            detail = f'evt={evtid} {syms.name(a)} -> {syms.name(b)}'
+            if rtype == 5:
+                detail += f' {PT_STATES.get(arg, arg)}'
+        elif rtype in (6, 7):
+            detail = f'{syms.name(a)} {syms.name(b)}'
+        else:
+            detail = f'id={evtid} arg={arg} {syms.name(a)} {syms.name(b)}'
+
+        print(f'{time * 1e6 / ticks:14.1f} us  {name:<12} {detail}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,337 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "counter_arch.h"
+#include "critical.h"
+#include "debug.h"
+#include "utils.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/counter.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_MYOS_DEBUG_TIMESTAMP)
+#define DBG(...) DBG_FUNC(__VA_ARGS__)
+#else
+#define DBG(...) do{}while(0)
+#endif
+
+BUILD_ASSERT(DT_HAS_CHOSEN(myos_counter), "MyOS needs a counter chosen as myos,counter in the devicetree");
+BUILD_ASSERT(CONFIG_MYOS_COUNTER_FREQUENCY % 1000 == 0, "the MyOS counter must tick a multiple of 1 kHz");
+
+static const struct device *const counter_arch_dev = DEVICE_DT_GET(DT_CHOSEN(myos_counter));
+
+static void counter_arch_isr(const struct device *dev, uint8_t chan_id, uint32_t ticks, void *user_data);
+
+/* A hardware channel and the alarms bound to it */
+typedef struct {
+   struct counter_alarm_cfg cfg;
+   counter_arch_alarm_t *alarms;
+   bool programmed;
+} counter_arch_channel_t;
+
+static counter_arch_channel_t counter_arch_channels[CONFIG_MYOS_COUNTER_CHANNELS];
+static uint8_t counter_arch_channel_count = 0;
+static uint8_t counter_arch_registered = 0;
+static uint32_t counter_arch_top_value = 0;
+static bool counter_arch_started = false;
+static bool counter_arch_no_guard = false;
+
+
+/* Counter ticks from a forward to b */
+static inline uint32_t counter_arch_span(uint32_t a, uint32_t b)
+{
+   return b >= a ? b - a : b + (counter_arch_top_value - a) + 1U;
+}
+
+/* Deadlines are at most half a period ahead, one further away has passed already */
+static inline bool counter_arch_due(const counter_arch_alarm_t *alarm, uint32_t now)
+{
+   uint32_t left = counter_arch_span(now, alarm->ticks);
+
+   return left == 0U || left > counter_arch_top_value / 2U;
+}
+
+/* Must be called inside a critical section. Programs the channel for its earliest armed alarm. */
+static void counter_arch_channel_program(uint8_t channel)
+{
+   counter_arch_channel_t *ch = &counter_arch_channels[channel];
+   counter_arch_alarm_t *next = NULL;
+   int err;
+
+   if (ch->alarms->next == NULL)
+   {
+      // Dedicated channel
+      if (ch->alarms->armed)
+      {
+         next = ch->alarms;
+      }
+   }
+   else
+   {
+      uint32_t now = counter_arch_now();
+      uint32_t best = UINT32_MAX;
+
+      for (counter_arch_alarm_t *alarm = ch->alarms; alarm != NULL; alarm = alarm->next)
+      {
+         if (alarm->armed)
+         {
+            uint32_t left = counter_arch_due(alarm, now) ? 0U : counter_arch_span(now, alarm->ticks);
+
+            if (left < best)
+            {
+               best = left;
+               next = alarm;
+            }
+         }
+      }
+   }
+
+   if (ch->programmed)
+   {
+      if (next != NULL && ch->cfg.ticks == next->ticks)
+      {
+         return;
+      }
+      counter_cancel_channel_alarm(counter_arch_dev, channel);
+      ch->programmed = false;
+   }
+
+   if (next == NULL)
+   {
+      return;
+   }
+
+   ch->cfg.ticks = next->ticks;
+
+   // Without a guard period a passed deadline would wait for a wrap-around, take the next tick
+   if (counter_arch_no_guard)
+   {
+      uint32_t now = counter_arch_now();
+
+      if (counter_arch_due(next, now))
+      {
+         ch->cfg.ticks = now == counter_arch_top_value ? 0U : now + 1U;
+      }
+   }
+
+   err = counter_set_channel_alarm(counter_arch_dev, channel, &ch->cfg);
+
+   // -ETIME: the deadline has passed already and the alarm expires immediately
+   if (err == 0 || err == -ETIME)
+   {
+      ch->programmed = true;
+   }
+   else
+   {
+      DBG("counter: set channel %u alarm failed %d!\n", channel, err);
+   }
+}
+
+
+static UTILS_HOT_FUNC void counter_arch_isr(const struct device *dev, uint8_t chan_id, uint32_t ticks, void *user_data)
+{
+   counter_arch_alarm_t *due;
+
+   ARG_UNUSED(dev);
+   ARG_UNUSED(ticks);
+   ARG_UNUSED(user_data);
+
+   CRITICAL_STATEMENT(counter_arch_channels[chan_id].programmed = false);
+
+   // The callbacks run one by one without the lock, they may arm alarms again
+   do
+   {
+      uint32_t now = counter_arch_now();
+
+      due = NULL;
+
+      CRITICAL_SECTION_BEGIN();
+      for (counter_arch_alarm_t *alarm = counter_arch_channels[chan_id].alarms; alarm != NULL; alarm = alarm->next)
+      {
+         if (alarm->armed && counter_arch_due(alarm, now))
+         {
+            alarm->armed = false;
+            due = alarm;
+            break;
+         }
+      }
+      CRITICAL_SECTION_END();
+
+      if (due != NULL)
+      {
+         due->callback(due);
+      }
+   }
+   while (due != NULL);
+
+   CRITICAL_STATEMENT(counter_arch_channel_program(chan_id));
+}
+
+
+bool counter_arch_init(void)
+{
+   uint8_t channels;
+   int err;
+
+   if (counter_arch_started)
+   {
+      return true;
+   }
+
+   if (!device_is_ready(counter_arch_dev))
+   {
+      DBG("counter: device not ready!\n");
+      return false;
+   }
+
+   if (counter_get_frequency(counter_arch_dev) != CONFIG_MYOS_COUNTER_FREQUENCY)
+   {
+      DBG("counter: runs at %u Hz instead of %u Hz!\n",
+          counter_get_frequency(counter_arch_dev), CONFIG_MYOS_COUNTER_FREQUENCY);
+      return false;
+   }
+
+   channels = counter_get_num_of_channels(counter_arch_dev);
+   if (channels == 0)
+   {
+      DBG("counter: no alarm channels!\n");
+      return false;
+   }
+
+   counter_arch_channel_count = MIN(channels, CONFIG_MYOS_COUNTER_CHANNELS);
+   counter_arch_top_value = counter_get_top_value(counter_arch_dev);
+
+   for (uint8_t i = 0; i < counter_arch_channel_count; i++)
+   {
+      counter_arch_channels[i].cfg.flags = COUNTER_ALARM_CFG_ABSOLUTE | COUNTER_ALARM_CFG_EXPIRE_WHEN_LATE;
+      counter_arch_channels[i].cfg.callback = counter_arch_isr;
+      counter_arch_channels[i].cfg.user_data = NULL;
+   }
+
+   /* With the guard period, an absolute alarm more than half a period ahead counts as late
+      and expires immediately, instead of one period later */
+   err = counter_set_guard_period(counter_arch_dev, counter_arch_top_value / 2U,
+                                  COUNTER_GUARD_PERIOD_LATE_TO_SET);
+   if (err != 0)
+   {
+      DBG("counter: no guard period %d, passed deadlines expire with the next tick\n", err);
+      counter_arch_no_guard = true;
+   }
+
+   if (counter_start(counter_arch_dev) != 0)
+   {
+      DBG("counter: counter_start failed!\n");
+      return false;
+   }
+
+   counter_arch_started = true;
+   return true;
+}
+
+
+uint32_t counter_arch_now(void)
+{
+   uint32_t ticks = 0;
+
+   counter_get_value(counter_arch_dev, &ticks);
+   return ticks;
+}
+
+
+uint32_t counter_arch_top(void)
+{
+   return counter_arch_top_value;
+}
+
+
+bool counter_arch_alarm_register(counter_arch_alarm_t *alarm, counter_arch_callback_t callback)
+{
+   if (!counter_arch_init())
+   {
+      return false;
+   }
+
+   CRITICAL_SECTION_BEGIN();
+
+   if (alarm->callback == NULL)
+   {
+      counter_arch_channel_t *ch;
+
+      alarm->callback = callback;
+      alarm->armed = false;
+      alarm->channel = counter_arch_registered++ % counter_arch_channel_count;
+
+      ch = &counter_arch_channels[alarm->channel];
+      alarm->next = ch->alarms;
+      ch->alarms = alarm;
+   }
+
+   CRITICAL_SECTION_END();
+
+   return true;
+}
+
+
+void counter_arch_alarm_set(counter_arch_alarm_t *alarm, uint32_t ticks)
+{
+   if (alarm->callback == NULL)
+   {
+      return;
+   }
+
+   if (ticks > counter_arch_top_value)
+   {
+      ticks -= counter_arch_top_value + 1U;
+   }
+
+   CRITICAL_SECTION_BEGIN();
+
+   alarm->ticks = ticks;
+   alarm->armed = true;
+   counter_arch_channel_program(alarm->channel);
+
+   CRITICAL_SECTION_END();
+}
+
+
+void counter_arch_alarm_cancel(counter_arch_alarm_t *alarm)
+{
+   if (alarm->callback == NULL)
+   {
+      return;
+   }
+
+   CRITICAL_SECTION_BEGIN();
+
+   alarm->armed = false;
+   counter_arch_channel_program(alarm->channel);
+
+   CRITICAL_SECTION_END();
+}
@@ -0,0 +1,141 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file counter_arch.h
+ *
+ * @brief Deadline multiplexer over the channels of one Zephyr counter.
+ * @details The timestamp and the rtimer port share the counter chosen in the devicetree
+ *          as myos,counter, for example:
+ * @code
+ *     &timers9 {
+ *         status = "okay";
+ *         st,prescaler = <1679>;
+ *
+ *         myos_counter: counter {
+ *             status = "okay";
+ *         };
+ *     };
+ *
+ *     / {
+ *         chosen {
+ *             myos,counter = &myos_counter;
+ *         };
+ *     };
+ * @endcode
+ *
+ *          On native_sim the simulated counter0 is chosen. It counts in the virtual time of
+ *          the simulator, so timers expire deterministically and as fast as the host runs.
+ *
+ *          Every user of the counter registers a counter_arch_alarm_t, which is bound to
+ *          one of the first CONFIG_MYOS_COUNTER_CHANNELS channels round robin. If the
+ *          counter has a channel per alarm every alarm programs its own channel, otherwise
+ *          the channel is programmed for the earliest armed alarm bound to it. The alarm
+ *          configuration of every channel is built once, arming an alarm only updates the
+ *          ticks.
+ *
+ *          A deadline is at most half a counter period ahead, one which is further away
+ *          counts as passed. A passed deadline expires immediately.
+ *
+ *          The alarm callbacks run in the counter ISR, one at a time and without the
+ *          critical section held, so they may arm their own or other alarms again.
+ */
+
+#ifndef COUNTER_ARCH_H_
+#define COUNTER_ARCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*! Counter ticks per millisecond, the timestamp ticks at 1 kHz. */
+#define COUNTER_ARCH_TICKS_PER_MS   (CONFIG_MYOS_COUNTER_FREQUENCY / 1000U)
+
+struct counter_arch_alarm;
+
+/*!
+ * @typedef counter_arch_callback_t
+ * @brief Called from the counter ISR once the alarm is due, the alarm is disarmed already.
+ */
+typedef void (*counter_arch_callback_t)(struct counter_arch_alarm *alarm);
+
+/*!
+ * @struct counter_arch_alarm_t
+ * @brief One deadline on the shared counter.
+ *
+ * @var counter_arch_alarm_t::callback
+ *      Called when the counter reaches ticks.
+ * @var counter_arch_alarm_t::ticks
+ *      Absolute counter value of the deadline.
+ * @var counter_arch_alarm_t::next
+ *      Next alarm bound to the same channel.
+ * @var counter_arch_alarm_t::channel
+ *      Channel the alarm is bound to.
+ * @var counter_arch_alarm_t::armed
+ *      True while the deadline is pending.
+ */
+typedef struct counter_arch_alarm {
+   counter_arch_callback_t callback;
+   uint32_t ticks;
+   struct counter_arch_alarm *next;
+   uint8_t channel;
+   bool armed;
+} counter_arch_alarm_t;
+
+/*!
+ * @brief Starts the counter, returns false if it is not usable. Can be called more than once.
+ */
+bool counter_arch_init(void);
+
+/*!
+ * @brief Returns the current counter value.
+ */
+uint32_t counter_arch_now(void);
+
+/*!
+ * @brief Returns the top value of the counter, it counts from 0 to top and wraps around.
+ */
+uint32_t counter_arch_top(void);
+
+/*!
+ * @brief Binds an alarm to a channel, nothing happens if it is registered already.
+ *        Starts the counter first, returns false if it is not usable.
+ */
+bool counter_arch_alarm_register(counter_arch_alarm_t *alarm, counter_arch_callback_t callback);
+
+/*!
+ * @brief Arms the alarm for the absolute counter value ticks, replacing a pending deadline.
+ *        ticks may exceed the top value by less than a period. Callable from ISRs.
+ */
+void counter_arch_alarm_set(counter_arch_alarm_t *alarm, uint32_t ticks);
+
+/*!
+ * @brief Disarms the alarm. Callable from ISRs.
+ */
+void counter_arch_alarm_cancel(counter_arch_alarm_t *alarm);
+
+#endif /* COUNTER_ARCH_H_ */
@@ -30,6 +30,36 @@
 
 #include <zephyr/irq.h>
 
+#if defined(CONFIG_MYOS_CRITICAL_BASEPRI)
+
+#include <cmsis_core.h>
+
+/*
+   BASEPRI value of the CONFIG_MYOS_CRITICAL_BASEPRI_PRIO interrupt priority.
+   Interrupts with a numerically lower (more urgent) priority stay enabled
+   inside a MyOS critical section and must never call into MyOS.
+*/
+#define CRITICAL_ARCH_BASEPRI                                                 \
+   (((CONFIG_MYOS_CRITICAL_BASEPRI_PRIO + _IRQ_PRIO_OFFSET)                  \
+     << (8 - NUM_IRQ_PRIO_BITS)) & 0xff)
+
+/*
+   __set_BASEPRI_MAX() only ever raises the mask, so a section nested in an
+   irq_lock() or in a more restrictive ISR keeps the stronger mask.
+*/
+#define CRITICAL_ARCH_SECTION_BEGIN()           \
+   do {                                         \
+      uint32_t __myos_basepri__ = __get_BASEPRI(); \
+      __set_BASEPRI_MAX(CRITICAL_ARCH_BASEPRI);  \
+      __ISB();
+
+
+#define CRITICAL_ARCH_SECTION_END()   \
+      __set_BASEPRI(__myos_basepri__);  \
+   }while(0)
+
+#else
+
 #define CRITICAL_ARCH_SECTION_BEGIN()           \
    do {                                         \
       unsigned int __myos_irq_key__ = irq_lock();
@@ -39,4 +69,6 @@
       irq_unlock(__myos_irq_key__);     \
    }while(0)   
 
+#endif
+
 #endif /* CRITICAL_ARCH_H_ */
@@ -0,0 +1,45 @@
+
+#include <zephyr/kernel.h>
+#include "counter_arch.h"
+#include "debug.h"
+#include "rtimer_arch.h"
+
+#if defined(CONFIG_MYOS_DEBUG_RTIMER)
+#define DBG(...) DBG_FUNC(__VA_ARGS__)
+#else
+#define DBG(...) do{}while(0)
+#endif
+
+static counter_arch_alarm_t rtimer_arch_alarm;
+
+extern void rtimer_scheduler (void);
+static void rtimer_arch_timer_callback(counter_arch_alarm_t *alarm)
+{
+    ARG_UNUSED(alarm);
+
+    rtimer_scheduler(); 
+}
+
+
+void rtimer_arch_init()
+{
+    if (!counter_arch_alarm_register(&rtimer_arch_alarm, rtimer_arch_timer_callback))
+    {
+        DBG("rtimer: counter not ready!\n");
+    }
+}
+
+rtimer_arch_timestamp_t rtimer_arch_now(void)
+{
+    return (rtimer_arch_timestamp_t)counter_arch_now();
+}
+
+
+void rtimer_arch_timer_set(rtimer_arch_timestamp_t stop)
+{
+    uint32_t now = counter_arch_now();
+    int16_t left = RTIMER_TIMESTAMP_ARCH_DIFF(stop, (rtimer_arch_timestamp_t)now);
+
+    // The rtimer timestamp is the low half word of the counter, a passed stop expires immediately
+    counter_arch_alarm_set(&rtimer_arch_alarm, left > 0 ? now + (uint32_t)left : now);
+}
@@ -36,7 +36,7 @@ typedef uint16_t rtimer_arch_timestamp_t;
 typedef uint16_t rtimer_arch_timespan_t;
 
 #define RTIMER_TIMESTAMP_ARCH_DIFF(a,b)         ((int16_t)((a)-(b)))
-#define RTIMER_ARCH_TICKS_PER_SEC               50000 // to access TIM6 on STM32	
+#define RTIMER_ARCH_TICKS_PER_SEC               CONFIG_MYOS_COUNTER_FREQUENCY
 
 
 
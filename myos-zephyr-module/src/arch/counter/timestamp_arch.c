@@ -0,0 +1,232 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include"timestamp_arch.h" 
+#include <zephyr/kernel.h>
+#include "counter_arch.h"
+#include "debug.h"
+#include "myos.h"
+
+#if defined(CONFIG_MYOS_DEBUG_TIMESTAMP)
+#define DBG(...) DBG_FUNC(__VA_ARGS__)
+#else
+#define DBG(...) do{}while(0)
+#endif
+
+#if !defined(CONFIG_MYOS_TIMESTAMP_TICKLESS)
+static timestamp_arch_t timestamp_counter = 0;
+#if CONFIG_MYOS_TIMESTAMP_SIZE > 32
+/* Bumped by the tick ISR after every update of the counter, which takes two stores on this core */
+static uint32_t timestamp_seq = 0;
+#endif
+#endif
+
+#if !defined(CONFIG_MYOS_TIMESTAMP_TICKLESS)
+timestamp_arch_t timestamp_arch_now(void)
+{
+#if CONFIG_MYOS_TIMESTAMP_SIZE > 32
+      timestamp_arch_t now;
+      uint32_t seq;
+
+      /* The ISR updates under an IRQ lock, so a retry is only needed if it ran in between */
+      do{
+            seq = __atomic_load_n(&timestamp_seq, __ATOMIC_ACQUIRE);
+            now = *(volatile timestamp_arch_t *)&timestamp_counter;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      }while(seq != __atomic_load_n(&timestamp_seq, __ATOMIC_RELAXED));
+
+      return now;
+#else
+      /* A load of up to one word cannot tear, the tick ISR is the only writer */
+      return __atomic_load_n(&timestamp_counter, __ATOMIC_RELAXED);
+#endif
+}
+#endif
+
+static counter_arch_alarm_t timestamp_alarm;
+
+#if defined(CONFIG_MYOS_TIMESTAMP_TICKLESS)
+
+/*
+ * Tickless mode: the timestamp is derived from the free-running counter. Its wrap-arounds are
+ * detected in software, timestamp_arch_extend() has to see the counter at least once per
+ * counter period. The counter alarm is programmed for ptimer_next_stop, but never further
+ * ahead than half a counter period, so this is always the case.
+ */
+
+static uint32_t timestamp_counter_top = 0;      /* top value of the counter, period is top+1 ticks */
+static uint32_t timestamp_counter_last = 0;     /* counter value seen at the last extension */
+static timestamp_arch_t timestamp_epoch = 0;    /* timestamp at the last wrap-around */
+static uint32_t timestamp_epoch_rem = 0;        /* counter ticks of the last wrap-around below one timestamp tick */
+static bool timestamp_alarm_for_ptimer = false; /* alarm is programmed for ptimer_next_stop */
+static timestamp_arch_t timestamp_alarm_stop = 0;
+
+/* Must be called with interrupts locked. Returns the timestamp for counter value 'ticks'. */
+static timestamp_arch_t timestamp_arch_extend(uint32_t ticks)
+{
+      if (ticks < timestamp_counter_last)
+      {
+            uint32_t total = timestamp_epoch_rem + timestamp_counter_top + 1U;
+
+            timestamp_epoch += (timestamp_arch_t)(total / COUNTER_ARCH_TICKS_PER_MS);
+            timestamp_epoch_rem = total % COUNTER_ARCH_TICKS_PER_MS;
+      }
+
+      timestamp_counter_last = ticks;
+
+      return (timestamp_arch_t)(timestamp_epoch + (timestamp_epoch_rem + ticks) / COUNTER_ARCH_TICKS_PER_MS);
+}
+
+timestamp_arch_t timestamp_arch_now(void)
+{
+      timestamp_arch_t now;
+      uint32_t ticks;
+
+      CRITICAL_SECTION_BEGIN();
+      ticks = counter_arch_now();
+      now = timestamp_arch_extend(ticks);
+      CRITICAL_SECTION_END();
+
+      return now;
+}
+
+/* Must be called with interrupts locked. Polls ptimer_process if due, otherwise arms the alarm. */
+static void timestamp_arch_alarm_program(void)
+{
+      uint32_t ticks;
+      uint32_t delay = timestamp_counter_top / 2U;
+      timestamp_arch_t now;
+
+      ticks = counter_arch_now();
+      now = timestamp_arch_extend(ticks);
+
+      timestamp_alarm_for_ptimer = false;
+
+      if (ptimer_pending)
+      {
+            UTILS_INT(CONFIG_MYOS_TIMESTAMP_SIZE) left = TIMESTAMP_ARCH_DIFF(ptimer_next_stop, now);
+
+            if (left <= 0)
+            {
+                  ptimer_pending = false;
+                  process_poll(&ptimer_process);
+            }
+            else if ((uint64_t)left * COUNTER_ARCH_TICKS_PER_MS <= delay)
+            {
+                  /* counter ticks until the timestamp turns to ptimer_next_stop */
+                  delay = (uint32_t)left * COUNTER_ARCH_TICKS_PER_MS - (timestamp_epoch_rem + ticks) % COUNTER_ARCH_TICKS_PER_MS;
+                  timestamp_alarm_for_ptimer = true;
+                  timestamp_alarm_stop = ptimer_next_stop;
+            }
+      }
+
+      counter_arch_alarm_set(&timestamp_alarm, ticks + delay);
+}
+
+static UTILS_HOT_FUNC void timestamp_arch_myos_tick(counter_arch_alarm_t *alarm)
+{
+      ARG_UNUSED(alarm);
+
+      CRITICAL_SECTION_BEGIN();
+      timestamp_arch_alarm_program();
+      CRITICAL_SECTION_END();
+}
+
+void timestamp_arch_alarm_update(void)
+{
+      CRITICAL_SECTION_BEGIN();
+
+      // Only reprogram if ptimer_next_stop moved, a spurious alarm is harmless
+      if (!(timestamp_alarm_for_ptimer && ptimer_pending && timestamp_alarm_stop == ptimer_next_stop))
+      {
+            timestamp_arch_alarm_program();
+      }
+
+      CRITICAL_SECTION_END();
+}
+
+
+void timestamp_arch_module_init(void)
+{
+      if (!counter_arch_alarm_register(&timestamp_alarm, timestamp_arch_myos_tick))
+      {
+            DBG("timestamp: counter not ready!\n");
+            return;
+      }
+
+      timestamp_counter_top = counter_arch_top();
+      timestamp_counter_last = counter_arch_now();
+
+      CRITICAL_SECTION_BEGIN();
+      timestamp_arch_alarm_program();
+      CRITICAL_SECTION_END();
+
+      DBG("timetamp: initialized (tickless): \n");
+}
+
+#else
+
+static UTILS_HOT_FUNC void timestamp_arch_myos_tick(counter_arch_alarm_t *alarm)
+{
+#if CONFIG_MYOS_TIMESTAMP_SIZE > 32
+      CRITICAL_SECTION_BEGIN();
+      timestamp_counter++;
+      __atomic_store_n(&timestamp_seq, timestamp_seq + 1U, __ATOMIC_RELEASE);
+      CRITICAL_SECTION_END();
+#else
+      __atomic_store_n(&timestamp_counter, timestamp_counter + 1, __ATOMIC_RELAXED);
+#endif
+
+      // Process ptimers if there are pending timers and the next stop time has passed
+      if (ptimer_pending && timestamp_passed(ptimer_next_stop)) 
+      {
+            ptimer_pending = false;
+            process_poll(&ptimer_process);
+      }
+
+
+      /* Re-arm for the next 1 ms after the last deadline, so the tick does not drift */
+      counter_arch_alarm_set(alarm, alarm->ticks + COUNTER_ARCH_TICKS_PER_MS);
+}
+
+
+void timestamp_arch_module_init(void)
+{
+      if (!counter_arch_alarm_register(&timestamp_alarm, timestamp_arch_myos_tick))
+      {
+            DBG("timestamp: counter not ready!\n");
+            return;
+      }
+
+      counter_arch_alarm_set(&timestamp_alarm, counter_arch_now() + COUNTER_ARCH_TICKS_PER_MS);
+
+      DBG("timetamp: initialized: \n");
+}
+
+#endif /* CONFIG_MYOS_TIMESTAMP_TICKLESS */
\ No newline at end of file
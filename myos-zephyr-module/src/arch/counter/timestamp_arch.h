@@ -60,4 +60,9 @@ typedef UTILS_UINT(CONFIG_MYOS_TIMESTAMP_SIZE) timestamp_arch_t;
 void timestamp_arch_module_init(void);
 timestamp_arch_t timestamp_arch_now(void);
 
+#if defined(CONFIG_MYOS_TIMESTAMP_TICKLESS)
+/* Reprograms the counter alarm after ptimer_next_stop or ptimer_pending changed */
+void timestamp_arch_alarm_update(void);
+#endif
+
 #endif /* TIMESTAMP_ARCH_H_ */
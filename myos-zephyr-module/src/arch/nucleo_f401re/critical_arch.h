@@ -1,42 +0,0 @@
-/*! \copyright
- 
-   https://opensource.org/license/mit/
-
-   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
-   
-   Permission is hereby granted, free of charge, to any person
-   obtaining a copy of this software and associated documentation
-   files (the "Software"), to deal in the Software without
-   restriction, including without limitation the rights to use,
-   copy, modify, merge, publish, distribute, sublicense, and/or sell
-   copies of the Software, and to permit persons to whom the
-   Software is furnished to do so, subject to the following
-   conditions:
-   
-   The above copyright notice and this permission notice shall be
-   included in all copies or substantial portions of the Software.
-   
-   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
-   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
-   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
-   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
-   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
-   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
-   OTHER DEALINGS IN THE SOFTWARE.
-*/
-#ifndef CRITICAL_ARCH_H_
-#define CRITICAL_ARCH_H_
-
-#include <zephyr/irq.h>
-
-#define CRITICAL_ARCH_SECTION_BEGIN()           \
-   do {                                         \
-      unsigned int __myos_irq_key__ = irq_lock();
-
-
-#define CRITICAL_ARCH_SECTION_END()   \
-      irq_unlock(__myos_irq_key__);     \
-   }while(0)   
-
-#endif /* CRITICAL_ARCH_H_ */
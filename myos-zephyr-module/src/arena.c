@@ -26,38 +26,53 @@
    OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include "arena.h"
 
-/*!
-    \file       timestamp_arch.h
+#include <string.h>
 
-    \brief      Architecture depending part of time stamp implementation
 
-    \details    Provides the architecture dependent part of time stamp implementation
-                for architecture hosted.
+void arena_init(arena_t *arena, void *region, size_t size)
+{
+   arena->base = region;
+   arena->size = size;
+   arena->used = 0;
+   arena->peak = 0;
+}
 
-                Hosted means that the myos runs in an own process on top of a host
-                operating system.
-
-*/
 
+void* arena_alloc_aligned(arena_t *arena, size_t size, size_t align)
+{
+   // Aligns the address, the region itself does not need to be aligned to align.
+   uintptr_t start = ((uintptr_t)arena->base + arena->used + align - 1) & ~(uintptr_t)(align - 1);
+   size_t offset = start - (uintptr_t)arena->base;
 
-#ifndef TIMESTAMP_ARCH_H_
-#define TIMESTAMP_ARCH_H_
-
-#include <stdint.h>
-#include "utils.h"
- 
+   if(offset > arena->size || size > arena->size - offset)
+   {
+      return NULL;
+   }
 
-#define TIMESTAMP_ARCH_TICKS_PER_SEC 1000
+   arena->used = offset + size;
+   if(arena->used > arena->peak)
+   {
+      arena->peak = arena->used;
+   }
+   return (void*)start;
+}
 
-typedef UTILS_UINT(CONFIG_MYOS_TIMESTAMP_SIZE) timestamp_arch_t;
 
-/* Safe wrap-around difference */
-#define TIMESTAMP_ARCH_DIFF(a, b) \
-    ((UTILS_INT(CONFIG_MYOS_TIMESTAMP_SIZE))((timestamp_arch_t)(a) - (timestamp_arch_t)(b)))
+void* arena_alloc(arena_t *arena, size_t size)
+{
+   return arena_alloc_aligned(arena, size, ARENA_ALIGNMENT);
+}
 
 
-void timestamp_arch_module_init(void);
-timestamp_arch_t timestamp_arch_now(void);
+void* arena_calloc(arena_t *arena, size_t size)
+{
+   void *block = arena_alloc(arena, size);
 
-#endif /* TIMESTAMP_ARCH_H_ */
+   if(block)
+   {
+      memset(block, 0, size);
+   }
+   return block;
+}
@@ -0,0 +1,173 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file arena.h
+ *
+ * @brief Bump-pointer arena allocator over a static region.
+ * @details An arena hands out variable-sized blocks from one static region by moving a
+ *          pointer, allocation is O(1) and never fragments. Blocks are not freed one by
+ *          one: arena_mark() takes the current fill level and arena_release() frees
+ *          everything allocated after it at once, arena_reset() frees the whole arena.
+ *          Scopes nest like a stack.
+ *
+ *          A process which needs memory for its whole lifetime allocates it from an arena
+ *          of its own when it starts and resets the arena in its exit handler. Memory which
+ *          is only needed while an event is handled comes from the scratch arena of the
+ *          process module with process_scratch_alloc() (CONFIG_MYOS_PROC_SCRATCH), it is
+ *          released when the thread returns, i.e. at the next wait or yield.
+ *
+ *          arena_peak() tells how much of the region was ever in use, which is the size
+ *          the region needs.
+ *
+ *          Arenas are not locked, use one from a single thread only.
+ *
+ * Usage Example:
+ * @code
+ *     ARENA_DEFINE(parser_arena, 512);
+ *
+ *     PROCESS_THREAD(parser)
+ *     {
+ *        PROCESS_EXITHANDLER(arena_reset(&parser_arena));
+ *        PROCESS_BEGIN();
+ *
+ *        for(;;)
+ *        {
+ *           PROCESS_WAIT_EVENT_UNTIL(PROCESS_EVENT_ID() == line_event);
+ *
+ *           arena_mark_t mark = arena_mark(&parser_arena);
+ *           token_t *tokens = arena_alloc(&parser_arena, ntokens * sizeof(token_t));
+ *           ...
+ *           arena_release(&parser_arena, mark);
+ *        }
+ *
+ *        PROCESS_END();
+ *     }
+ * @endcode
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Alignment of the blocks returned by arena_alloc(), enough for any scalar type */
+#define ARENA_ALIGNMENT 8
+
+typedef struct {
+   uint8_t *base;
+   size_t size;
+   size_t used;
+   size_t peak;
+} arena_t;
+
+/* Fill level of an arena, taken by arena_mark() */
+typedef size_t arena_mark_t;
+
+#define ARENA_INITIALIZER(region) \
+   { (uint8_t*)(region), sizeof(region), 0, 0 }
+
+/**
+ * @brief Defines the arena `name` over a static region of `size` bytes.
+ */
+#define ARENA_DEFINE(name,size) \
+   static uint8_t name##_region[size] __attribute__((aligned(ARENA_ALIGNMENT))); \
+   arena_t name = ARENA_INITIALIZER(name##_region)
+
+/**
+ * @brief Initializes an arena over the region of `size` bytes at `region`.
+ */
+void arena_init(arena_t *arena, void *region, size_t size);
+
+/**
+ * @brief Allocates `size` bytes aligned to ARENA_ALIGNMENT.
+ *
+ * @return The block, NULL if the arena is exhausted.
+ */
+void* arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Allocates `size` bytes aligned to `align`, which must be a power of two.
+ *
+ * @return The block, NULL if the arena is exhausted.
+ */
+void* arena_alloc_aligned(arena_t *arena, size_t size, size_t align);
+
+/**
+ * @brief Allocates `size` zeroed bytes aligned to ARENA_ALIGNMENT.
+ *
+ * @return The block, NULL if the arena is exhausted.
+ */
+void* arena_calloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Takes the current fill level of an arena.
+ */
+static inline arena_mark_t arena_mark(const arena_t *arena)
+{
+   return arena->used;
+}
+
+/**
+ * @brief Frees all blocks allocated since `mark` was taken.
+ */
+static inline void arena_release(arena_t *arena, arena_mark_t mark)
+{
+   if(mark < arena->used)
+   {
+      arena->used = mark;
+   }
+}
+
+/**
+ * @brief Frees all blocks of an arena.
+ */
+static inline void arena_reset(arena_t *arena)
+{
+   arena->used = 0;
+}
+
+/**
+ * @brief Number of bytes which are still free, without alignment padding.
+ */
+static inline size_t arena_available(const arena_t *arena)
+{
+   return arena->size - arena->used;
+}
+
+/**
+ * @brief Highest fill level the arena ever reached.
+ */
+static inline size_t arena_peak(const arena_t *arena)
+{
+   return arena->peak;
+}
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,120 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "bitarray.h"
+
+/*
+ * The bytes of a bit array are read and written as little endian 32 bit words, which keeps
+ * bit n in byte n/8 like the single bit macros. The arrays are word aligned, so the memcpy
+ * calls are single loads and stores.
+ */
+static inline uint32_t bitarray_word(const bitarray_t *bits, size_t word)
+{
+   uint32_t value;
+   memcpy(&value, &bits[word << 2], sizeof(value));
+   return value;
+}
+
+static inline void bitarray_word_set(bitarray_t *bits, size_t word, uint32_t value)
+{
+   memcpy(&bits[word << 2], &value, sizeof(value));
+}
+
+/* Finds the first bit of a word array with (word ^ invert) set, at or after from. */
+static int bitarray_find(const bitarray_t *bits, size_t size, size_t from, uint32_t invert)
+{
+   size_t words = size >> 5;
+   size_t word = from >> 5;
+   uint32_t value;
+
+   if(from >= size)
+   {
+      return -1;
+   }
+
+   // Masks the bits below from in the first word.
+   value = (bitarray_word(bits, word) ^ invert) & (UINT32_MAX << (from & 31));
+
+   for(;;)
+   {
+      if(value)
+      {
+         return (int)((word << 5) + __builtin_ctz(value));
+      }
+      if(++word >= words)
+      {
+         return -1;
+      }
+      value = bitarray_word(bits, word) ^ invert;
+   }
+}
+
+
+int bitarray_next_set(const bitarray_t *bits, size_t size, size_t from)
+{
+   return bitarray_find(bits, size, from, 0);
+}
+
+
+int bitarray_next_reset(const bitarray_t *bits, size_t size, size_t from)
+{
+   return bitarray_find(bits, size, from, UINT32_MAX);
+}
+
+
+size_t bitarray_popcount(const bitarray_t *bits, size_t size)
+{
+   size_t count = 0;
+
+   for(size_t word = 0; word < (size >> 5); word++)
+   {
+      count += (size_t)__builtin_popcount(bitarray_word(bits, word));
+   }
+
+   return count;
+}
+
+
+void bitarray_write_range(bitarray_t *bits, size_t first, size_t count, bool value)
+{
+   size_t word = first >> 5;
+   size_t shift = first & 31;
+
+   while(count)
+   {
+      size_t n = 32 - shift < count ? 32 - shift : count;
+      uint32_t mask = (n == 32 ? UINT32_MAX : ((uint32_t)1 << n) - 1) << shift;
+      uint32_t old = bitarray_word(bits, word);
+
+      bitarray_word_set(bits, word, value ? old | mask : old & ~mask);
+
+      count -= n;
+      shift = 0;
+      word++;
+   }
+}
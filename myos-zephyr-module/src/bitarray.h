@@ -45,6 +45,8 @@
  * - Efficient memory usage by packing bits into bytes.
  * - Macros for easy manipulation of individual bits.
  * - Inline functions for common operations like setting, resetting, and toggling bits.
+ * - Searching, counting, range and iteration operations which work a 32 bit word at a
+ *   time, see BITARRAY_FFS() and the following macros.
  *
  * Usage Examples:
  * - Defining a bit array:
@@ -72,8 +74,14 @@
 #ifndef BITARRAY_H_
 #define BITARRAY_H_
 #include <stdint.h> /* uint8_t */
+#include <stddef.h> /* size_t */
+#include <stdbool.h>
 #include <string.h> /* memset */
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The word operations of bitarray.h expect a little endian target"
+#endif
+
 
 /*!
  * @brief Macro representing the reset state (0) for bit array operations.
@@ -103,9 +111,9 @@ typedef uint8_t bitarray_t;
 
 /*!
  * @brief Defines a bit array.
- * @details This macro is used to define a bit array in memory-constrained embedded systems. It efficiently allocates memory for storing bits, rounded up to the nearest byte. This is crucial for systems where memory efficiency is paramount. The macro creates a uniquely named bit array instance with a specified minimum bit capacity, enabling efficient bit-level operations.
+ * @details This macro is used to define a bit array in memory-constrained embedded systems. It efficiently allocates memory for storing bits, rounded up to the nearest 32 bit word and word aligned, so the search and count operations can work a word at a time. This is crucial for systems where memory efficiency is paramount. The macro creates a uniquely named bit array instance with a specified minimum bit capacity, enabling efficient bit-level operations.
  * @param[in] name The identifier for the bit array. This becomes a part of the variable name for the bit array.
- * @param[in] size The minimum number of bits required for the bit array. The actual size is computed to fit this minimum, adjusted to byte boundaries.
+ * @param[in] size The minimum number of bits required for the bit array. The actual size is computed to fit this minimum, adjusted to word boundaries.
  *
  * Usage Example:
  * @code
@@ -114,7 +122,7 @@ typedef uint8_t bitarray_t;
  * @endcode
  */
 #define BITARRAY(name,size) \
-    bitarray_t name##_bitarray[((size)+7)>>3]
+    bitarray_t name##_bitarray[(((size)+31)>>5)<<2] __attribute__((aligned(4)))
 
 
 /*!
@@ -138,7 +146,7 @@ typedef uint8_t bitarray_t;
  *          The size is determined based on the memory allocated for the array, considering that
  *          each unit in the array stores a byte (8 bits). This macro is useful for obtaining the
  *          actual capacity of a bit array, which may be slightly larger than the originally requested
- *          size due to rounding up to the nearest byte. It's particularly useful in scenarios where
+ *          size due to rounding up to the nearest 32 bit word. It's particularly useful in scenarios where
  *          precise knowledge of the bit array's capacity is critical.
  *
  * @param[in] name The name of the bit array for which the size is to be calculated.
@@ -146,7 +154,7 @@ typedef uint8_t bitarray_t;
  * Usage Example:
  * @code
  *     BITARRAY(status_flags, 10); // Define a bit array with at least 10 bits
- *     unsigned int size = BITARRAY_SIZE(status_flags); // size will be 16 (as it rounds up to the nearest byte)
+ *     unsigned int size = BITARRAY_SIZE(status_flags); // size will be 32 (as it rounds up to the nearest word)
  * @endcode
  */
 #define BITARRAY_SIZE(name) \
@@ -245,4 +253,88 @@ typedef uint8_t bitarray_t;
     do{if((value) == 0){BITARRAY_RESET(name,bit);}else{BITARRAY_SET(name,bit);}}while(0)
 
 
+/*!
+ * @brief Finds the first set bit of a bit array.
+ * @details Tests 32 bits per step and locates the bit within the word with a count
+ *          trailing zeros instruction.
+ * @param[in] name The name of the bit array.
+ * @return Index of the lowest set bit, -1 if no bit is set.
+ *
+ * Usage Example:
+ * @code
+ *     BITARRAY(pending, 64);
+ *     int next = BITARRAY_FFS(pending);
+ * @endcode
+ */
+#define BITARRAY_FFS(name) \
+    bitarray_next_set(name##_bitarray,BITARRAY_SIZE(name),0)
+
+/*!
+ * @brief Finds the first reset bit of a bit array, e.g. a free slot.
+ * @param[in] name The name of the bit array.
+ * @return Index of the lowest reset bit, -1 if all bits are set.
+ */
+#define BITARRAY_FFZ(name) \
+    bitarray_next_reset(name##_bitarray,BITARRAY_SIZE(name),0)
+
+/*!
+ * @brief Finds the next set bit at or after a given index.
+ * @param[in] name The name of the bit array.
+ * @param[in] from Index to start the search at.
+ * @return Index of the set bit, -1 if there is none.
+ */
+#define BITARRAY_NEXT_SET(name,from) \
+    bitarray_next_set(name##_bitarray,BITARRAY_SIZE(name),from)
+
+/*!
+ * @brief Counts the set bits of a bit array.
+ * @param[in] name The name of the bit array.
+ * @return Number of set bits.
+ */
+#define BITARRAY_POPCOUNT(name) \
+    bitarray_popcount(name##_bitarray,BITARRAY_SIZE(name))
+
+/*!
+ * @brief Sets `count` bits starting at index `first`.
+ * @details Whole words in the range are written at once.
+ * @param[in] name The name of the bit array.
+ * @param[in] first Index of the first bit to set.
+ * @param[in] count Number of bits to set.
+ */
+#define BITARRAY_SET_RANGE(name,first,count) \
+    bitarray_write_range(name##_bitarray,first,count,true)
+
+/*!
+ * @brief Resets `count` bits starting at index `first`.
+ * @param[in] name The name of the bit array.
+ * @param[in] first Index of the first bit to reset.
+ * @param[in] count Number of bits to reset.
+ */
+#define BITARRAY_RESET_RANGE(name,first,count) \
+    bitarray_write_range(name##_bitarray,first,count,false)
+
+/*!
+ * @brief Iterates over the indices of all set bits in ascending order.
+ * @details The bit of the current index may be reset in the loop body.
+ * @param[in] name The name of the bit array.
+ * @param[in] bit An int variable which holds the index of the current set bit.
+ *
+ * Usage Example:
+ * @code
+ *     int bit;
+ *     BITARRAY_FOREACH_SET(pending, bit) {
+ *         BITARRAY_RESET(pending, bit);
+ *         handle(bit);
+ *     }
+ * @endcode
+ */
+#define BITARRAY_FOREACH_SET(name,bit) \
+    for((bit) = BITARRAY_FFS(name); (bit) >= 0; (bit) = BITARRAY_NEXT_SET(name,(bit)+1))
+
+int bitarray_next_set(const bitarray_t *bits, size_t size, size_t from);
+int bitarray_next_reset(const bitarray_t *bits, size_t size, size_t from);
+size_t bitarray_popcount(const bitarray_t *bits, size_t size);
+void bitarray_write_range(bitarray_t *bits, size_t first, size_t count, bool value);
+
+
 #endif /* BITARRAY_H_ */
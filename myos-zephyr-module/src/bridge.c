@@ -0,0 +1,159 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "bridge.h"
+
+#if defined(CONFIG_MYOS_BRIDGE)
+
+/*!
+ * @struct bridge_t
+ * @brief A registered kernel object.
+ *
+ * @var bridge_t::to
+ *      Target process.
+ * @var bridge_t::evtid
+ *      Event id of the items.
+ * @var bridge_t::msg
+ *      Message buffer of a k_msgq, NULL otherwise.
+ */
+typedef struct {
+   process_t *to;
+   process_event_id_t evtid;
+   void *msg;
+}bridge_t;
+
+static bridge_t bridges[CONFIG_MYOS_BRIDGE_SIZE];
+
+// Entry 0 is the wakeup semaphore, entry i + 1 belongs to bridges[i].
+static struct k_poll_event bridge_events[CONFIG_MYOS_BRIDGE_SIZE + 1];
+
+static size_t bridge_count;
+
+
+static bool bridge_add(int type, void *obj, void *msg, process_t *to, process_event_id_t evtid)
+{
+   if(bridge_count == CONFIG_MYOS_BRIDGE_SIZE)
+   {
+      return false;
+   }
+
+   bridges[bridge_count].to = to;
+   bridges[bridge_count].evtid = evtid;
+   bridges[bridge_count].msg = msg;
+   k_poll_event_init(&bridge_events[bridge_count + 1], type, K_POLL_MODE_NOTIFY_ONLY, obj);
+   bridge_count++;
+
+   return true;
+}
+
+
+bool myos_bridge_msgq(struct k_msgq *msgq, void *msg, process_t *to, process_event_id_t evtid)
+{
+   return bridge_add(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, msgq, msg, to, evtid);
+}
+
+
+bool myos_bridge_fifo(struct k_fifo *fifo, process_t *to, process_event_id_t evtid)
+{
+   return bridge_add(K_POLL_TYPE_FIFO_DATA_AVAILABLE, fifo, NULL, to, evtid);
+}
+
+
+bool myos_bridge_sem(struct k_sem *sem, process_t *to, process_event_id_t evtid)
+{
+   return bridge_add(K_POLL_TYPE_SEM_AVAILABLE, sem, NULL, to, evtid);
+}
+
+
+bool bridge_run(void)
+{
+   bool delivered = false;
+
+   for(size_t i = 0; i < bridge_count; i++)
+   {
+      bridge_t *bridge = &bridges[i];
+      struct k_poll_event *event = &bridge_events[i + 1];
+
+      switch(event->type)
+      {
+      case K_POLL_TYPE_MSGQ_DATA_AVAILABLE:
+         if(k_msgq_get(event->msgq, bridge->msg, K_NO_WAIT) == 0)
+         {
+            process_post_sync(bridge->to, bridge->evtid, bridge->msg);
+            delivered = true;
+         }
+         break;
+
+      case K_POLL_TYPE_FIFO_DATA_AVAILABLE:
+      {
+         void *item = k_fifo_get(event->fifo, K_NO_WAIT);
+
+         if(item)
+         {
+            process_post_sync(bridge->to, bridge->evtid, item);
+            delivered = true;
+         }
+         break;
+      }
+
+      default:
+         if(k_sem_take(event->sem, K_NO_WAIT) == 0)
+         {
+            process_post_sync(bridge->to, bridge->evtid, NULL);
+            delivered = true;
+         }
+         break;
+      }
+   }
+
+   return delivered;
+}
+
+
+void bridge_wait(void)
+{
+   k_poll(bridge_events, bridge_count + 1, K_FOREVER);
+
+   // The states are not cleared by k_poll(), the items are taken by bridge_run().
+   for(size_t i = 0; i <= bridge_count; i++)
+   {
+      bridge_events[i].state = K_POLL_STATE_NOT_READY;
+   }
+
+   // Consumes a wakeup, a give after this point is seen by the next k_poll().
+   k_sem_take(bridge_events[0].sem, K_NO_WAIT);
+}
+
+
+void bridge_module_init(struct k_sem *wakeup)
+{
+   bridge_count = 0;
+   k_poll_event_init(&bridge_events[0], K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, wakeup);
+}
+
+#endif /* CONFIG_MYOS_BRIDGE */
@@ -0,0 +1,127 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file bridge.h
+ *
+ * @brief Delivers items of Zephyr kernel objects to MyOS processes.
+ * @details Zephyr threads hand data to MyOS through their usual kernel objects. A
+ *          k_msgq, k_fifo or k_sem is registered once with a target process and an
+ *          event id. myos_run_forever() then waits on all of them and on its own wakeup
+ *          semaphore with a single k_poll(), so the MyOS thread sleeps until there is
+ *          work and nothing is polled busily.
+ *
+ *          Every pass of the scheduler loop takes at most one item of every registered
+ *          object and delivers it synchronously with process_post_sync(), so a full
+ *          event queue never loses an item:
+ *          - k_msgq: the message is copied into the buffer given at registration, the
+ *            event data points to it and is valid while the event is handled.
+ *          - k_fifo: the event data is the item, the process owns it afterwards.
+ *          - k_sem: one event per k_sem_give(), without data.
+ *
+ *          An item is lost like any other event if the process is not running. The
+ *          objects are registered from the MyOS thread, before myos_run_forever() or
+ *          from a process.
+ *
+ * Usage Example:
+ * @code
+ *     K_MSGQ_DEFINE(sample_msgq, sizeof(sample_t), 8, 4);
+ *     static sample_t sample;
+ *
+ *     void myos_scheduler(void)
+ *     {
+ *        myos_init();
+ *        process_start(&filter_process, NULL);
+ *        myos_bridge_msgq(&sample_msgq, &sample, &filter_process, SAMPLE_EVENT);
+ *        myos_run_forever();
+ *     }
+ *
+ *     // In any Zephyr thread
+ *     k_msgq_put(&sample_msgq, &adc_sample, K_NO_WAIT);
+ * @endcode
+ */
+
+#ifndef BRIDGE_H_
+#define BRIDGE_H_
+
+#include "myos.h"
+
+#include <zephyr/kernel.h>
+
+#if defined(CONFIG_MYOS_BRIDGE)
+
+/*!
+ * @brief Delivers the messages of a message queue to a process.
+ * @param[in] msgq The message queue.
+ * @param[in] msg Buffer of the message size which receives every message.
+ * @param[in] to Target process.
+ * @param[in] evtid Event id, the event data is msg.
+ * @return False if CONFIG_MYOS_BRIDGE_SIZE objects are registered already.
+ */
+bool myos_bridge_msgq(struct k_msgq *msgq, void *msg, process_t *to, process_event_id_t evtid);
+
+/*!
+ * @brief Delivers the items of a FIFO to a process.
+ * @param[in] fifo The FIFO.
+ * @param[in] to Target process.
+ * @param[in] evtid Event id, the event data is the item.
+ * @return False if CONFIG_MYOS_BRIDGE_SIZE objects are registered already.
+ */
+bool myos_bridge_fifo(struct k_fifo *fifo, process_t *to, process_event_id_t evtid);
+
+/*!
+ * @brief Delivers the gives of a semaphore to a process.
+ * @param[in] sem The semaphore, taken once per event.
+ * @param[in] to Target process.
+ * @param[in] evtid Event id, the event data is NULL.
+ * @return False if CONFIG_MYOS_BRIDGE_SIZE objects are registered already.
+ */
+bool myos_bridge_sem(struct k_sem *sem, process_t *to, process_event_id_t evtid);
+
+/*!
+ * @brief Delivers one item of every registered object which has one.
+ * @details Called by myos_run_forever().
+ * @return True if any item was delivered.
+ */
+bool bridge_run(void);
+
+/*!
+ * @brief Blocks until the MyOS thread is woken up or a registered object has an item.
+ * @details Called by myos_run_forever() instead of taking the wakeup semaphore.
+ */
+void bridge_wait(void);
+
+/*!
+ * @brief Initializes the bridge.
+ * @param[in] wakeup The wakeup semaphore of the MyOS thread, see myos_wakeup().
+ */
+void bridge_module_init(struct k_sem *wakeup);
+
+#endif /* CONFIG_MYOS_BRIDGE */
+
+#endif /* BRIDGE_H_ */
@@ -0,0 +1,227 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file channel.h
+ *
+ * @brief Bounded typed channels between processes.
+ * @details An event carries a single `void*`, so streaming samples from one process to
+ *          another with events costs one queue slot and one scheduler round-trip per sample.
+ *          A channel is a ringbuffer of typed items plus the process which is blocked on it.
+ *          PROCESS_CHANNEL_SEND() blocks the sender while the channel is full and
+ *          PROCESS_CHANNEL_RECV() blocks the receiver while it is empty.
+ *
+ *          The other side is only polled when it is actually blocked on the channel, and the
+ *          waiter is cleared with the poll. A sender filling the channel thus wakes the
+ *          receiver once per batch, not once per item, and the receiver then drains all
+ *          items in one run without going through the event queue.
+ *
+ *          A channel connects exactly one sending and one receiving process and must only
+ *          be used from the MyOS thread.
+ *
+ * Usage Example:
+ * @code
+ *     CHANNEL_TYPEDEF(samples, int16_t, 32);
+ *     static CHANNEL_T(samples) samples;     // CHANNEL_INIT(samples) before first use
+ *
+ *     PROCESS_THREAD(producer)
+ *     {
+ *        PROCESS_BEGIN();
+ *        while(1){
+ *           PROCESS_CHANNEL_SEND(samples, adc_read());
+ *        }
+ *        PROCESS_END();
+ *     }
+ *
+ *     PROCESS_THREAD(consumer)
+ *     {
+ *        static int16_t sample;
+ *        PROCESS_BEGIN();
+ *        while(1){
+ *           PROCESS_CHANNEL_RECV(samples, sample);
+ *           filter_step(sample);
+ *        }
+ *        PROCESS_END();
+ *     }
+ * @endcode
+ */
+
+#ifndef CHANNEL_H_
+#define CHANNEL_H_
+
+#include "myos.h"
+#include "ringbuffer.h"
+
+/*!
+ * @brief Declares a channel type.
+ * @details The actual type will be `name##_channel_t`, see CHANNEL_T().
+ * @param name The unique identification name for the channel type.
+ * @param type The data type of the items.
+ * @param size The number of items the channel can buffer.
+ */
+#define CHANNEL_TYPEDEF(name,type,size) \
+   RINGBUFFER_TYPEDEF(name##_channel,type,size); \
+   CHANNEL_TYPEDEF_STRUCT(name)
+
+/*!
+ * @brief Declares a channel type with a power-of-two size.
+ * @details Works like CHANNEL_TYPEDEF() but uses RINGBUFFER_TYPEDEF_POW2().
+ * @param name The unique identification name for the channel type.
+ * @param type The data type of the items.
+ * @param bits Base 2 logarithm of the number of items, a decimal literal from 1 to 15.
+ */
+#define CHANNEL_TYPEDEF_POW2(name,type,bits) \
+   RINGBUFFER_TYPEDEF_POW2(name##_channel,type,bits); \
+   CHANNEL_TYPEDEF_STRUCT(name)
+
+/*!
+ * @brief Declares the channel structure around the ringbuffer type.
+ * @details Used by CHANNEL_TYPEDEF() and CHANNEL_TYPEDEF_POW2().
+ */
+#define CHANNEL_TYPEDEF_STRUCT(name) \
+   typedef struct { \
+      RINGBUFFER_T(name##_channel) buffer; \
+      process_t *reader; \
+      process_t *writer; \
+   } name##_channel_t
+
+/*!
+ * @brief Retrieves the type of a channel.
+ * @param name The name used in CHANNEL_TYPEDEF().
+ */
+#define CHANNEL_T(name) \
+   name##_channel_t
+
+/*!
+ * @brief Initializes a channel to empty with no blocked processes.
+ * @param channel The channel instance.
+ */
+#define CHANNEL_INIT(channel) \
+   do{ \
+      RINGBUFFER_INIT((channel).buffer); \
+      (channel).reader = NULL; \
+      (channel).writer = NULL; \
+   }while(0)
+
+/*!
+ * @brief Number of items in a channel.
+ * @param channel The channel instance.
+ */
+#define CHANNEL_COUNT(channel) RINGBUFFER_COUNT((channel).buffer)
+
+/*!
+ * @brief Checks if a channel is full.
+ * @param channel The channel instance.
+ */
+#define CHANNEL_FULL(channel) RINGBUFFER_FULL((channel).buffer)
+
+/*!
+ * @brief Checks if a channel is empty.
+ * @param channel The channel instance.
+ */
+#define CHANNEL_EMPTY(channel) RINGBUFFER_EMPTY((channel).buffer)
+
+/*!
+ * @brief Evaluates a wait condition and registers the current process as the waiter.
+ * @details The waiter is only set while the condition is false, so the other side only
+ *          polls a process which is actually blocked on the channel.
+ * @param[out] waiter The reader or writer field of the channel.
+ * @param[in] ready The wait condition.
+ * @return \a ready
+ */
+static inline bool channel_wait(process_t **waiter, bool ready)
+{
+   *waiter = ready ? NULL : PROCESS_THIS();
+   return ready;
+}
+
+/*!
+ * @brief Polls the process blocked on the other side of a channel, if any.
+ * @details The waiter is cleared, so further items of the same batch do not poll again.
+ * @param[in,out] waiter The reader or writer field of the channel.
+ */
+static inline void channel_notify(process_t **waiter)
+{
+   if(*waiter){
+      process_poll(*waiter);
+      *waiter = NULL;
+   }
+}
+
+/*!
+ * @brief Writes an item into a channel without blocking.
+ * @details The channel must not be full. Polls the receiver if it is blocked on the channel.
+ * @param channel The channel instance.
+ * @param value The item to write.
+ */
+#define CHANNEL_WRITE(channel, value) \
+   do{ \
+      RINGBUFFER_TAIL_VAL((channel).buffer) = (value); \
+      RINGBUFFER_PUSH((channel).buffer); \
+      channel_notify(&(channel).reader); \
+   }while(0)
+
+/*!
+ * @brief Reads an item from a channel without blocking.
+ * @details The channel must not be empty. Polls the sender if it is blocked on the channel.
+ * @param channel The channel instance.
+ * @param var Lvalue which receives the item.
+ */
+#define CHANNEL_READ(channel, var) \
+   do{ \
+      (var) = RINGBUFFER_HEAD_VAL((channel).buffer); \
+      RINGBUFFER_POP((channel).buffer); \
+      channel_notify(&(channel).writer); \
+   }while(0)
+
+/*!
+ * @brief Sends an item, blocking the process while the channel is full.
+ * @details \a value is evaluated after the wait, so it must not depend on automatic
+ *          variables of the protothread.
+ * @param channel The channel instance.
+ * @param value The item to send.
+ */
+#define PROCESS_CHANNEL_SEND(channel, value) \
+   do{ \
+      PT_WAIT_UNTIL(&PROCESS_PT(), channel_wait(&(channel).writer, !CHANNEL_FULL(channel))); \
+      CHANNEL_WRITE(channel, value); \
+   }while(0)
+
+/*!
+ * @brief Receives an item, blocking the process while the channel is empty.
+ * @details \a var must survive the wait, i.e. be static or part of the process data.
+ * @param channel The channel instance.
+ * @param var Lvalue which receives the item.
+ */
+#define PROCESS_CHANNEL_RECV(channel, var) \
+   do{ \
+      PT_WAIT_UNTIL(&PROCESS_PT(), channel_wait(&(channel).reader, !CHANNEL_EMPTY(channel))); \
+      CHANNEL_READ(channel, var); \
+   }while(0)
+
+#endif /* CHANNEL_H_ */
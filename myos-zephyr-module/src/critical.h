@@ -57,6 +57,10 @@
             Critical sections should be kept as short as possible to minimize
             the time during which interrupts are disabled. This helps reduce
             the impact on the overall system responsiveness.
+
+            On Cortex-M4/M7 CONFIG_MYOS_CRITICAL_BASEPRI masks only the
+            interrupts up to CONFIG_MYOS_CRITICAL_BASEPRI_PRIO through BASEPRI,
+            more urgent ones keep running but must not call into MyOS.
 */
 
 
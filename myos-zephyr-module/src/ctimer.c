@@ -55,7 +55,13 @@ static void ctimer_timeout_handler(ptimer_t* ptimer)
    if( ctimer->callback )
    {
       PROCESS_CONTEXT_BEGIN(ctimer->context);
+#if defined(CONFIG_MYOS_WCET_CTIMER)
+      wcet_time_t start = wcet_now();
       ctimer->callback(ctimer->data);
+      wcet_count(&ctimer->wcet, WCET_PROBE_CTIMER, ctimer, wcet_now() - start);
+#else
+      ctimer->callback(ctimer->data);
+#endif
       PROCESS_CONTEXT_END();
    }
 }
@@ -63,10 +69,16 @@ static void ctimer_timeout_handler(ptimer_t* ptimer)
 
 
 void ctimer_start(ctimer_t *ctimer, timespan_t span, ctimer_callback_t callback, void *data)
+{
+   ctimer_start_slack(ctimer, span, 0, callback, data);
+}
+
+
+void ctimer_start_slack(ctimer_t *ctimer, timespan_t span, timespan_t slack, ctimer_callback_t callback, void *data)
 {
    ctimer->callback = callback;
    ctimer->data = data;
    ctimer->context = PROCESS_THIS();
-   ptimer_start(&(ctimer->ptimer), span, ctimer_timeout_handler);
+   ptimer_start_slack(&(ctimer->ptimer), span, slack, ctimer_timeout_handler);
 }
 
@@ -107,6 +107,9 @@ struct ctimer_t {
    process_t *context;  /*!< Context in which to invoke the callback function */
    ctimer_callback_t callback; /*!< Callback function to be called when process timer expires */
    void* data;
+#if defined(CONFIG_MYOS_WCET_CTIMER)
+   wcet_probe_t wcet;   /*!< Execution times of the callback */
+#endif
 };
 
 /*!
@@ -128,6 +131,24 @@ struct ctimer_t {
  */
 void ctimer_start(ctimer_t *ctimer, timespan_t span, ctimer_callback_t callback, void *data);
 
+/*!
+ * @brief Starts a callback timer whose callback may be delayed by up to a given slack.
+ * @details Works like ctimer_start(), but the ptimer engine may delay the expiry by up to the slack to
+ *          coalesce it with other timers, see ptimer_start_slack().
+ * @param[in] ctimer Pointer to the ctimer to start.
+ * @param[in] span Duration for the timer.
+ * @param[in] slack Allowed delay of the callback.
+ * @param[in] callback Function to call when the timer expires.
+ * @param[in] data Data to pass to the callback function.
+ *
+ * Usage Example:
+ * @code
+ *     ctimer_t my_ctimer;
+ *     ctimer_start_slack(&my_ctimer, 5000, 500, my_callback_function, my_data); // Fires between 5000 and 5500 units
+ * @endcode
+ */
+void ctimer_start_slack(ctimer_t *ctimer, timespan_t span, timespan_t slack, ctimer_callback_t callback, void *data);
+
 /*!
  * @brief Initializes the callback timer module.
  * @details This macro serves as an initializer for the callback timer (ctimer) system in MyOS.
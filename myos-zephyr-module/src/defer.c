@@ -0,0 +1,90 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "defer.h"
+
+#if defined(CONFIG_MYOS_DEFER)
+
+RINGBUFFER_T(defer_queue) defer_queue;
+
+
+bool myos_defer(defer_function_t function, void *arg)
+{
+   bool queued = false;
+
+   // Serializes the producers, the MyOS thread and ISRs of any level.
+   CRITICAL_SECTION_BEGIN();
+
+   if(!RINGBUFFER_SPSC_FULL(defer_queue))
+   {
+      defer_t *defer = RINGBUFFER_SPSC_TAIL_PTR(defer_queue);
+
+      defer->function = function;
+      defer->arg = arg;
+      RINGBUFFER_SPSC_PUSH(defer_queue);
+      queued = true;
+   }
+
+   CRITICAL_SECTION_END();
+
+   if(!queued)
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.deferqueue = 1;
+#endif
+      return false;
+   }
+
+   myos_wakeup();
+
+   return true;
+}
+
+
+void defer_run(void)
+{
+   // Tasklets queued by the tasklets themselves wait for the next pass.
+   size_t count = RINGBUFFER_SPSC_COUNT(defer_queue);
+
+   while(count--)
+   {
+      // Release the slot before the call, the function may queue a tasklet again.
+      defer_t defer = *RINGBUFFER_SPSC_HEAD_PTR(defer_queue);
+
+      RINGBUFFER_SPSC_POP(defer_queue);
+      defer.function(defer.arg);
+   }
+}
+
+
+void defer_module_init(void)
+{
+   RINGBUFFER_SPSC_INIT(defer_queue);
+}
+
+#endif /* CONFIG_MYOS_DEFER */
@@ -0,0 +1,126 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file defer.h
+ *
+ * @brief Run-to-completion tasklets drained by the scheduler loop.
+ * @details Small job-style work does not need a protothread. A ctimer for example is
+ *          expired by the ptimer process and then switches into its owner process only to
+ *          call a function. myos_defer() instead queues a plain function call which
+ *          process_run() executes before it handles polls and events. A tasklet has no
+ *          protothread state, takes no event record and is found without any list
+ *          traversal, so an ISR can hand over its bottom half with minimal latency.
+ *
+ *          myos_defer() may be called from ISRs, from the MyOS thread and from tasklets.
+ *          process_run() runs the tasklets which were queued when it started, tasklets
+ *          queued meanwhile run in the next pass. A tasklet runs in the MyOS thread
+ *          outside of any process, so PROCESS_THIS() is not valid and it must not block.
+ *
+ * Usage Example:
+ * @code
+ *     static void sensor_bottom_half(void *arg)
+ *     {
+ *        sensor_read(arg);
+ *     }
+ *
+ *     void sensor_isr(const void *dev)
+ *     {
+ *        myos_defer(sensor_bottom_half, (void*)dev);
+ *     }
+ * @endcode
+ */
+
+#ifndef DEFER_H_
+#define DEFER_H_
+
+#include "myos.h"
+#include "ringbuffer.h"
+
+#if defined(CONFIG_MYOS_DEFER)
+
+/*!
+ * @typedef defer_function_t
+ * @brief Function type of a tasklet.
+ */
+typedef void (*defer_function_t)(void *arg);
+
+/*!
+ * @struct defer_t
+ * @brief Queued tasklet.
+ *
+ * @var defer_t::function
+ *      The function to call.
+ * @var defer_t::arg
+ *      Argument passed to the function.
+ */
+typedef struct {
+   defer_function_t function;
+   void *arg;
+}defer_t;
+
+/*!
+ * @brief Lock-free queue of the pending tasklets.
+ * @details The producers are serialized by a critical section, the only consumer is
+ *          defer_run(). The size is CONFIG_MYOS_DEFER_QUEUE_SIZE.
+ */
+RINGBUFFER_SPSC_TYPEDEF(defer_queue,defer_t,CONFIG_MYOS_DEFER_QUEUE_SIZE);
+
+extern RINGBUFFER_T(defer_queue) defer_queue;
+
+/*!
+ * @brief Queues a function to be called by the MyOS thread.
+ * @details Wakes up the MyOS thread. Can be called from ISRs.
+ * @param[in] function Function to call.
+ * @param[in] arg Argument passed to the function.
+ * @return True if the tasklet was queued, False if the queue is full.
+ */
+bool myos_defer(defer_function_t function, void *arg);
+
+/*!
+ * @brief Runs the tasklets which are queued right now.
+ * @details Called by process_run() and process_run_batch().
+ */
+void defer_run(void);
+
+/*!
+ * @brief Number of queued tasklets.
+ */
+static inline size_t defer_pending(void)
+{
+   return RINGBUFFER_SPSC_COUNT(defer_queue);
+}
+
+/*!
+ * @brief Initializes the tasklet queue.
+ */
+void defer_module_init(void);
+
+#endif /* CONFIG_MYOS_DEFER */
+
+#endif /* DEFER_H_ */
@@ -48,6 +48,160 @@
 extern bool process_deliver_event(process_event_t *evt);
 
 
+#if defined(CONFIG_MYOS_ETIMER_BATCH)
+/* etimer_t::batched */
+#define ETIMER_BATCH_NONE       0   /* Not in a batch */
+#define ETIMER_BATCH_QUEUED     1   /* Its event is delivered with the batch */
+#define ETIMER_BATCH_DETACHED   2   /* Still linked, but its event has been posted on its own */
+
+/* Posted to etimer_process once per batch, the event data is the first etimer of the batch. */
+#define ETIMER_EVENT_BATCH      PROCESS_EVENT_TIMEOUT
+
+/* Last etimer of the open batch and the ptimer pass which has opened it. */
+static etimer_t *etimer_batch_tail;
+static uint8_t etimer_batch_sweep;
+
+/* Expired etimers whose batch did not fit into the event queue, delivered when etimer_process is polled. */
+static etimer_t *etimer_polled_head;
+static etimer_t *etimer_polled_tail;
+
+PROCESS(etimer_process, etimer_process);
+
+
+/*!
+ * @brief Posts the event of an etimer on its own, as without CONFIG_MYOS_ETIMER_BATCH.
+ */
+static void etimer_post_copy(process_event_t *evt)
+{
+   PROCESS_CONTEXT_BEGIN(evt->from);
+   process_post(evt->to, evt->id, evt->data);
+   PROCESS_CONTEXT_END();
+}
+
+
+/*!
+ * @brief Appends an expired etimer to the open batch.
+ * @details The first etimer expiring in a ptimer pass posts a single event to etimer_process, which
+ *          takes the place of the events of all etimers expiring in the same pass. The batch is closed
+ *          with the pass, an etimer expiring later opens a new batch behind the events posted
+ *          meanwhile. If the event queue is full, the etimer is delivered when etimer_process is
+ *          polled instead. An etimer which is still linked into a batch falls back to a copy of its
+ *          event.
+ * @param[in] etimer The expired etimer.
+ */
+static void etimer_batch_append(etimer_t *etimer)
+{
+   if(etimer->batched != ETIMER_BATCH_NONE)
+   {
+      etimer_post_copy(&etimer->evt);
+      return;
+   }
+
+   etimer->batched = ETIMER_BATCH_QUEUED;
+   etimer->batchnext = NULL;
+
+   if(etimer_batch_tail && etimer_batch_sweep == ptimer_sweep)
+   {
+      etimer_batch_tail->batchnext = etimer;
+      etimer_batch_tail = etimer;
+      return;
+   }
+
+   if(process_post(&etimer_process, ETIMER_EVENT_BATCH, etimer))
+   {
+      etimer_batch_tail = etimer;
+      etimer_batch_sweep = ptimer_sweep;
+      return;
+   }
+
+   etimer_batch_tail = NULL;
+
+   if(etimer_polled_tail)
+   {
+      etimer_polled_tail->batchnext = etimer;
+   }
+   else
+   {
+      etimer_polled_head = etimer;
+   }
+   etimer_polled_tail = etimer;
+
+   process_poll(&etimer_process);
+}
+
+
+/*!
+ * @brief Delivers the events of a batch of expired etimers by reference.
+ * @details Each etimer leaves the batch before its event is delivered, so it can expire into a
+ *          new batch while the event is handled. An etimer started anew before its event has been
+ *          delivered posts the pending event on its own and is skipped here.
+ * @param[in] etimer The first etimer of the batch.
+ */
+static void etimer_batch_deliver(etimer_t *etimer)
+{
+   while(etimer)
+   {
+      etimer_t *next = etimer->batchnext;
+      bool queued = etimer->batched == ETIMER_BATCH_QUEUED;
+
+      // Delivered batches are closed, ptimer_sweep comes round to their pass again.
+      if(etimer == etimer_batch_tail)
+      {
+         etimer_batch_tail = NULL;
+      }
+
+      etimer->batched = ETIMER_BATCH_NONE;
+      if(queued)
+      {
+         process_deliver_event(&etimer->evt);
+      }
+      etimer = next;
+   }
+}
+
+
+PROCESS_THREAD(etimer_process)
+{
+   PROCESS_BEGIN();
+
+   while(1)
+   {
+      PROCESS_WAIT_ANY_EVENT();
+
+      if(PROCESS_EVENT_ID() == ETIMER_EVENT_BATCH)
+      {
+         etimer_batch_deliver(PROCESS_EVENT_DATA());
+      }
+      else if(PROCESS_EVENT_ID() == PROCESS_EVENT_POLL)
+      {
+         etimer_t *etimer = etimer_polled_head;
+
+         etimer_polled_head = NULL;
+         etimer_polled_tail = NULL;
+         etimer_batch_deliver(etimer);
+      }
+   }
+
+   PROCESS_END();
+}
+
+
+void etimer_module_init(void)
+{
+   ptimer_module_init();
+
+   etimer_batch_tail = NULL;
+   etimer_polled_head = NULL;
+   etimer_polled_tail = NULL;
+
+   if(!PROCESS_IS_RUNNING(&etimer_process))
+   {
+      process_start(&etimer_process, NULL);
+   }
+}
+#endif
+
+
 /*!
  * @brief Handler for event timer expiration.
  * @details This function serves as the timeout handler for event timers (etimers) in MyOS. It's invoked when an etimer expires.
@@ -66,7 +220,15 @@ static void etimer_timeout_handler(ptimer_t* ptimer)
    DBG("etimer : timeout handler called\n");
    process_event_t *evt = &((etimer_t*)ptimer)->evt;
 
-#if defined(CONFIG_MYOS_ETIMER_DEFER_EVENTS)
+#if defined(CONFIG_MYOS_ETIMER_DEFER_EVENTS) && defined(CONFIG_MYOS_PROC_EVENT_EDF)
+   PROCESS_CONTEXT_BEGIN(evt->from);
+   process_post_deadline(evt->to, evt->id, evt->data,
+                         timer_timestamp_stop(&ptimer->timer) + ((etimer_t*)ptimer)->slack);
+   PROCESS_CONTEXT_END();
+#elif defined(CONFIG_MYOS_ETIMER_BATCH)
+   ARG_UNUSED(evt);
+   etimer_batch_append((etimer_t*)ptimer);
+#elif defined(CONFIG_MYOS_ETIMER_DEFER_EVENTS)
    PROCESS_CONTEXT_BEGIN(evt->from);
    process_post(evt->to, evt->id, evt->data);
    PROCESS_CONTEXT_END();
@@ -79,12 +241,55 @@ static void etimer_timeout_handler(ptimer_t* ptimer)
 
 
 void etimer_start(etimer_t *etimer, timespan_t span, process_t *to, process_event_id_t evtid, void *data)
+{
+   etimer_start_slack(etimer, span, 0, to, evtid, data);
+}
+
+
+void etimer_start_slack(etimer_t *etimer, timespan_t span, timespan_t slack, process_t *to, process_event_id_t evtid, void *data)
+{
+#if defined(CONFIG_MYOS_ETIMER_BATCH)
+   // The pending event is posted as it was, the batch then skips the etimer. Otherwise the etimer
+   // is armed outside of any batch.
+   if(etimer->batched == ETIMER_BATCH_QUEUED)
+   {
+      etimer->batched = ETIMER_BATCH_DETACHED;
+      etimer_post_copy(&etimer->evt);
+   }
+   else if(etimer->batched != ETIMER_BATCH_DETACHED)
+   {
+      etimer->batched = ETIMER_BATCH_NONE;
+   }
+#endif
+   etimer->slack = slack;
+   etimer->evt.id = evtid;
+   etimer->evt.data = data;
+   etimer->evt.from = PROCESS_THIS();
+   etimer->evt.to = to;
+   ptimer_start_slack(&(etimer->ptimer), span, slack, etimer_timeout_handler);
+}
+
+
+/*!
+ * @brief Callback of high resolution event timers.
+ * @details Runs in the rtimer interrupt, so the event is handed over with process_post_isr().
+ * @param[in] data Pointer to the high resolution etimer.
+ */
+static void etimer_hr_timeout_handler(void *data)
+{
+   process_event_t *evt = &((etimer_hr_t*)data)->evt;
+
+   process_post_isr(evt->to, evt->id, evt->data);
+}
+
+
+bool etimer_hr_start(etimer_hr_t *etimer, rtimer_timespan_t span, process_t *to, process_event_id_t evtid, void *data)
 {
    etimer->evt.id = evtid;
    etimer->evt.data = data;
    etimer->evt.from = PROCESS_THIS();
    etimer->evt.to = to;
-   ptimer_start(&(etimer->ptimer), span, etimer_timeout_handler);
+   return rtimer_start(&etimer->rtimer, span, etimer_hr_timeout_handler, etimer);
 }
 
 
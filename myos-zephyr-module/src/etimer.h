@@ -75,6 +75,14 @@
  *      The underlying process timer.
  * @var etimer_t::evt
  *      The event to be posted when the timer expires.
+ * @var etimer_t::slack
+ *      Time by which the event may be late, see etimer_start_slack().
+ * @var etimer_t::batchnext
+ *      (Optional, with CONFIG_MYOS_ETIMER_BATCH) Next expired etimer of the same batch.
+ * @var etimer_t::batched
+ *      (Optional, with CONFIG_MYOS_ETIMER_BATCH) Non-zero while the etimer is linked into a batch
+ *      whose delivery is pending. Cleared when the etimer is started outside of a batch, like
+ *      ptimer_t::running it relies on the etimer being zero initialised before its first start.
  *
  * Usage Example:
  * @code
@@ -85,9 +93,14 @@
  *     }
  * @endcode
  */
-typedef struct {
+typedef struct etimer_t {
     ptimer_t ptimer;
     process_event_t evt;
+    timespan_t slack;
+#if defined(CONFIG_MYOS_ETIMER_BATCH)
+    struct etimer_t *batchnext;
+    uint8_t batched;
+#endif
 } etimer_t;
 
 
@@ -97,6 +110,7 @@ typedef struct {
  * @details This macro is a wrapper for initializing the process timer (ptimer) module, which is a prerequisite for etimers in MyOS.
  *          Invoking this macro ensures that the underlying ptimer system is set up, thereby enabling the correct functionality
  *          of etimers. This initialization should be called at the start of the system to ensure that event timers are ready for use.
+ *          With CONFIG_MYOS_ETIMER_BATCH it also starts the process delivering the batches of expired etimers.
  *
  * Usage Example:
  * @code
@@ -104,7 +118,11 @@ typedef struct {
  *     etimer_module_init(); // Initialize the event timer module
  * @endcode
  */
+#if defined(CONFIG_MYOS_ETIMER_BATCH)
+void etimer_module_init(void);
+#else
 #define etimer_module_init() ptimer_module_init()
+#endif
 
 
 /*!
@@ -126,6 +144,28 @@ typedef struct {
  */
 void etimer_start(etimer_t *etimer, timespan_t span, process_t *to, process_event_id_t evtid, void *data);
 
+/*!
+ * @brief Starts an event timer whose event may be delivered late by up to a given slack.
+ * @details Works like etimer_start(), but the ptimer engine may delay the expiry by up to the slack to
+ *          coalesce it with other timers, see ptimer_start_slack(). With CONFIG_MYOS_PROC_EVENT_EDF and
+ *          CONFIG_MYOS_ETIMER_DEFER_EVENTS the event is posted with process_post_deadline() and a deadline of
+ *          the timer stop plus the slack, so of several etimers expiring together the ones with the least slack
+ *          are delivered first. etimer_start() uses a slack of 0.
+ * @param[in] etimer Pointer to the event timer.
+ * @param[in] span Duration for the timer.
+ * @param[in] slack Allowed lateness of the event.
+ * @param[in] to Destination process for the event.
+ * @param[in] evtid Event ID.
+ * @param[in] data Data to be passed along with the event.
+ *
+ * Usage Example:
+ * @code
+ *     etimer_t housekeeping;
+ *     etimer_start_slack(&housekeeping, 1000, 200, &my_process, MY_EVENT, NULL);
+ * @endcode
+ */
+void etimer_start_slack(etimer_t *etimer, timespan_t span, timespan_t slack, process_t *to, process_event_id_t evtid, void *data);
+
 /*!
  * @brief Restarts an event timer.
  * @details This macro is used to restart an existing event timer (etimer) in MyOS. It resets the underlying
@@ -218,4 +258,101 @@ void etimer_start(etimer_t *etimer, timespan_t span, process_t *to, process_even
       PROCESS_WAIT_EVENT(PROCESS_EVENT_CONTINUE); \
    }while(0)
 
+
+/*!
+ * @struct etimer_hr_t
+ * @brief High resolution event timer.
+ * @details Works like an etimer, but the deadline is counted in rtimer ticks (RTIMER_TICKS_PER_SEC)
+ *          instead of timestamp ticks. It is multiplexed with the other rtimers on the rtimer
+ *          hardware alarm, see CONFIG_MYOS_RTIMER_QUEUE_SIZE. The event is posted with
+ *          process_post_isr() from the rtimer interrupt and delivered as a normal process event,
+ *          so neither a callback in ISR context nor the rtimer lock is needed.
+ *
+ * @var etimer_hr_t::rtimer
+ *      The underlying rtimer.
+ * @var etimer_hr_t::evt
+ *      The event to be posted when the timer expires.
+ *
+ * Usage Example:
+ * @code
+ *     static etimer_hr_t gap;
+ *     etimer_hr_start(&gap, 250 * RTIMER_TICKS_PER_SEC / 1000000, PROCESS_THIS(), PROCESS_EVENT_TIMEOUT, NULL);
+ * @endcode
+ */
+typedef struct {
+    rtimer_t rtimer;
+    process_event_t evt;
+} etimer_hr_t;
+
+/*!
+ * @brief Starts a high resolution event timer.
+ * @param[in] etimer Pointer to the event timer.
+ * @param[in] span Duration for the timer in rtimer ticks.
+ * @param[in] to Destination process for the event.
+ * @param[in] evtid Event ID.
+ * @param[in] data Data to be passed along with the event.
+ * @return True if the timer was started, False if CONFIG_MYOS_RTIMER_QUEUE_SIZE rtimers are pending already.
+ */
+bool etimer_hr_start(etimer_hr_t *etimer, rtimer_timespan_t span, process_t *to, process_event_id_t evtid, void *data);
+
+/*!
+ * @brief Restarts a high resolution event timer from now, see etimer_restart().
+ * @param[in] etimerptr Pointer to the etimer to be restarted.
+ */
+#define etimer_hr_restart(etimerptr)                    rtimer_restart(&(etimerptr)->rtimer)
+
+/*!
+ * @brief Resets a high resolution event timer for another cycle, see etimer_reset().
+ * @param[in] etimerptr Pointer to the etimer to be reset.
+ */
+#define etimer_hr_reset(etimerptr)                      rtimer_reset(&(etimerptr)->rtimer)
+
+/*!
+ * @brief Stops a high resolution event timer.
+ * @param[in] etimerptr Pointer to the etimer to be stopped.
+ */
+#define etimer_hr_stop(etimerptr)                       rtimer_stop(&(etimerptr)->rtimer)
+
+/*!
+ * @brief Checks if a high resolution event timer has expired.
+ * @param[in] etimerptr Pointer to the etimer being checked.
+ */
+#define etimer_hr_expired(etimerptr)                    rtimer_expired(&(etimerptr)->rtimer)
+
+/*!
+ * @brief Wait condition of PROCESS_SLEEP_HR().
+ * @details Starts the timer on the first call. While all rtimer queue slots are taken, the current
+ *          process posts itself a PROCESS_EVENT_CONTINUE to try again on its next run.
+ * @param[in] etimer Pointer to the high resolution etimer, evt.to must be NULL before the first call.
+ * @param[in] span Duration for the sleep period in rtimer ticks.
+ * @return True once the timer has fired.
+ */
+static inline bool etimer_hr_sleep(etimer_hr_t *etimer, rtimer_timespan_t span)
+{
+   if( !etimer->evt.to )
+   {
+      if( !etimer_hr_start(etimer, span, PROCESS_THIS(), PROCESS_EVENT_CONTINUE, NULL) )
+      {
+         etimer->evt.to = NULL;
+         process_post(PROCESS_THIS(), PROCESS_EVENT_CONTINUE, NULL);
+      }
+      return false;
+   }
+
+   return !rtimer_is_pending(&etimer->rtimer);
+}
+
+/*!
+ * @brief Suspends the calling process for a specified number of rtimer ticks.
+ * @details Works like PROCESS_SLEEP(), with rtimer resolution. While all rtimer queue slots are
+ *          taken, the process yields until one is free.
+ * @param[in] etimerptr Pointer to a high resolution etimer used for the sleep operation.
+ * @param[in] span Duration for the sleep period in rtimer ticks.
+ */
+#define PROCESS_SLEEP_HR(etimerptr,span) \
+   do{ \
+      (etimerptr)->evt.to = NULL; \
+      PT_WAIT_UNTIL(&PROCESS_PT(), etimer_hr_sleep(etimerptr, span)); \
+   }while(0)
+
 #endif /* ETIMER_H_ */
@@ -1,21 +1,162 @@
 #include "hash.h"
 
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(CONFIG_MYOS_HASH_CRC32_HW)
+#include <soc.h>
+#include <stm32_ll_bus.h>
+#include <stm32_ll_crc.h>
+#include "critical.h"
+#endif
+
 uint32_t hash_sdbm(uint32_t seed, void *data, size_t size)
 {
-	int idx;
+	size_t idx;
 
 	for(idx = 0; idx < size; idx++)
 	{
-		seed = hash_sdbm_acc(seed,((uint8_t*)data)[idx]);		
+		seed = hash_sdbm_acc(seed,((uint8_t*)data)[idx]);
+	}
+
+	return seed;
+}
+
+
+uint32_t hash_fnv1a(uint32_t seed, const void *data, size_t size)
+{
+	const uint8_t *bytes = data;
+
+	for(size_t idx = 0; idx < size; idx++)
+	{
+		seed = hash_fnv1a_acc(seed, bytes[idx]);
+	}
+
+	return seed;
+}
+
+
+uint32_t hash_murmur3(uint32_t seed, const void *data, size_t size)
+{
+	const uint8_t *bytes = data;
+	uint32_t word;
+	size_t idx;
+
+	for(idx = 0; idx + sizeof(word) <= size; idx += sizeof(word))
+	{
+		memcpy(&word, &bytes[idx], sizeof(word));
+		seed = hash_murmur3_acc(seed, word);
+	}
+
+	// The tail is mixed like a word, but without the rotation of the hash.
+	if(idx < size)
+	{
+		word = 0;
+		memcpy(&word, &bytes[idx], size - idx);
+		word *= 0xcc9e2d51u;
+		word = (word << 15) | (word >> 17);
+		word *= 0x1b873593u;
+		seed ^= word;
+	}
+
+	return hash_murmur3_fmix(seed ^ (uint32_t)size);
+}
+
+
+/* CRC of a nibble in the top bits, the table costs 64 bytes instead of 1 KiB. */
+static const uint32_t hash_crc32_nibble[16] = {
+	0x00000000u, 0x04C11DB7u, 0x09823B6Eu, 0x0D4326D9u,
+	0x130476DCu, 0x17C56B6Bu, 0x1A864DB2u, 0x1E475005u,
+	0x2608EDB8u, 0x22C9F00Fu, 0x2F8AD6D6u, 0x2B4BCB61u,
+	0x350C9B64u, 0x31CD86D3u, 0x3C8EA00Au, 0x384FBDBDu,
+};
+
+uint32_t hash_crc32_acc(uint32_t crc, uint32_t word)
+{
+	crc ^= word;
+	for(int nibble = 0; nibble < 8; nibble++)
+	{
+		crc = (crc << 4) ^ hash_crc32_nibble[crc >> 28];
 	}
 
-    	return seed;
+	return crc;
 }
 
 
+#if defined(CONFIG_MYOS_HASH_CRC32_HW)
+/*
+ * The CRC unit is shared by all callers, so it is used with the interrupts locked. Without
+ * the INIT register (STM32F4) it always starts from HASH_CRC32_SEED.
+ */
+static bool hash_crc32_hw(uint32_t seed, const uint8_t *bytes, size_t size, uint32_t *crc)
+{
+	static bool clock_enabled;
+	uint32_t word;
+	size_t idx;
+
+#if !defined(CRC_INIT_INIT)
+	if(seed != HASH_CRC32_SEED)
+	{
+		return false;
+	}
+#endif
+
+	CRITICAL_SECTION_BEGIN();
+
+	if(!clock_enabled)
+	{
+		LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CRC);
+		clock_enabled = true;
+	}
+
+#if defined(CRC_INIT_INIT)
+	LL_CRC_SetInitialData(CRC, seed);
+#endif
+	LL_CRC_ResetCRCCalculationUnit(CRC);
+
+	for(idx = 0; idx + sizeof(word) <= size; idx += sizeof(word))
+	{
+		memcpy(&word, &bytes[idx], sizeof(word));
+		LL_CRC_FeedData32(CRC, word);
+	}
+	if(idx < size)
+	{
+		word = 0;
+		memcpy(&word, &bytes[idx], size - idx);
+		LL_CRC_FeedData32(CRC, word);
+	}
+	*crc = LL_CRC_ReadData32(CRC);
 
+	CRITICAL_SECTION_END();
 
+	return true;
+}
+#endif
 
+uint32_t hash_crc32(uint32_t seed, const void *data, size_t size)
+{
+	const uint8_t *bytes = data;
+	uint32_t word;
+	size_t idx;
 
+#if defined(CONFIG_MYOS_HASH_CRC32_HW)
+	if(hash_crc32_hw(seed, bytes, size, &word))
+	{
+		return word;
+	}
+#endif
 
+	for(idx = 0; idx + sizeof(word) <= size; idx += sizeof(word))
+	{
+		memcpy(&word, &bytes[idx], sizeof(word));
+		seed = hash_crc32_acc(seed, word);
+	}
+	if(idx < size)
+	{
+		word = 0;
+		memcpy(&word, &bytes[idx], size - idx);
+		seed = hash_crc32_acc(seed, word);
+	}
 
+	return seed;
+}
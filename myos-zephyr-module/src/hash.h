@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#define HASH_FNV1A_SEED     2166136261u
+#define HASH_FNV1A_PRIME    16777619u
+
+#define HASH_CRC32_SEED     0xFFFFFFFFu
+#define HASH_CRC32_POLY     0x04C11DB7u
+
 /*!
     \brief      Accumulates a single byte into an ongoing SDBM hash calculation.
 
@@ -36,7 +42,7 @@
     \return         The updated hash value after accumulating the byte.
 */
 #define hash_sdbm_acc(hash,byte) \
-	(byte + (hash << 6) + (hash << 16) - hash)
+	((byte) + ((hash) << 6) + ((hash) << 16) - (hash))
 
 /*!
     \brief      Calculates a hash value using the SDBM algorithm.
@@ -73,6 +79,118 @@
 */
 uint32_t hash_sdbm(uint32_t seed, void *data, size_t size);
 
+/*!
+    \brief      Accumulates a single byte into an ongoing FNV-1a hash calculation.
+
+    \details    XORs the byte into the hash and multiplies by the 32 bit FNV prime.
+                Start with HASH_FNV1A_SEED. Better distributed than SDBM for short
+                keys at the cost of one multiplication per byte.
+
+    \param hash     The current hash value.
+    \param byte     The byte to be accumulated into the hash.
+
+    \return         The updated hash value after accumulating the byte.
+*/
+#define hash_fnv1a_acc(hash,byte) \
+	(((hash) ^ (uint8_t)(byte)) * HASH_FNV1A_PRIME)
+
+/*!
+    \brief      Calculates a 32 bit FNV-1a hash of a data block.
+
+    \param seed     HASH_FNV1A_SEED, or the result of a previous call to continue.
+    \param data     Pointer to the data block to be hashed.
+    \param size     Size of the data block in bytes.
+
+    \return         The computed hash value.
+*/
+uint32_t hash_fnv1a(uint32_t seed, const void *data, size_t size);
+
+/*!
+    \brief      Accumulates a 32 bit word into an ongoing Murmur3 hash calculation.
+
+    \details    The word mixing step of MurmurHash3_x86_32. A hash built from words
+                only needs hash_murmur3_fmix() at the end to get full avalanche.
+
+    \param hash     The current hash value, initially the seed.
+    \param word     The word to be accumulated into the hash.
+
+    \return         The updated hash value after accumulating the word.
+*/
+static inline uint32_t hash_murmur3_acc(uint32_t hash, uint32_t word)
+{
+	word *= 0xcc9e2d51u;
+	word = (word << 15) | (word >> 17);
+	word *= 0x1b873593u;
+
+	hash ^= word;
+	hash = (hash << 13) | (hash >> 19);
+	return hash * 5 + 0xe6546b64u;
+}
+
+/*!
+    \brief      The Murmur3 finalizer, every input bit affects every output bit.
+
+    \details    Also a cheap and well distributed hash of a single 32 bit key like
+                an id or an address.
+
+    \param hash     The value to be finalized.
+
+    \return         The finalized hash value.
+*/
+static inline uint32_t hash_murmur3_fmix(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/*!
+    \brief      Calculates the MurmurHash3_x86_32 hash of a data block.
+
+    \details    Processes the data a word at a time, unaligned data is fine. The
+                result equals the reference implementation on little endian targets.
+
+    \param seed     The initial seed value for the hash computation.
+    \param data     Pointer to the data block to be hashed.
+    \param size     Size of the data block in bytes.
+
+    \return         The computed hash value.
+*/
+uint32_t hash_murmur3(uint32_t seed, const void *data, size_t size);
+
+/*!
+    \brief      Accumulates a 32 bit word into an ongoing CRC32 calculation.
+
+    \details    The CRC has the polynomial HASH_CRC32_POLY, is not reflected, has no
+                final XOR and takes the data as 32 bit words, MSB first. It is the
+                native mode of the STM32 CRC unit, so hash_crc32() can use it with
+                CONFIG_MYOS_HASH_CRC32_HW. Start with HASH_CRC32_SEED.
+
+    \param crc      The current CRC value.
+    \param word     The word to be accumulated into the CRC.
+
+    \return         The updated CRC value after accumulating the word.
+*/
+uint32_t hash_crc32_acc(uint32_t crc, uint32_t word);
+
+/*!
+    \brief      Calculates the CRC32 of a data block, see hash_crc32_acc().
+
+    \details    The data is read in little endian words, a partial last word is
+                padded with zero bytes. With CONFIG_MYOS_HASH_CRC32_HW the STM32 CRC
+                unit computes it, otherwise a tiny nibble table.
+
+    \param seed     HASH_CRC32_SEED, or the result of a previous call to continue.
+    \param data     Pointer to the data block to be hashed.
+    \param size     Size of the data block in bytes.
+
+    \return         The computed CRC value.
+*/
+uint32_t hash_crc32(uint32_t seed, const void *data, size_t size);
+
 
 
 
@@ -26,38 +26,47 @@
    OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include "hashtable.h"
 
-/*!
-    \file       timestamp_arch.h
 
-    \brief      Architecture depending part of time stamp implementation
+void hashtable_insert(hashtable_node_t **buckets, size_t mask, hashtable_node_t *node, uint32_t hash)
+{
+   hashtable_node_t **head = &buckets[hash & mask];
 
-    \details    Provides the architecture dependent part of time stamp implementation
-                for architecture hosted.
+   node->hash = hash;
+   node->next = *head;
+   *head = node;
+}
 
-                Hosted means that the myos runs in an own process on top of a host
-                operating system.
 
-*/
-
-
-#ifndef TIMESTAMP_ARCH_H_
-#define TIMESTAMP_ARCH_H_
-
-#include <stdint.h>
-#include "utils.h"
- 
+hashtable_node_t* hashtable_find(hashtable_node_t **buckets, size_t mask, uint32_t hash, hashtable_match_t match, const void *key)
+{
+   hashtable_node_t *node;
 
-#define TIMESTAMP_ARCH_TICKS_PER_SEC 1000
+   for(node = buckets[hash & mask]; node != NULL; node = node->next)
+   {
+      if(node->hash == hash && (match == NULL || match(node, key)))
+      {
+         break;
+      }
+   }
 
-typedef UTILS_UINT(CONFIG_MYOS_TIMESTAMP_SIZE) timestamp_arch_t;
+   return node;
+}
 
-/* Safe wrap-around difference */
-#define TIMESTAMP_ARCH_DIFF(a, b) \
-    ((UTILS_INT(CONFIG_MYOS_TIMESTAMP_SIZE))((timestamp_arch_t)(a) - (timestamp_arch_t)(b)))
 
+bool hashtable_remove(hashtable_node_t **buckets, size_t mask, hashtable_node_t *node)
+{
+   hashtable_node_t **link;
 
-#define timestamp_arch_module_init() do{}while(0)
-timestamp_arch_t timestamp_arch_now(void);
+   for(link = &buckets[node->hash & mask]; *link != NULL; link = &(*link)->next)
+   {
+      if(*link == node)
+      {
+         *link = node->next;
+         return true;
+      }
+   }
 
-#endif /* TIMESTAMP_ARCH_H_ */
+   return false;
+}
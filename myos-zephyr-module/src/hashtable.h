@@ -0,0 +1,169 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file hashtable.h
+ *
+ * @brief Fixed capacity, intrusive chained hash table.
+ * @details The table is an array of bucket heads of a power of two size, declared with
+ *          HASHTABLE_TYPEDEF() like a ringbuffer or an itempool. It allocates nothing, the
+ *          entries embed a hashtable_node_t as their first member with HASHTABLE_NODE_TYPE
+ *          and are chained into the bucket selected by the low bits of their hash. The node
+ *          keeps the full hash, so a lookup only calls the key comparison for entries with
+ *          the same hash and removing an entry needs no key at all.
+ *
+ *          The table does not know the keys. The caller computes the hash, e.g. with
+ *          hash_murmur3() or hash_fnv1a(), and passes a match function which compares the
+ *          key of an entry. Keys which are unique 32 bit numbers, like ids, need no match
+ *          function, hash_murmur3_fmix() of the key is a unique and well spread hash. With
+ *          at most as many entries as buckets a lookup is O(1) on average.
+ *
+ * Usage Example:
+ * @code
+ *     typedef struct {
+ *        HASHTABLE_NODE_TYPE;
+ *        const char *name;
+ *        int value;
+ *     } sensor_t;
+ *
+ *     HASHTABLE_TYPEDEF(sensors, 32);
+ *     static HASHTABLE_T(sensors) sensors;
+ *
+ *     static bool sensor_match(const hashtable_node_t *node, const void *key)
+ *     {
+ *        return strcmp(((const sensor_t*)node)->name, key) == 0;
+ *     }
+ *
+ *     static uint32_t sensor_hash(const char *name)
+ *     {
+ *        return hash_murmur3(0, name, strlen(name));
+ *     }
+ *
+ *     HASHTABLE_INIT(sensors);
+ *     HASHTABLE_INSERT(sensors, &sensor, sensor_hash(sensor.name));
+ *     sensor_t *found = HASHTABLE_FIND(sensors, sensor_hash("temp"), sensor_match, "temp");
+ *     HASHTABLE_REMOVE(sensors, found);
+ * @endcode
+ */
+
+#ifndef HASHTABLE_H_
+#define HASHTABLE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "hash.h"
+
+typedef struct hashtable_node_t {
+   struct hashtable_node_t *next;
+   uint32_t hash;
+} hashtable_node_t;
+
+/**
+ * @brief Compares the key of a table entry, returns true if it matches.
+ */
+typedef bool (*hashtable_match_t)(const hashtable_node_t *node, const void *key);
+
+#define HASHTABLE_NODE_TYPE hashtable_node_t hashtable_node
+
+/**
+ * @brief Declares a hash table type with the given number of buckets, a power of two.
+ */
+#define HASHTABLE_TYPEDEF(name,size) \
+   typedef struct { \
+      hashtable_node_t *buckets[size]; \
+      size_t count; \
+      _Static_assert((size) > 0 && ((size) & ((size) - 1)) == 0, "hashtable size must be a power of two"); \
+   }name##_hashtable_t
+
+#define HASHTABLE_T(name) \
+   name##_hashtable_t
+
+#define HASHTABLE_BUCKETS(hashtable) \
+   ((hashtable).buckets)
+
+#define HASHTABLE_SIZE(hashtable) \
+   (sizeof(HASHTABLE_BUCKETS(hashtable))/sizeof(*HASHTABLE_BUCKETS(hashtable)))
+
+#define HASHTABLE_MASK(hashtable) \
+   (HASHTABLE_SIZE(hashtable) - 1)
+
+#define HASHTABLE_COUNT(hashtable) \
+   ((hashtable).count)
+
+#define HASHTABLE_EMPTY(hashtable) \
+   (HASHTABLE_COUNT(hashtable) == 0)
+
+#define HASHTABLE_INIT(hashtable) \
+   do{ \
+      memset(HASHTABLE_BUCKETS(hashtable), 0, sizeof(HASHTABLE_BUCKETS(hashtable))); \
+      HASHTABLE_COUNT(hashtable) = 0; \
+   }while(0)
+
+/**
+ * @brief Adds an entry with the given hash. An entry must not be in a table twice.
+ */
+#define HASHTABLE_INSERT(hashtable,nodeptr,hash) \
+   do{ \
+      hashtable_insert(HASHTABLE_BUCKETS(hashtable), HASHTABLE_MASK(hashtable), \
+                       (hashtable_node_t*)(nodeptr), (hash)); \
+      HASHTABLE_COUNT(hashtable)++; \
+   }while(0)
+
+/**
+ * @brief Returns the most recently inserted entry with the given hash for which match
+ *        returns true, NULL if there is none. A NULL match accepts any entry with the hash.
+ */
+#define HASHTABLE_FIND(hashtable,hash,match,key) \
+   ((void*)hashtable_find(HASHTABLE_BUCKETS(hashtable), HASHTABLE_MASK(hashtable), \
+                          (hash), (match), (key)))
+
+/**
+ * @brief Removes an entry, evaluates to false if it is not in the table.
+ */
+#define HASHTABLE_REMOVE(hashtable,nodeptr) \
+   (hashtable_remove(HASHTABLE_BUCKETS(hashtable), HASHTABLE_MASK(hashtable), \
+                     (hashtable_node_t*)(nodeptr)) ? \
+    (HASHTABLE_COUNT(hashtable)--, true) : false)
+
+/**
+ * @brief Iterates over all entries in bucket order. The current entry must not be removed.
+ */
+#define HASHTABLE_FOREACH(hashtable,iterator) \
+   for(size_t __hashtable_bucket__ = 0; __hashtable_bucket__ < HASHTABLE_SIZE(hashtable); __hashtable_bucket__++) \
+      for(iterator = (void*)HASHTABLE_BUCKETS(hashtable)[__hashtable_bucket__]; \
+          iterator != NULL; \
+          iterator = (void*)((hashtable_node_t*)(iterator))->next)
+
+void hashtable_insert(hashtable_node_t **buckets, size_t mask, hashtable_node_t *node, uint32_t hash);
+hashtable_node_t* hashtable_find(hashtable_node_t **buckets, size_t mask, uint32_t hash, hashtable_match_t match, const void *key);
+bool hashtable_remove(hashtable_node_t **buckets, size_t mask, hashtable_node_t *node);
+
+#endif /* HASHTABLE_H_ */
@@ -0,0 +1,146 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "heap.h"
+
+
+static inline void heap_place(heap_node_t **items, size_t idx, heap_node_t *node)
+{
+   items[idx] = node;
+   node->index = (uint16_t)idx;
+}
+
+/* Moves node up from position idx until its parent is not after it. */
+static void heap_sift_up(heap_node_t **items, size_t idx, heap_less_t less, heap_node_t *node)
+{
+   while(idx > 0)
+   {
+      size_t parent = (idx - 1) / 2;
+
+      if(!less(node, items[parent]))
+      {
+         break;
+      }
+      heap_place(items, idx, items[parent]);
+      idx = parent;
+   }
+   heap_place(items, idx, node);
+}
+
+/* Moves node down from position idx until no child is before it. */
+static void heap_sift_down(heap_node_t **items, size_t count, size_t idx, heap_less_t less, heap_node_t *node)
+{
+   for(;;)
+   {
+      size_t child = 2 * idx + 1;
+
+      if(child >= count)
+      {
+         break;
+      }
+      if(child + 1 < count && less(items[child + 1], items[child]))
+      {
+         child++;
+      }
+      if(!less(items[child], node))
+      {
+         break;
+      }
+      heap_place(items, idx, items[child]);
+      idx = child;
+   }
+   heap_place(items, idx, node);
+}
+
+
+bool heap_insert(heap_node_t **items, size_t *count, size_t size, heap_less_t less, heap_node_t *node)
+{
+   if(*count >= size)
+   {
+      return false;
+   }
+
+   heap_sift_up(items, (*count)++, less, node);
+
+   return true;
+}
+
+
+heap_node_t* heap_pop(heap_node_t **items, size_t *count, heap_less_t less)
+{
+   heap_node_t *head;
+
+   if(*count == 0)
+   {
+      return NULL;
+   }
+
+   head = items[0];
+   heap_remove(items, count, less, head);
+
+   return head;
+}
+
+
+void heap_remove(heap_node_t **items, size_t *count, heap_less_t less, heap_node_t *node)
+{
+   size_t idx = node->index;
+   heap_node_t *last = items[--(*count)];
+
+   node->index = HEAP_INDEX_NONE;
+
+   if(last == node)
+   {
+      return;
+   }
+
+   // The last entry fills the hole, it may have to go either way from there.
+   if(idx > 0 && less(last, items[(idx - 1) / 2]))
+   {
+      heap_sift_up(items, idx, less, last);
+   }
+   else
+   {
+      heap_sift_down(items, *count, idx, less, last);
+   }
+}
+
+
+void heap_update(heap_node_t **items, size_t count, heap_less_t less, heap_node_t *node)
+{
+   size_t idx = node->index;
+
+   if(idx > 0 && less(node, items[(idx - 1) / 2]))
+   {
+      heap_sift_up(items, idx, less, node);
+   }
+   else
+   {
+      heap_sift_down(items, count, idx, less, node);
+   }
+}
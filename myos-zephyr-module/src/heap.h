@@ -0,0 +1,174 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file heap.h
+ *
+ * @brief Statically sized, intrusive binary min-heap.
+ * @details A priority queue for deadline ordering, declared with HEAP_TYPEDEF() like a
+ *          ringbuffer or an itempool. The heap is an array of pointers to the entries, the
+ *          entries embed a heap_node_t as their first member with HEAP_NODE_TYPE. The node
+ *          holds the position of the entry in the array, so besides insert and remove-min
+ *          also removing any entry and moving it after its key changed (decrease-key) take
+ *          O(log n) without a search.
+ *
+ *          The order is given by a compare function which returns true if its first entry
+ *          is to be taken before the second. Timestamps wrap around, so deadlines are
+ *          compared with timestamp_less_than() as in HEAP_LESS_DEFINE() below. Entries with
+ *          equal keys are taken in no particular order.
+ *
+ * Usage Example:
+ * @code
+ *     typedef struct {
+ *        HEAP_NODE_TYPE;
+ *        timestamp_t deadline;
+ *     } job_t;
+ *
+ *     HEAP_LESS_DEFINE(job_before, job_t, deadline, timestamp_less_than);
+ *
+ *     HEAP_TYPEDEF(jobs, 16);
+ *     static HEAP_T(jobs) jobs;
+ *
+ *     HEAP_INIT(jobs, job_before);
+ *     HEAP_INSERT(jobs, &job);
+ *     job.deadline -= 10;
+ *     HEAP_UPDATE(jobs, &job);
+ *     job_t *next = HEAP_POP(jobs);
+ * @endcode
+ */
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Position of an entry which is not in a heap */
+#define HEAP_INDEX_NONE 0xFFFF
+
+typedef struct {
+   uint16_t index;
+} heap_node_t;
+
+/**
+ * @brief Returns true if entry a is to be taken from the heap before entry b.
+ */
+typedef bool (*heap_less_t)(const heap_node_t *a, const heap_node_t *b);
+
+#define HEAP_NODE_TYPE heap_node_t heap_node
+
+/**
+ * @brief Defines a static compare function `fname` of two `type` entries by their `key`.
+ *
+ * @details `less_than` is a function or macro of two keys, e.g. timestamp_less_than.
+ */
+#define HEAP_LESS_DEFINE(fname,type,key,less_than) \
+   static bool fname(const heap_node_t *a, const heap_node_t *b) \
+   { \
+      return less_than(((const type*)a)->key, ((const type*)b)->key); \
+   }
+
+#define HEAP_TYPEDEF(name,size) \
+   typedef struct { \
+      heap_node_t *items[size]; \
+      size_t count; \
+      heap_less_t less; \
+      _Static_assert((size) < HEAP_INDEX_NONE, "heap too large"); \
+   }name##_heap_t
+
+#define HEAP_T(name) \
+   name##_heap_t
+
+#define HEAP_ITEMS(heap) \
+   ((heap).items)
+
+#define HEAP_SIZE(heap) \
+   (sizeof(HEAP_ITEMS(heap))/sizeof(*HEAP_ITEMS(heap)))
+
+#define HEAP_COUNT(heap) \
+   ((heap).count)
+
+#define HEAP_EMPTY(heap) \
+   (HEAP_COUNT(heap) == 0)
+
+#define HEAP_FULL(heap) \
+   (HEAP_COUNT(heap) == HEAP_SIZE(heap))
+
+#define HEAP_INIT(heap,lessfunc) \
+   do{ \
+      HEAP_COUNT(heap) = 0; \
+      (heap).less = (lessfunc); \
+   }while(0)
+
+/**
+ * @brief Marks an entry as not in a heap, for HEAP_CONTAINS() before its first insert.
+ */
+#define HEAP_NODE_INIT(nodeptr) \
+   do{ ((heap_node_t*)(nodeptr))->index = HEAP_INDEX_NONE; }while(0)
+
+#define HEAP_CONTAINS(heap,nodeptr) \
+   (((heap_node_t*)(nodeptr))->index < HEAP_COUNT(heap) && \
+    HEAP_ITEMS(heap)[((heap_node_t*)(nodeptr))->index] == (heap_node_t*)(nodeptr))
+
+/**
+ * @brief The entry to be taken next, NULL if the heap is empty.
+ */
+#define HEAP_PEEK(heap) \
+   ((void*)(HEAP_EMPTY(heap) ? NULL : HEAP_ITEMS(heap)[0]))
+
+/**
+ * @brief Adds an entry, evaluates to false if the heap is full.
+ */
+#define HEAP_INSERT(heap,nodeptr) \
+   heap_insert(HEAP_ITEMS(heap), &HEAP_COUNT(heap), HEAP_SIZE(heap), (heap).less, (heap_node_t*)(nodeptr))
+
+/**
+ * @brief Takes the entry to be taken next, NULL if the heap is empty.
+ */
+#define HEAP_POP(heap) \
+   ((void*)heap_pop(HEAP_ITEMS(heap), &HEAP_COUNT(heap), (heap).less))
+
+/**
+ * @brief Removes an entry of the heap.
+ */
+#define HEAP_REMOVE(heap,nodeptr) \
+   heap_remove(HEAP_ITEMS(heap), &HEAP_COUNT(heap), (heap).less, (heap_node_t*)(nodeptr))
+
+/**
+ * @brief Restores the order after the key of an entry of the heap changed in either direction.
+ */
+#define HEAP_UPDATE(heap,nodeptr) \
+   heap_update(HEAP_ITEMS(heap), HEAP_COUNT(heap), (heap).less, (heap_node_t*)(nodeptr))
+
+bool heap_insert(heap_node_t **items, size_t *count, size_t size, heap_less_t less, heap_node_t *node);
+heap_node_t* heap_pop(heap_node_t **items, size_t *count, heap_less_t less);
+void heap_remove(heap_node_t **items, size_t *count, heap_less_t less, heap_node_t *node);
+void heap_update(heap_node_t **items, size_t count, heap_less_t less, heap_node_t *node);
+
+#endif /* HEAP_H_ */
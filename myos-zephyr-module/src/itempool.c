@@ -82,3 +82,30 @@ void* itempool_calloc(uint8_t* items, uint8_t* status, size_t itemsize, size_t p
     return items;
 }
 
+
+void itempool_freelist_init(uint8_t* items, uint16_t* head, size_t itemsize, size_t poolsize)
+{
+    uint16_t tmp;
+
+    *head = poolsize ? 0 : ITEMPOOL_FREELIST_END;
+
+    for (tmp=0; tmp < poolsize; tmp++)
+    {
+        uint16_t next = (tmp+1u < poolsize) ? tmp+1u : ITEMPOOL_FREELIST_END;
+
+        memcpy(items, &next, sizeof(next));
+        items+=itemsize;
+    }
+}
+
+
+void itempool_bitmap_init(uint32_t* bitmap, size_t poolsize)
+{
+    /* all complete words free, then the remaining bits of the last word */
+    memset(bitmap, 0xFF, (poolsize>>5)*sizeof(*bitmap));
+
+    if (poolsize & 31)
+    {
+        bitmap[poolsize>>5] = ((uint32_t)1 << (poolsize & 31)) - 1;
+    }
+}
@@ -39,6 +39,13 @@
     \brief
 
     \details Memory pools, also known as fixed-size block allocation, enable dynamic memory allocation similar to malloc or C++'s operator new. However, these implementations are prone to fragmentation due to variable block sizes and are therefore not recommended for use in real-time systems where performance is critical. To address this issue, a more efficient approach is to preallocate a fixed number of memory blocks of the same size, which is known as a memory pool. During runtime, the application can allocate, access, and free blocks represented by handles, resulting in improved performance.
+
+             The bookkeeping of free items is done by one of three backends, selected by the macro used to declare the pool type. All other ITEMPOOL macros work with each of them.
+             - ITEMPOOL_TYPEDEF: one status byte per item, allocation scans the status array. O(n) allocation.
+             - ITEMPOOL_TYPEDEF_FREELIST: the free items are chained through their own storage by item index, there is no status array. O(1) allocation and free, the items must be at least 2 bytes.
+             - ITEMPOOL_TYPEDEF_BITMAP: one bit per item in 32-bit words, allocation finds the first free item with a count-trailing-zeros instruction. n/32 word tests per allocation.
+
+             The backend is determined at compile time from the element size of the status member, so the dispatch costs nothing at runtime.
 */
 #ifndef ITEMPOOL_H_
 #define ITEMPOOL_H_
@@ -47,26 +54,82 @@
 #include <stddef.h>
 #include <string.h>
 
+#if defined(CONFIG_MYOS_DEBUG)
+#include "debug.h"
+#endif
+
 #define ITEMPOOL_ITEM_FREE 0
 #define ITEMPOOL_ITEM_USED 1
 
+/* Index marking the end of the free list of ITEMPOOL_TYPEDEF_FREELIST pools */
+#define ITEMPOOL_FREELIST_END 0xFFFF
+
+/* Element sizes of the status member, identifying the backend of a pool */
+#define ITEMPOOL_BACKEND_SCAN       sizeof(uint8_t)
+#define ITEMPOOL_BACKEND_FREELIST   sizeof(uint16_t)
+#define ITEMPOOL_BACKEND_BITMAP     sizeof(uint32_t)
+
 #define ITEMPOOL_TYPEDEF(name,type,size) \
     typedef struct { \
         uint8_t status[size]; \
         type items[size]; \
     }name##_itempool_t
 
+/*!
+    \brief  Declares a pool type which chains its free items through the items themselves.
+    \details status[0] holds the index of the first free item, every free item holds the
+             index of the next one in its first two bytes.
+*/
+#define ITEMPOOL_TYPEDEF_FREELIST(name,type,size) \
+    typedef struct { \
+        uint16_t status[1]; \
+        type items[size]; \
+        _Static_assert(sizeof(type) >= sizeof(uint16_t), "freelist itempool items must be at least 2 bytes"); \
+        _Static_assert((size) < ITEMPOOL_FREELIST_END, "freelist itempool too large"); \
+    }name##_itempool_t
+
+/*!
+    \brief  Declares a pool type which keeps one bit per item, set while the item is free.
+*/
+#define ITEMPOOL_TYPEDEF_BITMAP(name,type,size) \
+    typedef struct { \
+        uint32_t status[((size)+31)>>5]; \
+        type items[size]; \
+    }name##_itempool_t
+
 #define ITEMPOOL_T(name) \
     name##_itempool_t
 
+#define ITEMPOOL_BACKEND(itempool) \
+    sizeof(*ITEMPOOL_STATUS(itempool))
+
 #define ITEMPOOL_INIT(itempool) \
-        memset(ITEMPOOL_STATUS(itempool), \
-               ITEMPOOL_ITEM_FREE, \
-               ITEMPOOL_SIZE(itempool))
+    do{ \
+        if(ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_FREELIST) \
+        { \
+            itempool_freelist_init( \
+                (uint8_t*)ITEMPOOL_ITEMS(itempool), \
+                (uint16_t*)ITEMPOOL_STATUS(itempool), \
+                ITEMPOOL_ITEM_SIZE(itempool), \
+                ITEMPOOL_SIZE(itempool)); \
+        } \
+        else if(ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_BITMAP) \
+        { \
+            itempool_bitmap_init( \
+                (uint32_t*)ITEMPOOL_STATUS(itempool), \
+                ITEMPOOL_SIZE(itempool)); \
+        } \
+        else \
+        { \
+            memset(ITEMPOOL_STATUS(itempool), \
+                   ITEMPOOL_ITEM_FREE, \
+                   sizeof(ITEMPOOL_STATUS(itempool))); \
+        } \
+    }while(0)
 
 #define ITEMPOOL_SIZE(itempool) \
-    (sizeof(ITEMPOOL_STATUS(itempool))/ \
-     sizeof(*ITEMPOOL_STATUS(itempool)))
+    (sizeof(ITEMPOOL_ITEMS(itempool))/ \
+     ITEMPOOL_ITEM_SIZE(itempool))
 
 #define ITEMPOOL_ITEM_SIZE(itempool) \
     (sizeof(*ITEMPOOL_ITEMS(itempool)))
@@ -77,19 +140,40 @@
 #define ITEMPOOL_ITEMS(itempool) \
         ((itempool).items)
 
+#define ITEMPOOL_INDEX(itempool,itemptr) \
+    ((size_t)((uint8_t*)(itemptr)-(uint8_t*)ITEMPOOL_ITEMS(itempool))/ \
+     ITEMPOOL_ITEM_SIZE(itempool))
+
+/*!
+    \brief  Checks whether itemptr points to the start of an item of the pool.
+*/
+#define ITEMPOOL_CONTAINS(itempool,itemptr) \
+    ((uint8_t*)(itemptr) >= (uint8_t*)ITEMPOOL_ITEMS(itempool) && \
+     (uint8_t*)(itemptr) < (uint8_t*)ITEMPOOL_ITEMS(itempool) + sizeof(ITEMPOOL_ITEMS(itempool)) && \
+     ((size_t)((uint8_t*)(itemptr)-(uint8_t*)ITEMPOOL_ITEMS(itempool)) % ITEMPOOL_ITEM_SIZE(itempool)) == 0)
+
 #define ITEMPOOL_ALLOC(itempool) \
-    itempool_alloc( \
-        (uint8_t*)ITEMPOOL_ITEMS(itempool), \
-        ITEMPOOL_STATUS(itempool), \
-        ITEMPOOL_ITEM_SIZE(itempool), \
-        ITEMPOOL_SIZE(itempool))
+    (ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_FREELIST ? \
+        itempool_freelist_alloc( \
+            (uint8_t*)ITEMPOOL_ITEMS(itempool), \
+            (uint16_t*)ITEMPOOL_STATUS(itempool), \
+            ITEMPOOL_ITEM_SIZE(itempool)) : \
+     ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_BITMAP ? \
+        itempool_bitmap_alloc( \
+            (uint8_t*)ITEMPOOL_ITEMS(itempool), \
+            (uint32_t*)ITEMPOOL_STATUS(itempool), \
+            ITEMPOOL_ITEM_SIZE(itempool), \
+            ITEMPOOL_SIZE(itempool)) : \
+        itempool_alloc( \
+            (uint8_t*)ITEMPOOL_ITEMS(itempool), \
+            (uint8_t*)ITEMPOOL_STATUS(itempool), \
+            ITEMPOOL_ITEM_SIZE(itempool), \
+            ITEMPOOL_SIZE(itempool)))
 
 #define ITEMPOOL_CALLOC(itempool) \
-    itempool_calloc( \
-        (uint8_t*)ITEMPOOL_ITEMS(itempool), \
-        ITEMPOOL_STATUS(itempool), \
-        ITEMPOOL_ITEM_SIZE(itempool), \
-        ITEMPOOL_SIZE(itempool))
+    itempool_zero( \
+        ITEMPOOL_ALLOC(itempool), \
+        ITEMPOOL_ITEM_SIZE(itempool))
 
 
 /*
@@ -100,13 +184,92 @@
  004464    43CF 1C00          clr.b   0x1C00(R15)
  */
 #define ITEMPOOL_FREE(itempool,itemptr) \
-        do{ITEMPOOL_STATUS(itempool) \
-            [((uint8_t*)itemptr-(uint8_t*)ITEMPOOL_ITEMS(itempool))/ \
-             ITEMPOOL_ITEM_SIZE(itempool)] \
-             =ITEMPOOL_ITEM_FREE;}while(0)
+    do{ \
+        ITEMPOOL_FREE_CHECK(itempool,itemptr); \
+        if(ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_FREELIST) \
+        { \
+            uint16_t *__itempool_head__ = (uint16_t*)ITEMPOOL_STATUS(itempool); \
+            memcpy((itemptr), __itempool_head__, sizeof(*__itempool_head__)); \
+            *__itempool_head__ = (uint16_t)ITEMPOOL_INDEX(itempool,itemptr); \
+        } \
+        else if(ITEMPOOL_BACKEND(itempool) == ITEMPOOL_BACKEND_BITMAP) \
+        { \
+            size_t __itempool_index__ = ITEMPOOL_INDEX(itempool,itemptr); \
+            ((uint32_t*)ITEMPOOL_STATUS(itempool))[__itempool_index__>>5] |= \
+                (uint32_t)1 << (__itempool_index__&31); \
+        } \
+        else \
+        { \
+            ((uint8_t*)ITEMPOOL_STATUS(itempool))[ITEMPOOL_INDEX(itempool,itemptr)] = \
+                ITEMPOOL_ITEM_FREE; \
+        } \
+    }while(0)
+
+/*!
+    \brief  Rejects a free of an item which does not belong to the pool (debug builds only).
+*/
+#if defined(CONFIG_MYOS_DEBUG)
+#define ITEMPOOL_FREE_CHECK(itempool,itemptr) \
+    if(!ITEMPOOL_CONTAINS(itempool,itemptr)) \
+    { \
+        DBG_FUNC("itempool %p: free of foreign item %p\n", (void*)&(itempool), (void*)(itemptr)); \
+        break; \
+    }
+#else
+#define ITEMPOOL_FREE_CHECK(itempool,itemptr) do{}while(0)
+#endif
 
 
 void* itempool_alloc(uint8_t* items, uint8_t* status, size_t itemsize, size_t poolsize);
 void* itempool_calloc(uint8_t* items, uint8_t* status, size_t itemsize, size_t poolsize);
+void itempool_freelist_init(uint8_t* items, uint16_t* head, size_t itemsize, size_t poolsize);
+void itempool_bitmap_init(uint32_t* bitmap, size_t poolsize);
+
+
+static inline void* itempool_zero(void* item, size_t itemsize)
+{
+    if (item)
+    {
+        memset(item,0x00,itemsize);
+    }
+
+    return item;
+}
+
+
+static inline void* itempool_freelist_alloc(uint8_t* items, uint16_t* head, size_t itemsize)
+{
+    uint8_t* item;
+
+    if (*head == ITEMPOOL_FREELIST_END)
+    {
+        return NULL;
+    }
+
+    item = items + (size_t)*head * itemsize;
+    memcpy(head, item, sizeof(*head));
+
+    return item;
+}
+
+
+static inline void* itempool_bitmap_alloc(uint8_t* items, uint32_t* bitmap, size_t itemsize, size_t poolsize)
+{
+    size_t word;
+
+    for (word=0; word < ((poolsize+31)>>5); word++)
+    {
+        if (bitmap[word])
+        {
+            /* RBIT+CLZ on Cortex-M3 and up */
+            size_t index = (word<<5) + (size_t)__builtin_ctz(bitmap[word]);
+
+            bitmap[word] &= bitmap[word]-1;
+            return items + index * itemsize;
+        }
+    }
+
+    return NULL;
+}
 
 #endif /* ITEMPOOL_H_ */
@@ -0,0 +1,152 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "load.h"
+#include "myos.h"
+
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+
+#if defined(CONFIG_MYOS_STATISTICS_LOAD_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+uint32_t load_busy;
+uint32_t load_events;
+
+static timestamp_t load_start;
+static load_t load_last;
+
+
+/* Fills the busy share and the event rate from the other members */
+static void load_ratio(load_t *load)
+{
+   uint32_t busy = MIN(load->busy, load->window);
+
+   load->load = load->window ? (uint16_t)((uint64_t)busy * 1000U / load->window) : 0;
+   load->rate = load->ms ? (uint32_t)((uint64_t)load->events * 1000U / load->ms) : 0;
+}
+
+
+void load_update(timestamp_t now)
+{
+   timespan_t ms = TIMESTAMP_DIFF(now, load_start);
+   load_t load;
+
+   if(ms < CONFIG_MYOS_STATISTICS_LOAD_WINDOW)
+   {
+      return;
+   }
+
+   load.ms = ms;
+   load.window = (uint32_t)((uint64_t)ms * RTIMER_TICKS_PER_SEC / 1000U);
+   load.busy = load_busy;
+   load.events = load_events;
+   load_ratio(&load);
+
+   load_busy = 0;
+   load_events = 0;
+   load_start = now;
+
+   // Only the MyOS thread counts, the lock keeps the readers in other threads consistent
+   CRITICAL_STATEMENT(load_last = load);
+
+   for(process_t *process = process_running_next(NULL); process != NULL; process = process_running_next(process))
+   {
+      process->lastbusy = process->busy;
+      process->lastevents = process->events;
+      process->busy = 0;
+      process->events = 0;
+   }
+}
+
+
+void load_get(load_t *load)
+{
+   CRITICAL_STATEMENT(*load = load_last);
+}
+
+
+void load_process_get(process_t *process, load_t *load)
+{
+   load_get(load);
+   load->busy = process->lastbusy;
+   load->events = process->lastevents;
+   load_ratio(load);
+}
+
+
+void load_module_init(void)
+{
+   load_busy = 0;
+   load_events = 0;
+   load_start = timestamp_now();
+   memset(&load_last, 0, sizeof(load_last));
+}
+
+
+#if defined(CONFIG_MYOS_STATISTICS_LOAD_SHELL)
+static int load_cmd(const struct shell *sh, size_t argc, char **argv)
+{
+   load_t load;
+
+   ARG_UNUSED(argc);
+   ARG_UNUSED(argv);
+
+   load_get(&load);
+   shell_print(sh, "%u ms: busy %u of %u rtimer ticks, load %u.%u%%, %u events/s",
+               load.ms, load.busy, load.window, load.load / 10U, load.load % 10U, load.rate);
+
+   // Keeps the MyOS thread from terminating a process under the iterator
+   k_sched_lock();
+   for(process_t *process = process_running_next(NULL); process != NULL; process = process_running_next(process))
+   {
+      if(process == &idle_process)
+      {
+         continue;
+      }
+      load_process_get(process, &load);
+      shell_print(sh, "  process %p thread %p: load %u.%u%%, %u events/s",
+                  (void*)process, (void*)process->thread, load.load / 10U, load.load % 10U, load.rate);
+   }
+   k_sched_unlock();
+
+   return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(myos_cmds,
+   SHELL_CMD(load, NULL, "CPU load of the last window, in total and per process", load_cmd),
+   SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(myos, &myos_cmds, "MyOS scheduler", NULL);
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file load.h
+ *
+ * @brief CPU load meter of the cooperative scheduler.
+ * @details The rtimer ticks every process thread runs and the events delivered to it are
+ *          summed up over a window of CONFIG_MYOS_STATISTICS_LOAD_WINDOW milliseconds.
+ *          The statistics idle process closes the window, its own slices count as idle
+ *          time, as does the time the MyOS thread is blocked. The time spent in the
+ *          scheduler loop itself, in tasklets and in ISRs is not counted.
+ *
+ *          load_get() returns the totals of the last closed window, load_process_get() the
+ *          share of one process. With CONFIG_MYOS_STATISTICS_LOAD_SHELL, "myos load" prints
+ *          both on the Zephyr shell.
+ *
+ * Usage Example:
+ * @code
+ *     load_t load;
+ *
+ *     load_get(&load);
+ *     printk("load %u.%u%%, %u events/s\n", load.load / 10, load.load % 10, load.rate);
+ * @endcode
+ */
+
+#ifndef LOAD_H_
+#define LOAD_H_
+
+#include "process.h"
+#include "rtimer.h"
+#include "timestamp.h"
+
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+
+/*!
+ * @struct load_t
+ * @brief Load of one closed window.
+ *
+ * @var load_t::ms
+ *      Length of the window in milliseconds.
+ * @var load_t::window
+ *      Length of the window in rtimer ticks.
+ * @var load_t::busy
+ *      rtimer ticks spent in the process threads, at most window.
+ * @var load_t::events
+ *      Events delivered to the process threads.
+ * @var load_t::load
+ *      busy share of the window in permille.
+ * @var load_t::rate
+ *      Events per second.
+ */
+typedef struct {
+   uint32_t ms;
+   uint32_t window;
+   uint32_t busy;
+   uint32_t events;
+   uint16_t load;
+   uint32_t rate;
+} load_t;
+
+PROCESS_EXTERN(idle_process);
+
+extern uint32_t load_busy;
+extern uint32_t load_events;
+
+/*!
+ * @brief Counts a time slice of a process, called by the scheduler after every delivery.
+ */
+static inline void load_count(process_t *process, rtimer_timespan_t slicetime)
+{
+   process->busy += slicetime;
+   process->events++;
+
+   if(process != &idle_process)
+   {
+      load_busy += slicetime;
+      load_events++;
+   }
+}
+
+/*!
+ * @brief Closes the window once it is CONFIG_MYOS_STATISTICS_LOAD_WINDOW ms long, called by
+ *        the statistics idle process.
+ */
+void load_update(timestamp_t now);
+
+/*!
+ * @brief Copies the totals of the last closed window, callable from any thread.
+ */
+void load_get(load_t *load);
+
+/*!
+ * @brief Returns the share of one process in the last closed window.
+ */
+void load_process_get(process_t *process, load_t *load);
+
+/*!
+ * @brief Starts the first window.
+ */
+void load_module_init(void);
+
+#endif
+
+#endif /* LOAD_H_ */
@@ -1,6 +1,19 @@
 #include "mutex.h"
 #include "critical.h"
 
+#if defined(CONFIG_MYOS_MUTEX_ATOMIC)
+
+bool mutex_lock(mutex_t *mutex)
+{
+   bool unlocked = false;
+
+   // LDREXB/STREXB, the STREXB fails and retries if an interrupt came in between
+   return __atomic_compare_exchange_n(mutex, &unlocked, true, false,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+#else
+
 bool mutex_lock(mutex_t *mutex)
 {
    bool status = false;
@@ -18,16 +31,17 @@ bool mutex_lock(mutex_t *mutex)
    return status;
 }
 
+#endif
+
 
+// A byte store and a byte load are single instructions on every target, no critical section needed
 void mutex_release(mutex_t *mutex)
 {
-   CRITICAL_STATEMENT(*mutex = false);
+   __atomic_store_n(mutex, false, __ATOMIC_RELEASE);
 }   
 
 
 bool mutex_is_locked(mutex_t *mutex)
 {
-   bool status;
-   CRITICAL_STATEMENT(status = *mutex);
-   return status;
-}
\ No newline at end of file
+   return __atomic_load_n(mutex, __ATOMIC_ACQUIRE);
+}   
@@ -41,62 +41,216 @@
 myos_stats_t myos_stats;
 
 PROCESS(idle_process,idle_process);
+/*
+ * Wakes up every CONFIG_MYOS_STATISTICS_IDLE_PERIOD ms instead of yielding all the time,
+ * so that the MyOS thread can block while there is nothing to do.
+ */
 PROCESS_THREAD(idle_process)
 {
-   static timestamp_t start,stop;
-   static rtimer_timestamp_t rtstart,rtstop;
+   static etimer_t et;
+   static timestamp_t stop;
+   static rtimer_timestamp_t rtstart;
 
    PROCESS_BEGIN();
 
-   start = timestamp_now();
-   rtstart = rtimer_now();
+   etimer_start(&et, CONFIG_MYOS_STATISTICS_IDLE_PERIOD, PROCESS_THIS(), PROCESS_EVENT_TIMEOUT, NULL);
 
    while(1)
    {
-      PROCESS_YIELD();
+      PROCESS_WAIT_EVENT(PROCESS_EVENT_TIMEOUT);
 
-      rtstop = rtimer_now();
       stop = timestamp_now();
 
-
-      if( TIMESTAMP_DIFF(stop,start) > 1 ) // more than one tick behind ?
+      if( TIMESTAMP_DIFF(stop,timer_timestamp_stop(&et.ptimer.timer)) > 1 ) // more than one tick behind ?
       {
          myos_stats.errflags.realtime = 1;
       }
 
-      rtstart = RTIMER_TIMESTAMP_DIFF(rtstop,rtstart);
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+      load_update(stop);
+#endif
+
+      // One lap through the event queue
+      rtstart = rtimer_now();
+      PROCESS_YIELD();
+      rtstart = RTIMER_TIMESTAMP_DIFF(rtimer_now(),rtstart);
 
       if ( rtstart > myos_stats.maxlaptime )
       {
          myos_stats.maxlaptime = rtstart;
       }
 
-      start = stop;
-      rtstart = rtstop;
+      etimer_reset(&et);
    }
 
    PROCESS_END();
 }
 #endif
 
+/*
+ * Given by myos_wakeup() whenever new work shows up while the MyOS thread might be
+ * sleeping. The limit of 1 merges any number of wakeups into a single pass.
+ */
+K_SEM_DEFINE(myos_wakeup_sem, 0, 1);
+
+
+void myos_wakeup(void)
+{
+   k_sem_give(&myos_wakeup_sem);
+}
+
+
+#if CONFIG_MYOS_INSTANCES > 1
+/*
+ * The further instances, index 0 of these arrays is instance 1. The first instance is run
+ * by myos_run_forever() and woken up with myos_wakeup_sem.
+ */
+static struct k_sem myos_instance_sems[CONFIG_MYOS_INSTANCES - 1];
+static struct k_thread myos_instance_threads[CONFIG_MYOS_INSTANCES - 1];
+static k_tid_t myos_instance_tids[CONFIG_MYOS_INSTANCES - 1];
+static K_THREAD_STACK_ARRAY_DEFINE(myos_instance_stacks, CONFIG_MYOS_INSTANCES - 1, CONFIG_MYOS_STACK_SIZE);
+
+
+void myos_instance_wakeup(uint8_t instance)
+{
+   if(instance == 0)
+   {
+      k_sem_give(&myos_wakeup_sem);
+   }
+   else if(instance < CONFIG_MYOS_INSTANCES)
+   {
+      k_sem_give(&myos_instance_sems[instance - 1]);
+   }
+}
+
+
+static void myos_instance_thread(void *p1, void *p2, void *p3)
+{
+   uint8_t instance = (uint8_t)(uintptr_t)p1;
+
+   process_instance_bind(instance);
+
+   if(p2)
+   {
+      process_start(p2, p3);
+   }
+
+   for(;;)
+   {
+      if(!process_run())
+      {
+         k_sem_take(&myos_instance_sems[instance - 1], K_FOREVER);
+      }
+   }
+}
+
+
+k_tid_t myos_instance_start(uint8_t instance, int cpu, process_t *process, void *data)
+{
+   k_tid_t tid;
+
+   if(instance == 0 || instance >= CONFIG_MYOS_INSTANCES || myos_instance_tids[instance - 1])
+   {
+      return NULL;
+   }
+
+   tid = k_thread_create(&myos_instance_threads[instance - 1], myos_instance_stacks[instance - 1],
+                         K_THREAD_STACK_SIZEOF(myos_instance_stacks[instance - 1]), myos_instance_thread,
+                         (void*)(uintptr_t)instance, process, data, CONFIG_MYOS_THREAD_PRIORITY, 0, K_FOREVER);
+
+#if defined(CONFIG_SCHED_CPU_MASK)
+   // The CPU mask of a thread may only be changed before it is started.
+   if(cpu >= 0)
+   {
+      k_thread_cpu_pin(tid, cpu);
+   }
+#else
+   ARG_UNUSED(cpu);
+#endif
+
+   myos_instance_tids[instance - 1] = tid;
+   k_thread_start(tid);
+
+   DBG("MyOS instance %d started\n", instance);
+
+   return tid;
+}
+#endif
+
+
+void myos_run_forever(void)
+{
+   for(;;)
+   {
+#if defined(CONFIG_MYOS_BRIDGE)
+      // One item per registered kernel object and pass, interleaved with the events.
+      bool work = process_run();
+
+      if(!bridge_run() && !work)
+      {
+         bridge_wait();
+      }
+#else
+      if(!process_run())
+      {
+         // A wakeup given after process_run found no work is still pending in the semaphore.
+         k_sem_take(&myos_wakeup_sem, K_FOREVER);
+      }
+#endif
+   }
+}
+
 
 void myos_init(void)
 {
    DBG("MyOS init\n");
    process_init();   
+#if CONFIG_MYOS_INSTANCES > 1
+   for(int i = 0; i < CONFIG_MYOS_INSTANCES - 1; i++)
+   {
+      k_sem_init(&myos_instance_sems[i], 0, 1);
+   }
+#endif
    timestamp_module_init();
    timer_module_init();
    ptimer_module_init();
+#if defined(CONFIG_MYOS_TIMESTAMP_NOW64)
+   timestamp64_module_init();
+#endif
    etimer_module_init();
    ctimer_module_init();
    rtimer_init();
+#if defined(CONFIG_MYOS_OFFLOAD)
+   offload_module_init();
+#endif
+#if defined(CONFIG_MYOS_DEFER)
+   defer_module_init();
+#endif
+#if defined(CONFIG_MYOS_PBUF)
+   pbuf_module_init();
+#endif
+#if defined(CONFIG_MYOS_BRIDGE)
+   bridge_module_init(&myos_wakeup_sem);
+#endif
+#if defined(CONFIG_MYOS_UARTSINK)
+   uartsink_module_init();
+#endif
 
 
 
 
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+    load_module_init();
+#endif
+#if defined(CONFIG_MYOS_WCET)
+    wcet_module_init();
+#endif
 #if defined(CONFIG_MYOS_STATISTICS)
     process_start(&idle_process,NULL);
 #endif
+#if defined(CONFIG_MYOS_PROC_AUTOSTART)
+    process_autostart();
+#endif
 
 
 
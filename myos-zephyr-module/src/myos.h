@@ -41,6 +41,15 @@
 #include "ctimer.h"
 #include "etimer.h"
 #include "rtimer.h"
+#include "offload.h"
+#include "defer.h"
+#include "pbuf.h"
+#include "bridge.h"
+#include "uartsink.h"
+#include "channel.h"
+#include "trace.h"
+#include "load.h"
+#include "wcet.h"
 
 #include <zephyr/kernel.h>
 
@@ -49,6 +58,11 @@
 typedef struct {
    unsigned realtime : 1;
    unsigned eventqueue : 1;
+   unsigned payloadpool : 1;
+   unsigned deferqueue : 1;
+   unsigned pbufpool : 1;
+   unsigned scratch : 1;
+   unsigned parkpool : 1;
 }myos_errflags_t;
 
 typedef struct {
@@ -65,5 +79,90 @@ extern myos_stats_t myos_stats;
 
 void myos_init(void);
 
+/**
+ * @brief Runs the MyOS scheduler loop, never returns.
+ *
+ * @details
+ * Calls `process_run` as long as there are pending events or polls. When there is no
+ * more work, the calling Zephyr thread blocks until `myos_wakeup` is called, so lower
+ * priority threads and the idle thread (and with it the PM idle states) get the CPU.
+ *
+ * `process_poll` and `process_post_isr` call `myos_wakeup`, which covers the timestamp
+ * ISR polling the ptimer process and all rtimer callbacks. Events posted with
+ * `process_post` from within a process are seen by the loop without a wakeup.
+ *
+ * With CONFIG_MYOS_STATISTICS, the statistics idle process wakes the loop up every
+ * CONFIG_MYOS_STATISTICS_IDLE_PERIOD ms to take its measurements.
+ *
+ * With CONFIG_MYOS_BRIDGE, the loop also delivers the items of the kernel objects
+ * registered with `myos_bridge_msgq`, `myos_bridge_fifo` and `myos_bridge_sem`, and
+ * blocks in `k_poll` on them and on the wakeup semaphore.
+ *
+ * @code
+ * void myos_scheduler(void)
+ * {
+ *    myos_init();
+ *    process_start(&my_process, NULL);
+ *    myos_run_forever();
+ * }
+ * @endcode
+ */
+void myos_run_forever(void);
+
+/**
+ * @brief Wakes up the MyOS thread blocked in `myos_run_forever`.
+ *
+ * May be called from any context, including ISRs. Wakeups given while the thread is
+ * running are merged and cause at most one additional pass of the scheduler loop.
+ */
+void myos_wakeup(void);
+
+#if CONFIG_MYOS_INSTANCES > 1
+/**
+ * @brief Starts the thread of a further MyOS instance.
+ *
+ * @param instance Index of the instance, 1 to CONFIG_MYOS_INSTANCES - 1. The first
+ *        instance is the one run by `myos_run_forever`.
+ * @param cpu CPU core the thread is pinned to, -1 to let it run on any core. Pinning
+ *        needs CONFIG_SCHED_CPU_MASK, without it the thread runs on any core.
+ * @param process First process of the instance, started by its thread, or NULL.
+ * @param data Data passed to the process.
+ * @return The thread of the instance, NULL if the index is invalid or the instance has
+ *         been started already.
+ *
+ * @details
+ * Every instance has its own process list, event queues, mailbox and current process,
+ * and runs `process_run` in its own Zephyr thread of CONFIG_MYOS_THREAD_PRIORITY with a
+ * stack of CONFIG_MYOS_STACK_SIZE bytes, blocking while it has no work. A process belongs
+ * to the instance which starts it. Events posted to a process of another instance are
+ * handed over through the mailbox of that instance, so `process_post_sync` to such a
+ * process queues the event instead of delivering it right away.
+ *
+ * The ptimers and with them etimers and ctimers are served by the first instance and must
+ * only be started and stopped by its processes, their events may go to processes of any
+ * instance. Tasklets and the kernel object bridge are run by the first instance as well.
+ *
+ * Must be called after `myos_init`.
+ *
+ * @code
+ * void myos_scheduler(void)
+ * {
+ *    myos_init();
+ *    myos_instance_start(1, 1, &control_process, NULL);
+ *    process_start(&ui_process, NULL);
+ *    myos_run_forever();
+ * }
+ * @endcode
+ */
+k_tid_t myos_instance_start(uint8_t instance, int cpu, process_t *process, void *data);
+
+/**
+ * @brief Wakes up the thread of a MyOS instance, see `myos_wakeup`.
+ *
+ * @param instance Index of the instance, 0 is the one run by `myos_run_forever`.
+ */
+void myos_instance_wakeup(uint8_t instance);
+#endif
+
 
 #endif /* MYOS_H_ */
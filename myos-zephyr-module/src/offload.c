@@ -0,0 +1,83 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "offload.h"
+
+#if defined(CONFIG_MYOS_OFFLOAD)
+
+/* Jobs waiting for a worker, shared by all workers */
+static K_FIFO_DEFINE(offload_fifo);
+
+static K_THREAD_STACK_ARRAY_DEFINE(offload_stacks, CONFIG_MYOS_OFFLOAD_WORKERS, CONFIG_MYOS_OFFLOAD_STACK_SIZE);
+static struct k_thread offload_threads[CONFIG_MYOS_OFFLOAD_WORKERS];
+
+
+static void offload_worker(void *p1, void *p2, void *p3)
+{
+   ARG_UNUSED(p1);
+   ARG_UNUSED(p2);
+   ARG_UNUSED(p3);
+
+   for(;;)
+   {
+      offload_t *offload = k_fifo_get(&offload_fifo, K_FOREVER);
+
+      // The job may be reused as soon as it is done, keep the process.
+      process_t *process = offload->process;
+
+      offload->function(offload->arg);
+
+      __atomic_store_n(&offload->done, true, __ATOMIC_RELEASE);
+      process_poll(process);
+   }
+}
+
+
+void offload_submit(offload_t *offload, offload_function_t function, void *arg)
+{
+   offload->function = function;
+   offload->arg = arg;
+   offload->process = PROCESS_THIS();
+   offload->done = false;
+
+   k_fifo_put(&offload_fifo, offload);
+}
+
+
+void offload_module_init(void)
+{
+   for(int i = 0; i < CONFIG_MYOS_OFFLOAD_WORKERS; i++)
+   {
+      k_thread_create(&offload_threads[i], offload_stacks[i],
+                      K_THREAD_STACK_SIZEOF(offload_stacks[i]),
+                      offload_worker, NULL, NULL, NULL,
+                      CONFIG_MYOS_OFFLOAD_THREAD_PRIORITY, 0, K_NO_WAIT);
+   }
+}
+
+#endif /* CONFIG_MYOS_OFFLOAD */
@@ -0,0 +1,132 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file offload.h
+ *
+ * @brief Offloading of long-running functions to Zephyr worker threads.
+ * @details A protothread must not block, so a compute-heavy loop either yields in every
+ *          iteration, which costs a full event round-trip each time, or stalls the whole
+ *          cooperative scheduler. PROCESS_OFFLOAD() instead runs a plain C function unsliced
+ *          in one of CONFIG_MYOS_OFFLOAD_WORKERS Zephyr worker threads and blocks the calling
+ *          protothread until the function has returned. All workers take their jobs from one
+ *          shared FIFO, so an idle worker always picks up the next job.
+ *
+ *          The offloaded function runs concurrently to the MyOS thread. It must not call
+ *          any MyOS function except process_poll(), and must synchronize its own accesses
+ *          to data shared with processes.
+ *
+ * Usage Example:
+ * @code
+ *     static offload_t job;
+ *
+ *     PROCESS_THREAD(render)
+ *     {
+ *        PROCESS_BEGIN();
+ *        PROCESS_OFFLOAD(&job, render_frame, &frame);
+ *        // render_frame(&frame) has returned
+ *        PROCESS_END();
+ *     }
+ * @endcode
+ */
+
+#ifndef OFFLOAD_H_
+#define OFFLOAD_H_
+
+#include "myos.h"
+
+#if defined(CONFIG_MYOS_OFFLOAD)
+
+/*!
+ * @typedef offload_function_t
+ * @brief Function type run by a worker thread.
+ */
+typedef void (*offload_function_t)(void *arg);
+
+/*!
+ * @struct offload_t
+ * @brief Offload job control structure.
+ * @details Must stay valid until the job is done, i.e. it is usually static or part of the
+ *          data of the process.
+ *
+ * @var offload_t::fifo_reserved
+ *      Used by the Zephyr FIFO while the job is queued.
+ * @var offload_t::function
+ *      The function to run.
+ * @var offload_t::arg
+ *      Argument passed to the function.
+ * @var offload_t::process
+ *      The process which is polled once the function has returned.
+ * @var offload_t::done
+ *      Set by the worker once the function has returned.
+ */
+typedef struct {
+   void *fifo_reserved;
+   offload_function_t function;
+   void *arg;
+   process_t *process;
+   bool done;
+}offload_t;
+
+/*!
+ * @brief Queues a function to run in a worker thread.
+ * @details The current process is polled once the function has returned.
+ * @param[in] offload Pointer to the job, must not be queued already.
+ * @param[in] function Function to run.
+ * @param[in] arg Argument passed to the function.
+ */
+void offload_submit(offload_t *offload, offload_function_t function, void *arg);
+
+/*!
+ * @brief Checks if the function of a job has returned.
+ * @param[in] offloadptr Pointer to the job.
+ */
+#define offload_done(offloadptr) __atomic_load_n(&(offloadptr)->done, __ATOMIC_ACQUIRE)
+
+/*!
+ * @brief Starts the worker threads.
+ */
+void offload_module_init(void);
+
+/*!
+ * @brief Runs a function in a worker thread and blocks the process until it has returned.
+ * @details Other processes keep running meanwhile. The process is woken up by a
+ *          PROCESS_EVENT_POLL once the function has returned.
+ * @param[in] offloadptr Pointer to the job control structure.
+ * @param[in] function Function to run.
+ * @param[in] arg Argument passed to the function.
+ */
+#define PROCESS_OFFLOAD(offloadptr, function, arg) \
+   do{ \
+      offload_submit(offloadptr, function, arg); \
+      PROCESS_WAIT_EVENT_UNTIL(offload_done(offloadptr)); \
+   }while(0)
+
+#endif /* CONFIG_MYOS_OFFLOAD */
+
+#endif /* OFFLOAD_H_ */
@@ -0,0 +1,332 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "pbuf.h"
+#include "itempool.h"
+
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_MYOS_PBUF)
+
+_Static_assert(CONFIG_MYOS_PBUF_HEADROOM < CONFIG_MYOS_PBUF_BLOCK_SIZE,
+               "the pbuf headroom must leave room for data in the first block");
+
+#define PBUF_BLOCK_SIZE CONFIG_MYOS_PBUF_BLOCK_SIZE
+
+ITEMPOOL_TYPEDEF_FREELIST(pbuf_block_pool,pbuf_block_t,CONFIG_MYOS_PBUF_BLOCK_COUNT);
+ITEMPOOL_TYPEDEF_FREELIST(pbuf_header_pool,pbuf_t,CONFIG_MYOS_PBUF_COUNT);
+
+static ITEMPOOL_T(pbuf_block_pool) pbuf_block_pool;
+static ITEMPOOL_T(pbuf_header_pool) pbuf_header_pool;
+
+
+static inline void pbuf_exhausted(void)
+{
+#if defined(CONFIG_MYOS_STATISTICS)
+   myos_stats.errflags.pbufpool = 1;
+#endif
+}
+
+static inline void pbuf_block_unref(pbuf_block_t *block)
+{
+   if(!--block->refs)
+   {
+      ITEMPOOL_FREE(pbuf_block_pool, block);
+   }
+}
+
+// Allocates a header for a window into block, the caller accounts the reference.
+static pbuf_t* pbuf_header(pbuf_block_t *block, size_t offset, size_t len)
+{
+   pbuf_t *p = ITEMPOOL_ALLOC(pbuf_header_pool);
+
+   if(!p)
+   {
+      pbuf_exhausted();
+      return NULL;
+   }
+   p->next = NULL;
+   p->block = block;
+   p->offset = (uint16_t)offset;
+   p->len = (uint16_t)len;
+   return p;
+}
+
+// Allocates a private block with its header.
+static pbuf_t* pbuf_segment(size_t offset, size_t len)
+{
+   pbuf_block_t *block = ITEMPOOL_ALLOC(pbuf_block_pool);
+   pbuf_t *p;
+
+   if(!block)
+   {
+      pbuf_exhausted();
+      return NULL;
+   }
+   p = pbuf_header(block, offset, len);
+   if(!p)
+   {
+      ITEMPOOL_FREE(pbuf_block_pool, block);
+      return NULL;
+   }
+   block->refs = 1;
+   return p;
+}
+
+
+pbuf_t* pbuf_alloc(size_t len)
+{
+   pbuf_t *head = NULL, **link = &head;
+   size_t offset = CONFIG_MYOS_PBUF_HEADROOM;
+
+   do
+   {
+      size_t seglen = MIN(len, PBUF_BLOCK_SIZE - offset);
+      pbuf_t *p = pbuf_segment(offset, seglen);
+
+      if(!p)
+      {
+         pbuf_free(head);
+         return NULL;
+      }
+      *link = p;
+      link = &p->next;
+      len -= seglen;
+      offset = 0;
+   }while(len);
+
+   return head;
+}
+
+
+void pbuf_free(pbuf_t *p)
+{
+   while(p)
+   {
+      pbuf_t *next = p->next;
+
+      pbuf_block_unref(p->block);
+      ITEMPOOL_FREE(pbuf_header_pool, p);
+      p = next;
+   }
+}
+
+
+pbuf_t* pbuf_share(const pbuf_t *p)
+{
+   pbuf_t *head = NULL, **link = &head;
+
+   for(; p; p = p->next)
+   {
+      pbuf_t *copy = pbuf_header(p->block, p->offset, p->len);
+
+      if(!copy)
+      {
+         pbuf_free(head);
+         return NULL;
+      }
+      p->block->refs++;
+      *link = copy;
+      link = &copy->next;
+   }
+
+   return head;
+}
+
+
+size_t pbuf_len(const pbuf_t *p)
+{
+   size_t len = 0;
+
+   for(; p; p = p->next)
+   {
+      len += p->len;
+   }
+   return len;
+}
+
+
+void* pbuf_push(pbuf_t **p, size_t len)
+{
+   pbuf_t *first = *p;
+
+   if(len > PBUF_BLOCK_SIZE)
+   {
+      return NULL;
+   }
+
+   // The headroom of a shared block may be in use by the other owner.
+   if(first->block->refs == 1 && first->offset >= len)
+   {
+      first->offset -= len;
+      first->len += len;
+      return pbuf_data(first);
+   }
+
+   first = pbuf_segment(PBUF_BLOCK_SIZE - len, len);
+   if(!first)
+   {
+      return NULL;
+   }
+   first->next = *p;
+   *p = first;
+   return pbuf_data(first);
+}
+
+
+bool pbuf_pull(pbuf_t **p, size_t len)
+{
+   if(pbuf_len(*p) < len)
+   {
+      return false;
+   }
+
+   while(len)
+   {
+      pbuf_t *first = *p;
+
+      if(first->len > len || !first->next)
+      {
+         first->offset += len;
+         first->len -= len;
+         break;
+      }
+      len -= first->len;
+      *p = first->next;
+      first->next = NULL;
+      pbuf_free(first);
+   }
+
+   return true;
+}
+
+
+void pbuf_cat(pbuf_t *head, pbuf_t *tail)
+{
+   while(head->next)
+   {
+      head = head->next;
+   }
+   head->next = tail;
+}
+
+
+pbuf_t* pbuf_split(pbuf_t *p, size_t offset)
+{
+   pbuf_t *rest;
+
+   if(!offset)
+   {
+      return NULL;
+   }
+
+   while(p && offset >= p->len)
+   {
+      if(offset == p->len)
+      {
+         // The cut is on a segment boundary, no header is needed.
+         rest = p->next;
+         p->next = NULL;
+         return rest;
+      }
+      offset -= p->len;
+      p = p->next;
+   }
+
+   if(!p)
+   {
+      return NULL;
+   }
+
+   rest = pbuf_header(p->block, p->offset + offset, p->len - offset);
+   if(!rest)
+   {
+      return NULL;
+   }
+   p->block->refs++;
+   rest->next = p->next;
+   p->next = NULL;
+   p->len = (uint16_t)offset;
+   return rest;
+}
+
+
+size_t pbuf_copy_out(const pbuf_t *p, size_t offset, void *buf, size_t len)
+{
+   uint8_t *dst = buf;
+   size_t copied = 0;
+
+   for(; p && copied < len; p = p->next)
+   {
+      size_t n;
+
+      if(offset >= p->len)
+      {
+         offset -= p->len;
+         continue;
+      }
+      n = MIN(p->len - offset, len - copied);
+      memcpy(dst + copied, pbuf_data(p) + offset, n);
+      copied += n;
+      offset = 0;
+   }
+   return copied;
+}
+
+
+size_t pbuf_copy_in(pbuf_t *p, size_t offset, const void *buf, size_t len)
+{
+   const uint8_t *src = buf;
+   size_t copied = 0;
+
+   for(; p && copied < len; p = p->next)
+   {
+      size_t n;
+
+      if(offset >= p->len)
+      {
+         offset -= p->len;
+         continue;
+      }
+      n = MIN(p->len - offset, len - copied);
+      memcpy(pbuf_data(p) + offset, src + copied, n);
+      copied += n;
+      offset = 0;
+   }
+   return copied;
+}
+
+
+void pbuf_module_init(void)
+{
+   ITEMPOOL_INIT(pbuf_block_pool);
+   ITEMPOOL_INIT(pbuf_header_pool);
+}
+
+#endif /* CONFIG_MYOS_PBUF */
@@ -0,0 +1,225 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file pbuf.h
+ * @brief Reference counted packet buffer chains.
+ *
+ * @details
+ * A packet is a chain of pbuf_t headers. Every header describes a window
+ * (offset, len) into a fixed-size block of CONFIG_MYOS_PBUF_BLOCK_SIZE bytes.
+ * Headers and blocks come from two free-list itempools; a block carries a
+ * reference count, so several headers, and with them several packets, can
+ * point into the same block.
+ *
+ * That makes the usual protocol operations copy free:
+ * - pbuf_push() prepends a header into the headroom of the first block, or
+ *   links a new block in front of it.
+ * - pbuf_pull() strips a header, pbuf_cat() appends a packet, pbuf_split()
+ *   cuts a packet in two and shares the block the cut falls into.
+ * - pbuf_share() gives a second owner its own header chain over the same
+ *   blocks, e.g. for a retransmission queue.
+ *
+ * A packet travels between processes by pointer, as event data or through a
+ * channel; the receiver owns it and frees it with pbuf_free(). Blocks shared
+ * with another chain must be treated as read only, pbuf_push() never writes
+ * into them.
+ *
+ * The pools are not locked, pbufs may only be used by the MyOS thread.
+ *
+ * @code
+ *     pbuf_t *p = pbuf_alloc(len);
+ *
+ *     if(p)
+ *     {
+ *        pbuf_copy_in(p, 0, payload, len);
+ *        hdr = pbuf_push(&p, sizeof(*hdr));
+ *        ...
+ *        process_post(&link_process, PBUF_EVENT_TX, p);
+ *     }
+ * @endcode
+ */
+
+#ifndef PBUF_H_
+#define PBUF_H_
+
+#include "myos.h"
+
+#if defined(CONFIG_MYOS_PBUF)
+
+/*!
+ * @struct pbuf_block_t
+ * @brief Data block shared by the pbuf_t headers pointing into it.
+ *
+ * @var pbuf_block_t::data
+ *      The payload bytes.
+ * @var pbuf_block_t::refs
+ *      Number of headers referencing the block.
+ */
+typedef struct {
+   uint8_t data[CONFIG_MYOS_PBUF_BLOCK_SIZE];
+   uint8_t refs;
+}pbuf_block_t;
+
+/*!
+ * @struct pbuf_t
+ * @brief Segment of a packet buffer chain.
+ *
+ * @var pbuf_t::next
+ *      Next segment of the packet, NULL for the last one.
+ * @var pbuf_t::block
+ *      Block holding the bytes of the segment.
+ * @var pbuf_t::offset
+ *      Offset of the first byte of the segment in the block.
+ * @var pbuf_t::len
+ *      Number of bytes in the segment.
+ */
+typedef struct pbuf_t {
+   struct pbuf_t *next;
+   pbuf_block_t *block;
+   uint16_t offset;
+   uint16_t len;
+}pbuf_t;
+
+/*!
+ * @brief Iterates over the segments of a packet.
+ */
+#define PBUF_FOREACH(p,seg) \
+   for(pbuf_t *seg = (p); seg; seg = seg->next)
+
+/*!
+ * @brief First byte of a segment.
+ */
+static inline uint8_t* pbuf_data(const pbuf_t *p)
+{
+   return p->block->data + p->offset;
+}
+
+/*!
+ * @brief Next segment of a packet, NULL after the last one.
+ */
+static inline pbuf_t* pbuf_next(const pbuf_t *p)
+{
+   return p->next;
+}
+
+/*!
+ * @brief Allocates a packet of len bytes.
+ * @details The first block keeps CONFIG_MYOS_PBUF_HEADROOM bytes in front of
+ *          the data for pbuf_push(). The content is not initialized.
+ * @param[in] len Packet length, may be 0.
+ * @return The packet, NULL if the pools are exhausted.
+ */
+pbuf_t* pbuf_alloc(size_t len);
+
+/*!
+ * @brief Frees a packet.
+ * @details The blocks return to the pool with their last reference.
+ * @param[in] p Packet, may be NULL.
+ */
+void pbuf_free(pbuf_t *p);
+
+/*!
+ * @brief Creates a second packet over the blocks of p.
+ * @details Only the headers are allocated, both packets own their headers
+ *          and must be freed separately.
+ * @param[in] p Packet to share.
+ * @return The new packet, NULL if the header pool is exhausted.
+ */
+pbuf_t* pbuf_share(const pbuf_t *p);
+
+/*!
+ * @brief Total number of bytes in a packet.
+ */
+size_t pbuf_len(const pbuf_t *p);
+
+/*!
+ * @brief Prepends len bytes to a packet.
+ * @details Uses the headroom of the first block if it is not shared, links a
+ *          new block in front otherwise. *p is updated in that case.
+ * @param[in,out] p Packet.
+ * @param[in] len Number of bytes, at most CONFIG_MYOS_PBUF_BLOCK_SIZE.
+ * @return The contiguous prepended bytes, NULL if the pools are exhausted.
+ */
+void* pbuf_push(pbuf_t **p, size_t len);
+
+/*!
+ * @brief Removes len bytes from the front of a packet.
+ * @details Segments which become empty are freed, but the last one is kept,
+ *          so the packet remains valid. *p is updated.
+ * @param[in,out] p Packet.
+ * @param[in] len Number of bytes.
+ * @return False if the packet is shorter than len, it is left unchanged then.
+ */
+bool pbuf_pull(pbuf_t **p, size_t len);
+
+/*!
+ * @brief Appends the packet tail to the packet head.
+ * @details The ownership of tail passes to head.
+ */
+void pbuf_cat(pbuf_t *head, pbuf_t *tail);
+
+/*!
+ * @brief Splits a packet in two.
+ * @details p keeps the first offset bytes. A block the cut falls into is
+ *          shared by both packets.
+ * @param[in] p Packet.
+ * @param[in] offset Length of the first part, 1 .. pbuf_len(p) - 1.
+ * @return The second part, NULL if offset is out of range or the header pool
+ *         is exhausted.
+ */
+pbuf_t* pbuf_split(pbuf_t *p, size_t offset);
+
+/*!
+ * @brief Copies bytes from a packet into a flat buffer.
+ * @param[in] p Packet.
+ * @param[in] offset Offset in the packet.
+ * @param[out] buf Destination.
+ * @param[in] len Number of bytes.
+ * @return Number of bytes copied, less than len if the packet ends before.
+ */
+size_t pbuf_copy_out(const pbuf_t *p, size_t offset, void *buf, size_t len);
+
+/*!
+ * @brief Copies bytes from a flat buffer into a packet.
+ * @param[in] p Packet.
+ * @param[in] offset Offset in the packet.
+ * @param[in] buf Source.
+ * @param[in] len Number of bytes.
+ * @return Number of bytes copied, less than len if the packet ends before.
+ */
+size_t pbuf_copy_in(pbuf_t *p, size_t offset, const void *buf, size_t len);
+
+/*!
+ * @brief Initializes the header and block pools.
+ */
+void pbuf_module_init(void);
+
+#endif /* CONFIG_MYOS_PBUF */
+
+#endif /* PBUF_H_ */
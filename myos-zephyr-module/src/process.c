@@ -35,138 +35,1516 @@
 #include "myos.h"
 #include <stdlib.h>
 #include "debug.h"
+#if defined(CONFIG_MYOS_PROC_EVENT_PAYLOAD_POOL) || defined(CONFIG_MYOS_PROC_SUSPEND)
+#include "itempool.h"
+#endif
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+#include "hash.h"
+#endif
+
+
+
+
+#if defined(CONFIG_MYOS_DEBUG_PROCESS)
+#define DBG(...) DBG_FUNC(__VA_ARGS__)
+#define DBG_PROCESS(...) do{DBG("[%d] process: ",(int)timestamp_now());DBG(__VA_ARGS__);}while(0)
+#else
+#define DBG(...) do{}while(0)
+#define DBG_PROCESS(...) do{}while(0)
+#endif
+
+/**
+ * @var process_current
+ * @brief Currently running process.
+ *
+ * @details
+ * Pointer to the currently running process in the system. This is used to keep track of the
+ * process context that is currently executing. It is set to NULL when no process is active.
+ * With CONFIG_MYOS_INSTANCES > 1 the thread of every instance has its own.
+ */
+PROCESS_THREAD_LOCAL process_t *process_current = NULL;
+
+#if CONFIG_MYOS_PROC_EVENT_PRIO_DEFAULT >= CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS
+#error "CONFIG_MYOS_PROC_EVENT_PRIO_DEFAULT must be less than CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS"
+#endif
+
+/**
+ * @typedef process_ref_t
+ * @brief Reference to a process as stored in the priority level queues.
+ *
+ * @details
+ * A process id with CONFIG_MYOS_PROC_STATIC_TABLE, a pointer otherwise.
+ */
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+typedef process_id_t process_ref_t;
+#define PROCESS_REF(processptr)  process_id(processptr)
+#define PROCESS_DEREF(ref)       process_by_id(ref)
+#else
+typedef process_t* process_ref_t;
+#define PROCESS_REF(processptr)  (processptr)
+#define PROCESS_DEREF(ref)       (ref)
+#endif
+
+/**
+ * @def PROCESS_EVENT_QUEUE_SIZE
+ * @brief Number of events of one priority level queue.
+ */
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_POW2)
+#define PROCESS_EVENT_QUEUE_SIZE (1u << CONFIG_MYOS_PROC_EVENT_QUEUE_BITS)
+#else
+#define PROCESS_EVENT_QUEUE_SIZE CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_SOA)
+/**
+ * @typedef process_event_record_t
+ * @brief Item of the priority level ringbuffers in the struct-of-arrays layout.
+ *
+ * @details
+ * The ringbuffer items are only the event ids, the other fields of a queued event are kept
+ * in the parallel arrays below at the same index. No field is padded, a slot takes
+ * 1 + 4 + 2 * sizeof(process_ref_t) bytes.
+ */
+typedef process_event_id_t process_event_record_t;
+#else
+/**
+ * @struct process_event_record_t
+ * @brief Event as stored in the priority level queues.
+ *
+ * @details
+ * Same as process_event_t, but refers to the processes by process_ref_t. With
+ * CONFIG_MYOS_PROC_STATIC_TABLE a record takes 8 instead of 16 bytes on 32-bit targets.
+ * process_run() expands it into a process_event_t for delivery.
+ */
+typedef struct {
+   process_event_id_t id;
+   process_ref_t from;
+   process_ref_t to;
+   void *data;
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   rtimer_timestamp_t posted;
+#endif
+}process_event_record_t;
+#endif
+
+/**
+ * @typedef process_event_queue
+ * @brief Ringbuffer type for storing process events.
+ *
+ * @details
+ * Defines a ringbuffer type for queuing process events. This ringbuffer holds events that are
+ * posted to processes and are pending to be processed. The size of the ringbuffer is defined by
+ * CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE, or by 2^CONFIG_MYOS_PROC_EVENT_QUEUE_BITS if
+ * CONFIG_MYOS_PROC_EVENT_QUEUE_POW2 is set. There is one ringbuffer per priority level.
+ *
+ * @param process_event_record_t Type of items in the ringbuffer (process events).
+ * @param MYOS_PROC_EVENT_QUEUE_SIZE Size of the ringbuffer, number of events it can hold.
+ */
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_POW2)
+RINGBUFFER_TYPEDEF_POW2(process_event_queue,process_event_record_t,CONFIG_MYOS_PROC_EVENT_QUEUE_BITS);
+#else
+RINGBUFFER_TYPEDEF(process_event_queue,process_event_record_t,CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE);
+#endif
+
+/**
+ * @typedef process_isr_event_queue
+ * @brief Lock-free ringbuffer type for storing events posted from ISRs.
+ *
+ * @details
+ * Single-producer/single-consumer ringbuffer, the producer is `process_post_isr`, the consumer
+ * is `process_run`. The size is defined by CONFIG_MYOS_PROC_ISR_EVENT_QUEUE_SIZE and must be a
+ * power of two.
+ */
+RINGBUFFER_SPSC_TYPEDEF(process_isr_event_queue,process_event_t,CONFIG_MYOS_PROC_ISR_EVENT_QUEUE_SIZE);
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+
+#define PROCESS_REMOTE_QUEUE_MASK (CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE - 1)
+
+_Static_assert((CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE & PROCESS_REMOTE_QUEUE_MASK) == 0,
+               "CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE must be a power of two");
+
+/**
+ * @brief Slot of the remote event mailbox.
+ *
+ * @details
+ * The sequence number tells the owner of the slot. It equals the claim position while the
+ * slot is free for a producer, the claim position + 1 once the event is published, and is
+ * advanced by the queue size when `process_run` hands the slot back.
+ */
+typedef struct {
+   atomic_t seq;
+   process_event_t evt;
+}process_remote_slot_t;
+
+#endif /* CONFIG_MYOS_PROC_POST_REMOTE */
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+
+/**
+ * @brief Entry of the earliest-deadline-first event queue.
+ *
+ * @details
+ * Entries with the same deadline are ordered by `seq`, i.e. in the order they were posted.
+ */
+typedef struct {
+   process_event_t evt;
+   timestamp_t deadline;
+   uint16_t seq;
+}process_edf_entry_t;
+
+/**
+ * @brief Returns true if entry a is more urgent than entry b.
+ */
+static inline bool process_edf_before(const process_edf_entry_t *a, const process_edf_entry_t *b)
+{
+   if(a->deadline != b->deadline)
+   {
+      return timestamp_less_than(a->deadline, b->deadline);
+   }
+   return (int16_t)(a->seq - b->seq) < 0;
+}
+
+#endif /* CONFIG_MYOS_PROC_EVENT_EDF */
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT) && CONFIG_MYOS_PROC_POST_QUOTA > 0
+#define process_quota_take(processptr)    do{ if(processptr) (processptr)->queued++; }while(0)
+#define process_quota_give(processptr)    do{ if(processptr) (processptr)->queued--; }while(0)
+#define PROCESS_QUOTA_REACHED(processptr) ((processptr)->queued >= CONFIG_MYOS_PROC_POST_QUOTA)
+#else
+#define process_quota_take(processptr)    do{}while(0)
+#define process_quota_give(processptr)    do{}while(0)
+#define PROCESS_QUOTA_REACHED(processptr) false
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_PAYLOAD_POOL)
+/**
+ * @typedef process_payload_t
+ * @brief Event payload slot with its reference count.
+ *
+ * @details
+ * The payload is the first member, so the pointer handed out by `process_post_alloc`
+ * is the address of the slot. The union aligns the payload for any scalar type.
+ */
+typedef struct {
+   union {
+      uint8_t bytes[CONFIG_MYOS_PROC_EVENT_PAYLOAD_SIZE];
+      long long ll;
+      double d;
+      void *p;
+   } data;
+   uint8_t refs;
+} process_payload_t;
+
+/**
+ * @typedef process_payload_pool
+ * @brief Free-list itempool type for event payloads.
+ */
+ITEMPOOL_TYPEDEF_FREELIST(process_payload_pool,process_payload_t,CONFIG_MYOS_PROC_EVENT_PAYLOAD_COUNT);
+
+/**
+ * @var process_payload_pool
+ * @brief Pool of event payload slots.
+ */
+static ITEMPOOL_T(process_payload_pool) process_payload_pool;
+
+/**
+ * @brief Takes a reference to a pooled payload for a posted event.
+ *
+ * @param data Event data, ignored if it is not a pooled payload.
+ */
+static inline void process_payload_ref(void *data)
+{
+   if(ITEMPOOL_CONTAINS(process_payload_pool, data))
+   {
+      ((process_payload_t*)data)->refs++;
+   }
+}
+
+/**
+ * @brief Drops the reference of a handled event to a pooled payload.
+ *
+ * @details
+ * Returns the payload slot to the pool with the last reference.
+ *
+ * @param data Event data, ignored if it is not a pooled payload.
+ */
+static inline void process_payload_unref(void *data)
+{
+   if(ITEMPOOL_CONTAINS(process_payload_pool, data))
+   {
+      process_payload_t *payload = data;
+
+      if(payload->refs && !--payload->refs)
+      {
+         ITEMPOOL_FREE(process_payload_pool, payload);
+      }
+   }
+}
+
+/**
+ * @brief Asserts that event data posted from an ISR or another thread is not a pooled payload.
+ *
+ * @details
+ * The references are not atomic and the pool is not shared between threads, so these
+ * events take no reference.
+ *
+ * @param data Event data.
+ */
+static inline void process_payload_reject(void *data)
+{
+   __ASSERT(!ITEMPOOL_CONTAINS(process_payload_pool, data),
+            "pooled payloads must not be posted from ISRs or other threads");
+}
+#else
+#define process_payload_ref(data)      do{}while(0)
+#define process_payload_unref(data)    do{}while(0)
+#define process_payload_reject(data)   do{}while(0)
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+/**
+ * @struct process_parked_t
+ * @brief Event parked for a suspended process.
+ *
+ * @details
+ * The parked events of a process form a FIFO from process_t::parkhead to
+ * process_t::parktail. A parked event keeps the reference to its pooled payload.
+ */
+typedef struct process_parked_t {
+   process_event_t evt;
+   struct process_parked_t *next;
+} process_parked_t;
+
+/**
+ * @typedef process_parked_pool
+ * @brief Free-list itempool type for parked events.
+ */
+ITEMPOOL_TYPEDEF_FREELIST(process_parked_pool,process_parked_t,CONFIG_MYOS_PROC_SUSPEND_PARK_COUNT);
+#endif
+
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+/**
+ * @brief Counts a value in a log2-bucketed histogram.
+ */
+static inline void process_stats_count(uint32_t *hist, uint32_t value)
+{
+   uint32_t bucket = value ? 32 - __builtin_clz(value) : 0;
+
+   if(bucket >= CONFIG_MYOS_STATISTICS_HIST_BUCKETS)
+   {
+      bucket = CONFIG_MYOS_STATISTICS_HIST_BUCKETS - 1;
+   }
+   hist[bucket]++;
+}
+
+/**
+ * @brief Accounts a delivered event in the histograms of the current process.
+ */
+static inline void process_stats_event(process_event_t *evt, rtimer_timestamp_t start, rtimer_timestamp_t stop)
+{
+   process_stats_t *stats = &PROCESS_THIS()->stats;
+   timestamp_t now = timestamp_now();
+
+   process_stats_count(stats->slicetime, (rtimer_timespan_t)(stop - start));
+   process_stats_count(stats->waittime, (rtimer_timespan_t)(start - evt->posted));
+
+   if(TIMESTAMP_DIFF(now, stats->rate_start) >= TIMESTAMP_TICKS_PER_SEC)
+   {
+      if(stats->rate_count)
+      {
+         process_stats_count(stats->rate, stats->rate_count);
+      }
+      stats->rate_start = now;
+      stats->rate_count = 0;
+   }
+   stats->rate_count++;
+}
+
+#define process_stats_posted(evtptr)   ((evtptr)->posted = rtimer_now())
+#else
+#define process_stats_posted(evtptr)   do{}while(0)
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+#define PROCESS_COALESCE_INDEX_MASK (CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE - 1)
+
+_Static_assert((CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE & PROCESS_COALESCE_INDEX_MASK) == 0,
+               "CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE must be a power of two");
+
+/**
+ * @struct process_coalesce_entry_t
+ * @brief Entry of the index of pending coalescable events.
+ *
+ * @var process_coalesce_entry_t::to
+ * Target of the pending event.
+ * @var process_coalesce_entry_t::id
+ * Id of the pending event.
+ * @var process_coalesce_entry_t::used
+ * Set if the entry is occupied.
+ * @var process_coalesce_entry_t::slot
+ * Index of the pending event in the default priority level queue.
+ */
+typedef struct {
+   process_ref_t to;
+   process_event_id_t id;
+   bool used;
+   uint16_t slot;
+}process_coalesce_entry_t;
+
+/**
+ * @brief Home position of a key in the coalesce index.
+ */
+static inline size_t process_coalesce_home(process_ref_t to, process_event_id_t id)
+{
+   return hash_murmur3_fmix(hash_murmur3_acc(id, (uint32_t)(uintptr_t)to)) & PROCESS_COALESCE_INDEX_MASK;
+}
+#endif
+
+
+/**
+ * @struct myos_instance_t
+ * @brief Scheduler state of a MyOS instance.
+ *
+ * @details
+ * Every instance runs `process_run` in a thread of its own, see `myos_instance_start`. A
+ * process belongs to the instance which started it, and its events are only delivered by
+ * the thread of that instance. Events for a process of another instance are handed over
+ * through the mailbox of that instance, see `process_post_remote`. The timers and the
+ * tasklets are served by the first instance.
+ */
+typedef struct {
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   /**
+    * Processes of the instance which are currently active. The implementation of the list
+    * is determined by the configuration (singly or doubly linked list).
+    */
+   plist_t running_list;
+
+   /*
+    * While a broadcast is delivered to running_hinted, running_prev is a node in front of it,
+    * so that a termination or suspension during the delivery erases it in O(1).
+    */
+   process_t *running_hinted;
+   plist_node_t *running_prev;
+#endif
+
+   /**
+    * Ringbuffers of the queued events, indexed by priority level (0 is the highest). Within a
+    * level events are handled in a FIFO manner, a level is only served while all higher
+    * levels are empty.
+    */
+   RINGBUFFER_T(process_event_queue) event_queue[CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS];
+
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_SOA)
+   /** Data fields of the queued events, indexed like the items of `event_queue`. */
+   void *event_queue_data[CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS][PROCESS_EVENT_QUEUE_SIZE];
+
+   /** Senders of the queued events, indexed like the items of `event_queue`. */
+   process_ref_t event_queue_from[CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS][PROCESS_EVENT_QUEUE_SIZE];
+
+   /** Targets of the queued events, indexed like the items of `event_queue`. */
+   process_ref_t event_queue_to[CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS][PROCESS_EVENT_QUEUE_SIZE];
+
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   /** Post timestamps of the queued events, indexed like the items of `event_queue`. */
+   rtimer_timestamp_t event_queue_posted[CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS][PROCESS_EVENT_QUEUE_SIZE];
+#endif
+#endif
+
+   /** Number of events queued over all priority levels. */
+   size_t event_count;
+
+   /** Events posted from ISRs. */
+   RINGBUFFER_T(process_isr_event_queue) isr_event_queue;
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+   /** Bounded multi-producer/single-consumer mailbox for `process_post_remote`. */
+   process_remote_slot_t remote_queue[CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE];
+
+   /** Next position claimed by a producer, shared by all producers. */
+   atomic_t remote_tail;
+
+   /** Next position read by `process_run`, only touched by the thread of the instance. */
+   atomic_val_t remote_head;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+   /** Binary min-heap of the deadline events, the most urgent one is at index 0. */
+   process_edf_entry_t edf_queue[CONFIG_MYOS_PROC_EDF_QUEUE_SIZE];
+   size_t edf_count;
+   uint16_t edf_seq;
+#endif
+
+   /**
+    * First and last process in the pending-poll queue. Processes which requested to be
+    * polled are linked through `process_t::pollnext` in the order of their requests. As
+    * long as the queue is not empty, poll requests are handled before the queued events.
+    * The queue is modified by ISRs, so all accesses are done within critical sections.
+    */
+   process_t * volatile poll_head;
+   process_t *poll_tail;
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+   /**
+    * First and last process waiting for room in the event queue. Processes which could not
+    * post with `process_post_or_wait` are linked through `process_t::postwaitnext` in the
+    * order of their attempts.
+    */
+   process_t *postwait_head;
+   process_t *postwait_tail;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+   /** Pool of parked event slots, shared by all suspended processes of the instance. */
+   ITEMPOOL_T(process_parked_pool) parked_pool;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+   /**
+    * Open-addressing hash index of the events queued by `process_post_coalesce`, keyed by
+    * target and event id, linear probing. At most half of the entries are used, so probe
+    * sequences stay short. Deleted entries are closed by shifting back their successors.
+    */
+   process_coalesce_entry_t coalesce_index[CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE];
+   size_t coalesce_count;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+   /** Scratch arena of `process_scratch_alloc`, over a region of `process_scratch_region`. */
+   arena_t scratch;
+#endif
+}myos_instance_t;
+
+/**
+ * @var myos_instances
+ * @brief The MyOS instances, the first one is run by `myos_run_forever`.
+ */
+static UTILS_HOT_BSS myos_instance_t myos_instances[CONFIG_MYOS_INSTANCES];
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+static uint8_t process_scratch_region[CONFIG_MYOS_INSTANCES][CONFIG_MYOS_PROC_SCRATCH_SIZE] __attribute__((aligned(ARENA_ALIGNMENT)));
+#endif
+
+/**
+ * @def PROCESS_INSTANCE()
+ * @brief The instance of the calling thread.
+ *
+ * @def PROCESS_INSTANCE_OF(processptr)
+ * @brief The instance a process belongs to, the first one for PROCESS_BROADCAST.
+ *
+ * @def PROCESS_IS_LOCAL(processptr)
+ * @brief Check if a process belongs to the instance of the calling thread.
+ */
+#if CONFIG_MYOS_INSTANCES > 1
+static PROCESS_THREAD_LOCAL myos_instance_t *process_instance = &myos_instances[0];
+
+#define PROCESS_INSTANCE()                process_instance
+#define PROCESS_INSTANCE_ID(processptr)   ((processptr) ? (processptr)->instance : 0)
+#define PROCESS_INSTANCE_OF(processptr)   (&myos_instances[PROCESS_INSTANCE_ID(processptr)])
+#define PROCESS_IS_LOCAL(processptr)      (PROCESS_INSTANCE_OF(processptr) == PROCESS_INSTANCE())
+#define PROCESS_WAKEUP(processptr)        myos_instance_wakeup(PROCESS_INSTANCE_ID(processptr))
+#else
+#define PROCESS_INSTANCE()                (&myos_instances[0])
+#define PROCESS_INSTANCE_OF(processptr)   (&myos_instances[0])
+#define PROCESS_IS_LOCAL(processptr)      true
+#define PROCESS_WAKEUP(processptr)        myos_wakeup()
+#endif
+
+#if defined(CONFIG_MYOS_DEFER) && CONFIG_MYOS_INSTANCES > 1
+// The tasklets are run by the first instance.
+#define PROCESS_DEFER_RUN() do{ if(PROCESS_INSTANCE() == &myos_instances[0]) defer_run(); }while(0)
+#define PROCESS_DEFER_PENDING() (PROCESS_INSTANCE() == &myos_instances[0] ? defer_pending() : 0)
+#elif defined(CONFIG_MYOS_DEFER)
+#define PROCESS_DEFER_RUN() defer_run()
+#define PROCESS_DEFER_PENDING() defer_pending()
+#else
+#define PROCESS_DEFER_RUN() do{}while(0)
+#define PROCESS_DEFER_PENDING() 0
+#endif
+
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+/**
+ * @brief Removes a process from the running list of the instance.
+ *
+ * @details
+ * Starts the search for the predecessor at `running_prev` if the process is the one the
+ * broadcast loop delivers to, at the list head otherwise. A hint which has left the list during
+ * the delivery is not used.
+ */
+static void process_running_erase(process_t *process)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   plist_node_t *hint = (plist_node_t*)&instance->running_list;
+
+   if(process == instance->running_hinted && instance->running_prev != hint)
+   {
+      process_t *prev = (process_t*)instance->running_prev;
+
+      if(PROCESS_IS_RUNNING(prev) && !PROCESS_IS_SUSPENDED(prev))
+      {
+         hint = instance->running_prev;
+      }
+   }
+
+   plist_erase_hint(&instance->running_list, hint, process);
+}
+#endif
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+/**
+ * @brief Returns the published slot at the head of the mailbox, NULL if there is none.
+ */
+static inline process_remote_slot_t* process_remote_head_slot(myos_instance_t *instance)
+{
+   process_remote_slot_t *slot = &instance->remote_queue[instance->remote_head & PROCESS_REMOTE_QUEUE_MASK];
+
+   return atomic_get(&slot->seq) == instance->remote_head + 1 ? slot : NULL;
+}
+
+/**
+ * @brief Hands the head slot back to the producers.
+ */
+static inline void process_remote_pop(myos_instance_t *instance, process_remote_slot_t *slot)
+{
+   atomic_set(&slot->seq, instance->remote_head + CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE);
+   instance->remote_head++;
+}
+
+#define PROCESS_REMOTE_PENDING() (process_remote_head_slot(PROCESS_INSTANCE()) != NULL)
+
+#else
+
+#define PROCESS_REMOTE_PENDING() 0
+
+#endif /* CONFIG_MYOS_PROC_POST_REMOTE */
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+/**
+ * @brief Removes the most urgent entry from the heap and returns a copy of it.
+ */
+static void process_edf_pop(process_edf_entry_t *head)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   process_edf_entry_t *queue = instance->edf_queue;
+   size_t i = 0;
+   process_edf_entry_t last = queue[--instance->edf_count];
+
+   *head = queue[0];
+
+   // Sift the last entry down from the root.
+   for(;;)
+   {
+      size_t child = 2 * i + 1;
+
+      if(child >= instance->edf_count)
+      {
+         break;
+      }
+      if(child + 1 < instance->edf_count && process_edf_before(&queue[child + 1], &queue[child]))
+      {
+         child++;
+      }
+      if(!process_edf_before(&queue[child], &last))
+      {
+         break;
+      }
+      queue[i] = queue[child];
+      i = child;
+   }
+   queue[i] = last;
+}
+
+#define PROCESS_EDF_COUNT() (PROCESS_INSTANCE()->edf_count)
+
+#else
+
+#define PROCESS_EDF_COUNT() 0
+
+#endif /* CONFIG_MYOS_PROC_EVENT_EDF */
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+/**
+ * @brief Polls the first process waiting for room in the event queue.
+ *
+ * @details
+ * Called whenever an event was taken from a priority level queue. The woken process takes
+ * its place at the end of the queue again if its next try fails.
+ */
+static inline void process_postwait_wakeup(void)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   process_t *process = instance->postwait_head;
+
+   if(process)
+   {
+      instance->postwait_head = process->postwaitnext;
+      if(!instance->postwait_head)
+      {
+         instance->postwait_tail = NULL;
+      }
+      process->postwait = false;
+      process_poll(process);
+   }
+}
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+/**
+ * @brief Parks an event at the end of the FIFO of its suspended target.
+ *
+ * @param evt The event.
+ * @return True if the event was parked, False if the pool is exhausted.
+ */
+static bool process_park(const process_event_t *evt)
+{
+   process_parked_t *parked = ITEMPOOL_ALLOC(PROCESS_INSTANCE()->parked_pool);
+   process_t *to = evt->to;
+
+   if(!parked)
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.parkpool = 1;
+#endif
+      return false;
+   }
+
+   parked->evt = *evt;
+   parked->next = NULL;
+
+   if(to->parktail)
+   {
+      to->parktail->next = parked;
+   }
+   else
+   {
+      to->parkhead = parked;
+   }
+   to->parktail = parked;
+
+   return true;
+}
+
+/**
+ * @brief Puts a suspended process back into the list of running processes.
+ *
+ * @param process The process.
+ * @return The FIFO of its parked events, detached from the process.
+ */
+static process_parked_t* process_unsuspend(process_t *process)
+{
+   process_parked_t *parked = process->parkhead;
+
+   process->suspended = PROCESS_SUSPEND_NONE;
+   process->parkhead = NULL;
+   process->parktail = NULL;
+
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   plist_push_front(&PROCESS_INSTANCE()->running_list, process);
+#endif
+
+   return parked;
+}
+
+/**
+ * @brief Returns parked events to the pool without delivering them.
+ *
+ * @param parked A FIFO of parked events.
+ */
+static void process_parked_discard(process_parked_t *parked)
+{
+   while(parked)
+   {
+      process_parked_t *next = parked->next;
+
+      process_payload_unref(parked->evt.data);
+      ITEMPOOL_FREE(PROCESS_INSTANCE()->parked_pool, parked);
+      parked = next;
+   }
+}
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+/**
+ * @brief Looks up the pending coalescable event of a target with a given id.
+ *
+ * @return The index entry, NULL if there is none.
+ */
+static process_coalesce_entry_t* process_coalesce_find(process_ref_t to, process_event_id_t id)
+{
+   process_coalesce_entry_t *index = PROCESS_INSTANCE()->coalesce_index;
+
+   for(size_t i = process_coalesce_home(to, id); index[i].used; i = (i + 1) & PROCESS_COALESCE_INDEX_MASK)
+   {
+      if(index[i].to == to && index[i].id == id)
+      {
+         return &index[i];
+      }
+   }
+   return NULL;
+}
+
+/**
+ * @brief Removes an entry from the coalesce index.
+ *
+ * @details
+ * Moves the following entries of the probe sequence back, which could not be found from
+ * their home position anymore otherwise.
+ */
+static void process_coalesce_erase(process_coalesce_entry_t *entry)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   process_coalesce_entry_t *index = instance->coalesce_index;
+   size_t i = entry - index;
+   size_t j = i;
+
+   for(;;)
+   {
+      j = (j + 1) & PROCESS_COALESCE_INDEX_MASK;
+      if(!index[j].used)
+      {
+         break;
+      }
+
+      size_t home = process_coalesce_home(index[j].to, index[j].id);
+
+      // The entry may fill the gap if the gap lies between its home position and itself.
+      if(((j - home) & PROCESS_COALESCE_INDEX_MASK) >= ((j - i) & PROCESS_COALESCE_INDEX_MASK))
+      {
+         index[i] = index[j];
+         i = j;
+      }
+   }
+
+   index[i].used = false;
+   instance->coalesce_count--;
+}
+
+/**
+ * @brief Drops the index entry of an event which is taken from the default priority level.
+ *
+ * @details
+ * Plain posts with the same target and id may be queued in other slots, only the entry of
+ * this very slot is removed.
+ */
+static inline void process_coalesce_forget(process_event_prio_t prio, size_t slot, process_ref_t to, process_event_id_t id)
+{
+   if(PROCESS_INSTANCE()->coalesce_count && prio == PROCESS_EVENT_PRIO_DEFAULT)
+   {
+      process_coalesce_entry_t *entry = process_coalesce_find(to, id);
+
+      if(entry && entry->slot == slot)
+      {
+         process_coalesce_erase(entry);
+      }
+   }
+}
+#else
+#define process_coalesce_forget(prio,slot,to,id)   do{ (void)(slot); }while(0)
+#endif
+
+/**
+ * @def PROCESS_PENDING()
+ * @brief Count of the events, tasklets and poll requests pending in the instance of the calling thread.
+ */
+#define PROCESS_PENDING() \
+   (PROCESS_INSTANCE()->event_count + RINGBUFFER_SPSC_COUNT(PROCESS_INSTANCE()->isr_event_queue) + \
+    PROCESS_REMOTE_PENDING() + PROCESS_EDF_COUNT() + PROCESS_DEFER_PENDING() + (PROCESS_INSTANCE()->poll_head != NULL))
+
+
+/**
+ * @brief Queues an event at the tail of a priority level.
+ *
+ * @details
+ * The caller has to check that the level is not full.
+ */
+static inline void process_event_queue_push(process_event_prio_t prio, process_t *to, process_event_id_t evtid, void* data)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_SOA)
+   size_t slot = RINGBUFFER_TAIL(instance->event_queue[prio]);
+
+   RINGBUFFER_TAIL_VAL(instance->event_queue[prio]) = evtid;
+   instance->event_queue_data[prio][slot] = data;
+   instance->event_queue_from[prio][slot] = PROCESS_REF(PROCESS_THIS());
+   instance->event_queue_to[prio][slot] = PROCESS_REF(to);
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   instance->event_queue_posted[prio][slot] = rtimer_now();
+#endif
+#else
+   process_event_record_t *record = RINGBUFFER_TAIL_PTR(instance->event_queue[prio]);
+
+   record->id = evtid;
+   record->from = PROCESS_REF(PROCESS_THIS());
+   record->to = PROCESS_REF(to);
+   record->data = data;
+   process_stats_posted(record);
+#endif
+
+   RINGBUFFER_PUSH(instance->event_queue[prio]);
+   process_quota_take(PROCESS_THIS());
+}
+
+
+/**
+ * @brief Takes the event at the head of a priority level.
+ *
+ * @details
+ * Expands the queued event into `evt` and frees its slot, so the event handler may post into
+ * it again. The caller has to check that the level is not empty.
+ */
+static inline void process_event_queue_pop(process_event_prio_t prio, process_event_t *evt)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_SOA)
+   size_t slot = RINGBUFFER_HEAD(instance->event_queue[prio]);
+
+   evt->id = RINGBUFFER_HEAD_VAL(instance->event_queue[prio]);
+   evt->data = instance->event_queue_data[prio][slot];
+   evt->from = PROCESS_DEREF(instance->event_queue_from[prio][slot]);
+   evt->to = PROCESS_DEREF(instance->event_queue_to[prio][slot]);
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   evt->posted = instance->event_queue_posted[prio][slot];
+#endif
+   process_coalesce_forget(prio, slot, instance->event_queue_to[prio][slot], evt->id);
+#else
+   size_t slot = RINGBUFFER_HEAD(instance->event_queue[prio]);
+   process_event_record_t *record = RINGBUFFER_HEAD_PTR(instance->event_queue[prio]);
+
+   evt->id = record->id;
+   evt->data = record->data;
+   evt->from = PROCESS_DEREF(record->from);
+   evt->to = PROCESS_DEREF(record->to);
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   evt->posted = record->posted;
+#endif
+   process_coalesce_forget(prio, slot, record->to, evt->id);
+#endif
+
+   RINGBUFFER_POP(instance->event_queue[prio]);
+   process_quota_give(evt->from);
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+   process_postwait_wakeup();
+#endif
+}
+
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+/**
+ * @brief Returns the location of the data field of a queued event.
+ */
+static inline void** process_event_queue_data_ptr(process_event_prio_t prio, size_t slot)
+{
+#if defined(CONFIG_MYOS_PROC_EVENT_QUEUE_SOA)
+   return &PROCESS_INSTANCE()->event_queue_data[prio][slot];
+#else
+   return &RINGBUFFER_ITEMS(PROCESS_INSTANCE()->event_queue[prio])[slot].data;
+#endif
+}
+#endif
+
+
+/**
+ * @brief Initializes the scheduler state of an instance.
+ */
+static void process_instance_init(myos_instance_t *instance)
+{
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   /* Initialize the list for running processes. */
+   plist_init(&instance->running_list);
+   instance->running_hinted = NULL;
+   instance->running_prev = NULL;
+#endif
+
+   /* Initialize the ring buffers for the process event queue. */
+   for(process_event_prio_t prio = 0; prio < CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS; prio++)
+   {
+      RINGBUFFER_INIT(instance->event_queue[prio]);
+   }
+   instance->event_count = 0;
+
+   instance->poll_head = NULL;
+   instance->poll_tail = NULL;
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+   instance->postwait_head = NULL;
+   instance->postwait_tail = NULL;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+   memset(instance->coalesce_index, 0, sizeof(instance->coalesce_index));
+   instance->coalesce_count = 0;
+#endif
+
+   /* Initialize the lock-free ring buffer for events posted from ISRs. */
+   RINGBUFFER_SPSC_INIT(instance->isr_event_queue);
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+   /* Hand all mailbox slots to the producers. */
+   for(atomic_val_t pos = 0; pos < CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE; pos++)
+   {
+      atomic_set(&instance->remote_queue[pos].seq, pos);
+   }
+   atomic_set(&instance->remote_tail, 0);
+   instance->remote_head = 0;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+   instance->edf_count = 0;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+   /* Initialize the pool of parked event slots. */
+   ITEMPOOL_INIT(instance->parked_pool);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+   size_t idx = instance - myos_instances;
+
+   arena_init(&instance->scratch, process_scratch_region[idx], sizeof(process_scratch_region[idx]));
+#endif
+}
+
+
+void process_init(void)
+{
+
+#if defined(CONFIG_MYOS_PROC_LIST_TYPE_SLIST)
+   DBG_PROCESS("Using singly-linked list for process management.\n");
+#elif defined(CONFIG_MYOS_PROC_LIST_TYPE_DLIST)
+   DBG_PROCESS("Using doubly-linked list for process management.\n");
+#endif
+
+   DBG_PROCESS("Using %d event queue(s) of size %d \n",CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS,RINGBUFFER_SIZE(myos_instances[0].event_queue[0]));
+
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   size_t count;
+
+   STRUCT_SECTION_COUNT(process_t, &count);
+   DBG_PROCESS("Using a static process table of %d processes\n", (int)count);
+#endif
+
+   DBG_PROCESS("Using %d instance(s)\n", CONFIG_MYOS_INSTANCES);
+
+   for(size_t idx = 0; idx < CONFIG_MYOS_INSTANCES; idx++)
+   {
+      process_instance_init(&myos_instances[idx]);
+   }
+
+#if defined(CONFIG_MYOS_PROC_EVENT_PAYLOAD_POOL)
+   /* Initialize the pool of event payload slots. */
+   ITEMPOOL_INIT(process_payload_pool);
+#endif
+
+   /* Set the current process to NULL, indicating no process is running. */
+   PROCESS_THIS() = NULL;
+}
+
+
+bool process_post(process_t *to, process_event_id_t evtid, void* data)
+{
+   return process_post_prio(to, evtid, data, PROCESS_EVENT_PRIO_DEFAULT);
+}
+
+
+UTILS_HOT_FUNC bool process_post_prio(process_t *to, process_event_id_t evtid, void* data, process_event_prio_t prio)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+
+   if(prio >= CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS)
+   {
+      return false;
+   }
+
+   // Check if the event queue is full.
+   if(RINGBUFFER_FULL(instance->event_queue[prio]))
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.eventqueue = 1;
+#endif
+      return false;
+   }
+
+   DBG_PROCESS("post from %p to %p evtid=%d prio=%d ...\n", (void*)PROCESS_THIS(), (void*)to, evtid, prio);
+
+   // Push the event onto the event queue.
+   process_event_queue_push(prio, to, evtid, data);
+   instance->event_count++;
+   TRACE(TRACE_POST, evtid, prio, PROCESS_THIS(), to);
+   process_payload_ref(data);
+
+#if defined(CONFIG_MYOS_STATISTICS)
+   // Update the maximum queue count for statistics.
+   if(RINGBUFFER_COUNT(instance->event_queue[prio]) > myos_stats.maxqueuecount)
+   {
+      myos_stats.maxqueuecount = RINGBUFFER_COUNT(instance->event_queue[prio]);
+   }
+#endif
+
+   return true;
+}
+
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+bool process_post_or_wait(process_t *to, process_event_id_t evtid, void* data)
+{
+   process_t *process = PROCESS_THIS();
+   myos_instance_t *instance = PROCESS_INSTANCE();
+
+   if(!PROCESS_QUOTA_REACHED(process) && process_post(to, evtid, data))
+   {
+      return true;
+   }
+
+   DBG_PROCESS("post from %p to %p evtid=%d has to wait\n", (void*)process, (void*)to, evtid);
+
+   if(!process->postwait)
+   {
+      process->postwait = true;
+      process->postwaitnext = NULL;
+
+      if(instance->postwait_tail)
+      {
+         instance->postwait_tail->postwaitnext = process;
+      }
+      else
+      {
+         instance->postwait_head = process;
+      }
+      instance->postwait_tail = process;
+   }
 
+   return false;
+}
+#endif
 
 
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+bool process_post_coalesce(process_t *to, process_event_id_t evtid, void* data)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   process_coalesce_entry_t *entry = process_coalesce_find(PROCESS_REF(to), evtid);
 
-#if defined(CONFIG_MYOS_DEBUG_PROCESS)
-#define DBG(...) DBG_FUNC(__VA_ARGS__)
-#define DBG_PROCESS(...) do{DBG("[%d] process: ",(int)timestamp_now());DBG(__VA_ARGS__);}while(0)
-#else
-#define DBG(...) do{}while(0)
-#define DBG_PROCESS(...) do{}while(0)
+   if(entry)
+   {
+      // Replace the data of the pending event, it keeps its place in the queue.
+      void **pending = process_event_queue_data_ptr(PROCESS_EVENT_PRIO_DEFAULT, entry->slot);
+
+      DBG_PROCESS("coalesce to %p evtid=%d ...\n", (void*)to, evtid);
+
+      process_payload_ref(data);
+      process_payload_unref(*pending);
+      *pending = data;
+      return true;
+   }
+
+   size_t slot = RINGBUFFER_TAIL(instance->event_queue[PROCESS_EVENT_PRIO_DEFAULT]);
+
+   if(!process_post(to, evtid, data))
+   {
+      return false;
+   }
+
+   // With the index half full, the event is queued like a plain post.
+   if(instance->coalesce_count < CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE / 2)
+   {
+      size_t i = process_coalesce_home(PROCESS_REF(to), evtid);
+
+      while(instance->coalesce_index[i].used)
+      {
+         i = (i + 1) & PROCESS_COALESCE_INDEX_MASK;
+      }
+      instance->coalesce_index[i] = (process_coalesce_entry_t){
+         .to = PROCESS_REF(to),
+         .id = evtid,
+         .used = true,
+         .slot = slot
+      };
+      instance->coalesce_count++;
+   }
+
+   return true;
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+bool process_post_deadline(process_t *to, process_event_id_t evtid, void* data, timestamp_t deadline)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   size_t i;
+   process_edf_entry_t entry;
+
+   if(instance->edf_count >= CONFIG_MYOS_PROC_EDF_QUEUE_SIZE)
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.eventqueue = 1;
+#endif
+      return false;
+   }
+
+   entry.evt.from = PROCESS_THIS();
+   entry.evt.to = to;
+   entry.evt.id = evtid;
+   entry.evt.data = data;
+   process_stats_posted(&entry.evt);
+   entry.deadline = deadline;
+   entry.seq = instance->edf_seq++;
+
+   DBG_PROCESS("post from %p to %p evtid=%d deadline=%d ...\n", (void*)entry.evt.from, (void*)to, evtid, (int)deadline);
+
+   // Sift the new entry up from the end of the heap.
+   for(i = instance->edf_count++; i > 0; i = (i - 1) / 2)
+   {
+      process_edf_entry_t *parent = &instance->edf_queue[(i - 1) / 2];
+
+      if(!process_edf_before(&entry, parent))
+      {
+         break;
+      }
+      instance->edf_queue[i] = *parent;
+   }
+   instance->edf_queue[i] = entry;
+
+   TRACE(TRACE_POST_DEADLINE, evtid, (uint16_t)deadline, PROCESS_THIS(), to);
+   process_payload_ref(data);
+
+   return true;
+}
+#endif
+
+
+UTILS_HOT_FUNC bool process_post_isr(process_t *to, process_event_id_t evtid, void* data)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE_OF(to);
+   process_event_t *evt;
+
+   process_payload_reject(data);
+
+   // Check if the ISR event queue is full.
+   if(RINGBUFFER_SPSC_FULL(instance->isr_event_queue))
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.eventqueue = 1;
 #endif
+      return false;
+   }
+
+   // Fill in the free slot, it is not visible to process_run before the push.
+   evt = RINGBUFFER_SPSC_TAIL_PTR(instance->isr_event_queue);
+   evt->from = NULL;
+   evt->to = to;
+   evt->id = evtid;
+   evt->data = data;
+   process_stats_posted(evt);
+
+   RINGBUFFER_SPSC_PUSH(instance->isr_event_queue);
+   TRACE(TRACE_POST_ISR, evtid, 0, NULL, to);
+
+   PROCESS_WAKEUP(to);
 
+   return true;
+}
+
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
 /**
- * @var process_current
- * @brief Currently running process.
+ * @brief Queues an event in the mailbox of the instance of its target.
  *
- * @details
- * Pointer to the currently running process in the system. This is used to keep track of the
- * process context that is currently executing. It is set to NULL when no process is active.
+ * @param evt The event, copied into the mailbox.
+ * @return True if the event was queued, False if the mailbox is full.
  */
-process_t *process_current = NULL;
+static bool process_remote_push(const process_event_t *evt)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE_OF(evt->to);
+   process_remote_slot_t *slot;
+   atomic_val_t pos = atomic_get(&instance->remote_tail);
+
+   // Claim a slot: the position is only taken if the slot was handed back for it.
+   for(;;)
+   {
+      slot = &instance->remote_queue[pos & PROCESS_REMOTE_QUEUE_MASK];
+      long diff = (long)((unsigned long)atomic_get(&slot->seq) - (unsigned long)pos);
+
+      if(diff == 0)
+      {
+         if(atomic_cas(&instance->remote_tail, pos, pos + 1))
+         {
+            break;
+         }
+      }
+      else if(diff < 0)
+      {
+         // The slot still holds an event from the previous round: the mailbox is full.
+#if defined(CONFIG_MYOS_STATISTICS)
+         myos_stats.errflags.eventqueue = 1;
+#endif
+         return false;
+      }
+      pos = atomic_get(&instance->remote_tail);
+   }
+
+   slot->evt = *evt;
+
+   // Publish the event to process_run.
+   atomic_set(&slot->seq, pos + 1);
+   TRACE(TRACE_POST_REMOTE, evt->id, 0, evt->from, evt->to);
+
+   PROCESS_WAKEUP(evt->to);
+
+   return true;
+}
+
+
+bool process_post_remote(process_t *to, process_event_id_t evtid, void* data)
+{
+   process_event_t evt = {
+      .from = NULL,
+      .to = to,
+      .id = evtid,
+      .data = data
+   };
+
+   process_payload_reject(data);
+   process_stats_posted(&evt);
+
+   return process_remote_push(&evt);
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_EVENT_PAYLOAD_POOL)
+void* process_post_alloc(void)
+{
+   process_payload_t *payload = ITEMPOOL_ALLOC(process_payload_pool);
+
+   if(!payload)
+   {
+#if defined(CONFIG_MYOS_STATISTICS)
+      myos_stats.errflags.payloadpool = 1;
+#endif
+      return NULL;
+   }
+
+   payload->refs = 0;
+
+   return payload;
+}
+
+
+void process_post_free(void *payload)
+{
+   if(ITEMPOOL_CONTAINS(process_payload_pool, payload) && !((process_payload_t*)payload)->refs)
+   {
+      ITEMPOOL_FREE(process_payload_pool, payload);
+   }
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+arena_t* process_scratch_arena(void)
+{
+   return &PROCESS_INSTANCE()->scratch;
+}
+
+
+void* process_scratch_alloc(size_t size)
+{
+   void *block = arena_alloc(&PROCESS_INSTANCE()->scratch, size);
+
+#if defined(CONFIG_MYOS_STATISTICS)
+   if(!block)
+   {
+      myos_stats.errflags.scratch = 1;
+   }
+#endif
+   return block;
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+bool process_deliver_event(process_event_t *evt);
+
+
+int process_group_thread(process_t *process, process_event_t *evt)
+{
+   return PT_STATE_WAITING;
+}
+
+
+void process_group_join(process_t *group, process_group_member_t *member, process_t *process)
+{
+   member->process = process;
+   slistt_push_back((slistt_t*)group->data, member);
+}
+
+
+void process_group_leave(process_t *group, process_group_member_t *member)
+{
+   slistt_erase((slistt_t*)group->data, member);
+}
+
 
 /**
- * @var process_running_list
- * @brief List of processes that are currently active and scheduled for execution.
+ * @brief Delivers a copy of a broadcast or group event to one recipient.
  *
  * @details
- * This list maintains all the processes that are currently running in the system. It is used
- * by the scheduler to manage and iterate through active processes for execution.
- * The implementation of the list is determined by the configuration (singly or doubly linked list).
+ * Every copy takes a reference of a pooled payload, which its delivery releases again.
  */
-static plist_t process_running_list;
+static inline bool process_deliver_copy(const process_event_t *evt, process_t *to)
+{
+   process_event_t copy = *evt;
+
+   copy.to = to;
+   process_payload_ref(copy.data);
+
+   return process_deliver_event(&copy);
+}
+
 
 /**
- * @typedef process_event_queue
- * @brief Ringbuffer type for storing process events.
+ * @brief Fans a broadcast or group event out to its recipients.
  *
  * @details
- * Defines a ringbuffer type for queuing process events. This ringbuffer holds events that are
- * posted to processes and are pending to be processed. The size of the ringbuffer is defined by
- * CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE.
+ * The next recipient is looked up before the current one handles the event, so recipients
+ * may leave the group or terminate meanwhile.
  *
- * @param process_event_t Type of items in the ringbuffer (process events).
- * @param MYOS_PROC_EVENT_QUEUE_SIZE Size of the ringbuffer, number of events it can hold.
+ * @return True if the event was delivered to at least one recipient.
  */
-RINGBUFFER_TYPEDEF(process_event_queue,process_event_t,CONFIG_MYOS_PROC_EVENT_QUEUE_SIZE);
+static bool process_deliver_fanout(process_event_t *evt)
+{
+   bool delivered = false;
 
-/**
- * @var process_event_queue
- * @brief Ringbuffer instance for managing process events.
- *
- * @details
- * An instance of the ringbuffer that is used to queue events for processes in the system.
- * Events posted to processes are stored in this ringbuffer until they are processed.
- * This ensures that events are handled in a FIFO manner and provides a mechanism for
- * event-driven process scheduling.
- */
-static RINGBUFFER_T(process_event_queue) process_event_queue;
+   if(evt->to == PROCESS_BROADCAST)
+   {
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+      PROCESS_FOREACH(process)
+      {
+         if(!PROCESS_IS_GROUP(process) && PROCESS_IS_RUNNING(process) && PROCESS_IS_LOCAL(process) && !PROCESS_IS_SUSPENDED(process))
+         {
+            delivered |= process_deliver_copy(evt, process);
+         }
+      }
+#else
+      myos_instance_t *instance = PROCESS_INSTANCE();
 
-/**
- * @var process_global_pollreq
- * @brief Global flag indicating whether any process has requested a poll.
- *
- * @details
- * This flag is set to true when any process in the system requests to be polled. The poll request
- * indicates that a process needs immediate attention. When set, the system's scheduler will
- * prioritize handling poll requests before processing other events in the event queue.
- */
-static bool process_global_pollreq = false;
+      // A broadcast posted synchronously during the delivery loops with its own hint.
+      process_t *hinted = instance->running_hinted;
+      plist_node_t *prev = instance->running_prev;
+      process_t *process = (process_t*)plist_next(&instance->running_list, &instance->running_list);
 
+      instance->running_prev = (plist_node_t*)&instance->running_list;
 
+      while(process != (process_t*)&instance->running_list)
+      {
+         process_t *next = (process_t*)plist_next(&instance->running_list, process);
 
+         instance->running_hinted = process;
+         delivered |= process_deliver_copy(evt, process);
 
-void process_init(void)
-{
+         // Still in the list, the process is in front of next.
+         if(PROCESS_IS_RUNNING(process) && !PROCESS_IS_SUSPENDED(process))
+         {
+            instance->running_prev = (plist_node_t*)process;
+         }
+         process = next;
+      }
 
-#if defined(CONFIG_MYOS_PROC_LIST_TYPE_SLIST)
-   DBG_PROCESS("Using singly-linked list for process management.\n");
-#elif defined(CONFIG_MYOS_PROC_LIST_TYPE_DLIST)
-   DBG_PROCESS("Using doubly-linked list for process management.\n");
+      instance->running_hinted = hinted;
+      instance->running_prev = prev;
 #endif
+   }
+   else
+   {
+      slistt_t *members = evt->to->data;
+      process_group_member_t *member = (process_group_member_t*)slistt_begin(members);
 
-   DBG_PROCESS("Using event queue of size %d \n",RINGBUFFER_SIZE(process_event_queue));
+      while((slist_node_t*)member != slistt_end(members))
+      {
+         process_group_member_t *next = (process_group_member_t*)slistt_next(members, member);
 
-   /* Initialize the list for running processes. */
-   plist_init(&process_running_list);
+         delivered |= process_deliver_copy(evt, member->process);
+         member = next;
+      }
+   }
 
-   /* Initialize the ring buffer for the process event queue. */
-   RINGBUFFER_INIT(process_event_queue);
+   return delivered;
+}
+#endif
 
-   /* Set the current process to NULL, indicating no process is running. */
-   PROCESS_THIS() = NULL;
+
+#if defined(CONFIG_MYOS_PROC_EVENT_FILTER)
+/**
+ * @brief Checks whether the target of an event waits for another one in PROCESS_WAIT_EVENT().
+ *
+ * @param evt The event.
+ * @return True if the event is to be dropped.
+ */
+static inline bool process_event_filtered(const process_event_t *evt)
+{
+   return evt->to->filter && PROCESS_IS_RUNNING(evt->to) &&
+          evt->id != evt->to->waitfor && evt->id != PROCESS_EVENT_EXIT;
 }
+#endif
 
 
-bool process_post(process_t *to, process_event_id_t evtid, void* data)
+#if defined(CONFIG_MYOS_PROC_CHILD)
+/**
+ * @brief Runs the innermost child thread of a process with an event.
+ *
+ * @details
+ * A terminated child hands the same event to its parent, which resumes after its
+ * PROCESS_SPAWN(). The process thread only runs without children.
+ *
+ * @param process The process.
+ * @param evt The event.
+ * @return The state of the process thread, PT_STATE_WAITING while a child runs.
+ */
+static int process_dispatch(process_t *process, process_event_t *evt)
 {
-   process_event_t *evt;
+   process_child_t *child;
 
-   // Check if the event queue is full.
-   if(RINGBUFFER_FULL(process_event_queue))
+   while((child = process->child))
    {
-#if defined(CONFIG_MYOS_STATISTICS)
-      myos_stats.errflags.eventqueue = 1;
-#endif
-      return false;
+      if(child->thread(child, evt) != PT_STATE_TERMINATED)
+      {
+         return PT_STATE_WAITING;
+      }
+      process->child = child->parent;
    }
 
-   // Get a pointer to the next free space in the event queue.
-   evt = RINGBUFFER_TAIL_PTR(process_event_queue);
+   return process->thread(process, evt);
+}
 
-   // Fill in the event structure.
-   evt->from = PROCESS_THIS();
-   evt->to = to;
-   evt->id = evtid;
-   evt->data = data;
 
-   DBG_PROCESS("post from %p to %p evtid=%d ...\n", (void*)evt->from, (void*)evt->to, evt->id);
+bool process_child_start(process_t *process, process_child_t *child, process_child_thread_t thread, void *data, process_event_t *evt)
+{
+   child->thread = thread;
+   child->data = data;
+   PT_INIT(&child->pt);
 
-   // Push the event onto the event queue.
-   RINGBUFFER_PUSH(process_event_queue);
+   // The spawning thread is the innermost one, the process thread if there is no child.
+   child->parent = process->child;
+   process->child = child;
 
-#if defined(CONFIG_MYOS_STATISTICS)
-   // Update the maximum queue count for statistics.
-   if(RINGBUFFER_COUNT(process_event_queue) > myos_stats.maxqueuecount)
+   if(thread(child, evt) == PT_STATE_TERMINATED)
    {
-      myos_stats.maxqueuecount = RINGBUFFER_COUNT(process_event_queue);
+      process->child = child->parent;
+      return true;
    }
+   return false;
+}
+
+#define PROCESS_DISPATCH(process,evt)  process_dispatch(process,evt)
+#else
+#define PROCESS_DISPATCH(process,evt)  (process)->thread(process,evt)
 #endif
 
-   return true;
-}
 
 /**
  * @brief Delivers an event to a process.
@@ -189,6 +1567,13 @@ bool process_post(process_t *to, process_event_id_t evtid, void* data)
  * process is removed from the running processes list. The function then restores
  * the original process context.
  *
+ * With CONFIG_MYOS_PROC_BROADCAST, events to PROCESS_BROADCAST or to a process group are
+ * delivered to each of their recipients in turn, and a terminated process is announced
+ * with a PROCESS_EVENT_EXITED broadcast.
+ *
+ * With CONFIG_MYOS_PROC_SUSPEND, events to a suspended process other than
+ * PROCESS_EVENT_EXIT are parked for process_resume() or dropped, see process_suspend().
+ *
  * @note
  * This function is typically called internally by the process management system
  * and should not be called directly in application code.
@@ -203,10 +1588,60 @@ bool process_post(process_t *to, process_event_id_t evtid, void* data)
  * process_deliver_event(&my_event);
  * @endcode
  */
-bool process_deliver_event(process_event_t *evt)
+UTILS_HOT_FUNC bool process_deliver_event(process_event_t *evt)
 {
+   bool delivered = false;
+
    DBG_PROCESS("deliver_event from %p to %p evtid=%d ...\n", (void*)evt->from, (void*)evt->to, evt->id);
 
+#if CONFIG_MYOS_INSTANCES > 1
+   // An event to a process of another instance is handed over to the thread of that instance.
+   if(evt->to && !PROCESS_IS_LOCAL(evt->to))
+   {
+      return process_remote_push(evt);
+   }
+#endif
+
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+   // The first event starts the process, parked ones once it is resumed. An EXIT needs no
+   // START, PROCESS_BEGIN() terminates the thread right away.
+   if(evt->to && evt->to->lazy && !PROCESS_IS_SUSPENDED(evt->to) &&
+      evt->id != PROCESS_EVENT_START && evt->id != PROCESS_EVENT_EXIT)
+   {
+      evt->to->lazy = false;
+      process_post_sync(evt->to, PROCESS_EVENT_START, evt->to->data);
+   }
+#endif
+
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+   if(evt->to == PROCESS_BROADCAST || PROCESS_IS_GROUP(evt->to))
+   {
+      delivered = process_deliver_fanout(evt);
+   }
+   else
+#endif
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+   if(PROCESS_IS_SUSPENDED(evt->to) && evt->id != PROCESS_EVENT_EXIT)
+   {
+      // A parked event keeps its payload reference until process_resume() delivers it.
+      if(evt->to->suspended == PROCESS_SUSPEND_PARK && process_park(evt))
+      {
+         TRACE(TRACE_DELIVER_SUSPENDED, evt->id, 1, evt->from, evt->to);
+         return true;
+      }
+      TRACE(TRACE_DELIVER_SUSPENDED, evt->id, 0, evt->from, evt->to);
+   }
+   else
+#endif
+#if defined(CONFIG_MYOS_PROC_EVENT_FILTER)
+   if(process_event_filtered(evt))
+   {
+      // The thread would discard the event, it is consumed without running it.
+      TRACE(TRACE_DELIVER_FILTERED, evt->id, 0, evt->from, evt->to);
+      delivered = true;
+   }
+   else
+#endif
    if(PROCESS_IS_RUNNING(evt->to) || evt->id == PROCESS_EVENT_START)
    {
       PROCESS_CONTEXT_BEGIN(evt->to);
@@ -215,7 +1650,35 @@ bool process_deliver_event(process_event_t *evt)
       rtimer_timespan_t slicetime = rtimer_now();
 #endif
 
-      int pstate = PROCESS_THIS()->thread(PROCESS_THIS(), evt);
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+      PROCESS_THIS()->slicestart = rtimer_now();
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+      arena_mark_t scratch = arena_mark(&PROCESS_INSTANCE()->scratch);
+#endif
+
+      TRACE(TRACE_DELIVER, evt->id, 0, evt->from, evt->to);
+
+#if defined(CONFIG_MYOS_WCET_PROCESS)
+      wcet_time_t wcetstart = wcet_now();
+#endif
+
+      int pstate = PROCESS_DISPATCH(PROCESS_THIS(), evt);
+
+#if defined(CONFIG_MYOS_WCET_PROCESS)
+      wcet_count(&PROCESS_THIS()->wcet, WCET_PROBE_PROCESS, PROCESS_THIS(), wcet_now() - wcetstart);
+#endif
+
+      TRACE(TRACE_DELIVER_DONE, evt->id, pstate, evt->from, evt->to);
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+      arena_release(&PROCESS_INSTANCE()->scratch, scratch);
+#endif
+
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+      process_stats_event(evt, slicetime, rtimer_now());
+#endif
 
 #if defined(CONFIG_MYOS_STATISTICS)
       slicetime = rtimer_now() - slicetime;
@@ -225,17 +1688,39 @@ bool process_deliver_event(process_event_t *evt)
       }
 #endif
 
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+      load_count(PROCESS_THIS(), slicetime);
+#endif
+
       if(pstate == PT_STATE_TERMINATED)
       {
-         plist_erase(&process_running_list, PROCESS_THIS());
-         // Consider broadcasting exit to all processes if needed.
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+         PROCESS_THIS()->lazy = false;
+#endif
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+         // Terminated by PROCESS_EVENT_EXIT while suspended, or after suspending itself.
+         if(PROCESS_IS_SUSPENDED(PROCESS_THIS()))
+         {
+            process_parked_discard(process_unsuspend(PROCESS_THIS()));
+         }
+         PROCESS_THIS()->pollparked = false;
+#endif
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+         process_running_erase(PROCESS_THIS());
+#endif
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+         process_post_broadcast(PROCESS_EVENT_EXITED, PROCESS_THIS());
+#endif
       }
 
       PROCESS_CONTEXT_END();
-      return true;
+      delivered = true;
    }
 
-   return false;
+   // Release a pooled payload, also if the target is not running anymore.
+   process_payload_unref(evt->data);
+
+   return delivered;
 }
 
 
@@ -248,14 +1733,30 @@ bool process_post_sync(process_t *to, process_event_id_t evtid, void* data)
       .data = data
    };
 
+   process_stats_posted(&evt);
+
    DBG_PROCESS("post_sync from %p to %p evtid=%d ...\n", (void*)evt.from, (void*)evt.to, evt.id);
 
+   process_payload_ref(data);
+
    // Deliver the event immediately.
    return process_deliver_event(&evt);
 }
 
-bool process_start(process_t *process, void* data)
+/**
+ * @brief Starts a process, see process_start_budget() and process_start_lazy().
+ *
+ * @param process The process.
+ * @param data Data passed to the process.
+ * @param budget Time slice budget, only used with CONFIG_MYOS_PROC_BUDGET.
+ * @param lazy True to defer PROCESS_EVENT_START to the first event of the process.
+ * @return True if the process was started, False if it is running already.
+ */
+static bool process_launch(process_t *process, void* data, rtimer_timespan_t budget, bool lazy)
 {
+   ARG_UNUSED(budget);
+   ARG_UNUSED(lazy);
+
    DBG_PROCESS("start %p ...\n", (void*)process);
 
    // Check if the process is already running.
@@ -268,12 +1769,46 @@ bool process_start(process_t *process, void* data)
    // Set the process data and initialize its protothread.
    process->data = data;
    PT_INIT(&process->pt);
+#if defined(CONFIG_MYOS_PROC_CHILD)
+   process->child = NULL;
+#endif
+#if defined(CONFIG_MYOS_PROC_EVENT_FILTER)
+   process->filter = false;
+#endif
+#if defined(CONFIG_MYOS_PROC_LOCALS)
+   if(process->locals)
+   {
+      memset(process->locals, 0, process->localsize);
+   }
+#endif
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+   process->budget = budget;
+#endif
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+   process->suspended = PROCESS_SUSPEND_NONE;
+   process->pollparked = false;
+   process->parkhead = NULL;
+   process->parktail = NULL;
+#endif
 
+#if CONFIG_MYOS_INSTANCES > 1
+   // The process belongs to the instance which starts it.
+   process->instance = PROCESS_INSTANCE() - myos_instances;
+#endif
+
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
    // Add the process to the running processes list.
-   plist_push_front(&process_running_list, process);
+   plist_push_front(&PROCESS_INSTANCE()->running_list, process);
+#endif
 
-   // Post the PROCESS_EVENT_START event to the process.
-   process_post_sync(process, PROCESS_EVENT_START, data);
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+   process->lazy = lazy;
+   if(!lazy)
+#endif
+   {
+      // Post the PROCESS_EVENT_START event to the process.
+      process_post_sync(process, PROCESS_EVENT_START, data);
+   }
 
    DBG_PROCESS("start %p success\n", (void*)process);
 
@@ -281,6 +1816,55 @@ bool process_start(process_t *process, void* data)
 }
 
 
+bool process_start(process_t *process, void* data)
+{
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+   return process_launch(process, data, CONFIG_MYOS_PROC_BUDGET_DEFAULT, false);
+#else
+   return process_launch(process, data, 0, false);
+#endif
+}
+
+
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+bool process_start_budget(process_t *process, void* data, rtimer_timespan_t budget)
+{
+   return process_launch(process, data, budget, false);
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+bool process_start_lazy(process_t *process, void* data)
+{
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+   return process_launch(process, data, CONFIG_MYOS_PROC_BUDGET_DEFAULT, true);
+#else
+   return process_launch(process, data, 0, true);
+#endif
+}
+#endif
+
+
+#if defined(CONFIG_MYOS_PROC_AUTOSTART)
+void process_autostart(void)
+{
+   // The linker sorts the entries by level and then by process name.
+   STRUCT_SECTION_FOREACH(process_autostart_t, entry)
+   {
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+      if(entry->lazy)
+      {
+         process_start_lazy(entry->process, NULL);
+         continue;
+      }
+#endif
+      process_start(entry->process, NULL);
+   }
+}
+#endif
+
+
 bool process_exit(process_t *process)
 {
    DBG_PROCESS("exit %p ...\n", (void*)process);
@@ -301,50 +1885,224 @@ bool process_exit(process_t *process)
 }
 
 
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+bool process_suspend(process_t *process, process_suspend_t policy)
+{
+   DBG_PROCESS("suspend %p ...\n", (void*)process);
+
+   if(!PROCESS_IS_RUNNING(process) || !PROCESS_IS_LOCAL(process) || PROCESS_IS_SUSPENDED(process) || policy == PROCESS_SUSPEND_NONE)
+   {
+      DBG_PROCESS("suspend %p failure\n", (void*)process);
+      return false;
+   }
+
+   process->suspended = policy;
+
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   // Broadcasts and process_running_next() do not see the process anymore.
+   process_running_erase(process);
+#endif
+
+   DBG_PROCESS("suspend %p success\n", (void*)process);
+
+   return true;
+}
+
+
+bool process_resume(process_t *process)
+{
+   DBG_PROCESS("resume %p ...\n", (void*)process);
+
+   if(!PROCESS_IS_RUNNING(process) || !PROCESS_IS_LOCAL(process) || !PROCESS_IS_SUSPENDED(process))
+   {
+      DBG_PROCESS("resume %p failure\n", (void*)process);
+      return false;
+   }
+
+   process_parked_t *parked = process_unsuspend(process);
+
+   // Deliver the parked events in their order, the slot is free before the handler runs.
+   while(parked)
+   {
+      process_parked_t *next = parked->next;
+      process_event_t evt = parked->evt;
+
+      ITEMPOOL_FREE(PROCESS_INSTANCE()->parked_pool, parked);
+      process_deliver_event(&evt);
+      parked = next;
+   }
+
+   if(process->pollparked)
+   {
+      process->pollparked = false;
+      process_poll(process);
+   }
+
+   DBG_PROCESS("resume %p success\n", (void*)process);
+
+   return true;
+}
+#endif
+
+
 
 void process_poll(process_t *process)
 {
+   myos_instance_t *instance = PROCESS_INSTANCE_OF(process);
+
    DBG_PROCESS("polling %p \n", (void*)process);
-   process->pollreq = true;
-   process_global_pollreq = true;
+
+   CRITICAL_SECTION_BEGIN();
+
+   // Only queue the process once, additional requests are merged.
+   if(!process->pollreq)
+   {
+      process->pollreq = true;
+      process->pollnext = NULL;
+
+      if(instance->poll_tail)
+      {
+         instance->poll_tail->pollnext = process;
+      }
+      else
+      {
+         instance->poll_head = process;
+      }
+      instance->poll_tail = process;
+   }
+
+   CRITICAL_SECTION_END();
+
+   PROCESS_WAKEUP(process);
 }
 
 
-inline int process_run(void)
+/**
+ * @brief Handles all pending poll requests.
+ *
+ * @details
+ * Dequeues the processes from the pending-poll queue one by one and delivers
+ * PROCESS_EVENT_POLL synchronously to them. Processes which are not running
+ * anymore are skipped by `process_deliver_event`. Repeats as long as new poll
+ * requests arrive meanwhile.
+ */
+static inline void process_run_polls(void)
 {
-   // Process polling requests.
-#if defined(CONFIG_MYOS_STATISTICS)
-   rtimer_timespan_t proctime = rtimer_now();
-#endif
+   myos_instance_t *instance = PROCESS_INSTANCE();
 
-   while(process_global_pollreq)
+   while(instance->poll_head)
    {
       process_t *process;
+      bool parked = false;
 
-      process_global_pollreq = false;
+      CRITICAL_SECTION_BEGIN();
 
-      plist_foreach(&process_running_list, process)
+      process = instance->poll_head;
+      instance->poll_head = process->pollnext;
+      if(!instance->poll_head)
       {
-         if(process->pollreq)
-         {
-            process->pollreq = false;
-            process_post_sync(process, PROCESS_EVENT_POLL, NULL);
-         }
+         instance->poll_tail = NULL;
+      }
+
+      // Cleared before delivery, so the process may poll itself again.
+      process->pollreq = false;
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+      // Kept for process_resume(), further polls meanwhile are merged into this one.
+      parked = process->suspended == PROCESS_SUSPEND_PARK;
+      process->pollparked |= parked;
+#endif
+
+      CRITICAL_SECTION_END();
+
+      if(!parked)
+      {
+         process_post_sync(process, PROCESS_EVENT_POLL, NULL);
       }
    }
+}
+
+
+/**
+ * @brief Delivers the next queued event, if any.
+ *
+ * @details
+ * Events posted from ISRs are delivered first, then events posted from other threads
+ * or cores, then the most urgent deadline event, then the event is taken from the
+ * highest non-empty priority level.
+ *
+ * @return True if an event was delivered, False if the event queues were empty.
+ */
+static inline bool process_run_event(void)
+{
+   myos_instance_t *instance = PROCESS_INSTANCE();
+   process_event_prio_t prio = 0;
+
+   if(!RINGBUFFER_SPSC_EMPTY(instance->isr_event_queue))
+   {
+      process_deliver_event(RINGBUFFER_SPSC_HEAD_PTR(instance->isr_event_queue));
+      RINGBUFFER_SPSC_POP(instance->isr_event_queue);
+      return true;
+   }
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+   process_remote_slot_t *slot = process_remote_head_slot(instance);
+
+   if(slot)
+   {
+      process_deliver_event(&slot->evt);
+      process_remote_pop(instance, slot);
+      return true;
+   }
+#endif
 
-   // Process protothread timers if enabled.
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+   if(instance->edf_count)
+   {
+      // Take the entry off the heap first, the handler may post deadline events itself.
+      process_edf_entry_t entry;
 
-   //ptimer_processing();
+      process_edf_pop(&entry);
+      process_deliver_event(&entry.evt);
+      return true;
+   }
+#endif
 
+   if(!instance->event_count)
+   {
+      return false;
+   }
 
-   // Process events from the event queue.
-   if(RINGBUFFER_COUNT(process_event_queue))
+   while(RINGBUFFER_EMPTY(instance->event_queue[prio]))
    {
-      process_deliver_event(RINGBUFFER_HEAD_PTR(process_event_queue));
-      RINGBUFFER_POP(process_event_queue);
+      prio++;
    }
 
+   process_event_t evt;
+
+   process_event_queue_pop(prio, &evt);
+   instance->event_count--;
+   process_deliver_event(&evt);
+
+   return true;
+}
+
+
+UTILS_HOT_FUNC int process_run(void)
+{
+#if defined(CONFIG_MYOS_STATISTICS)
+   rtimer_timespan_t proctime = rtimer_now();
+#endif
+
+   // Run the queued tasklets.
+   PROCESS_DEFER_RUN();
+
+   // Process polling requests.
+   process_run_polls();
+
+   // Process the next event from the highest non-empty priority level.
+   process_run_event();
+
    // Update processing time statistics.
 #if defined(CONFIG_MYOS_STATISTICS)
    proctime = rtimer_now() - proctime;
@@ -354,8 +2112,133 @@ inline int process_run(void)
    }
 #endif
 
-   // Return the count of remaining events and poll requests.
-   return RINGBUFFER_COUNT(process_event_queue) + process_global_pollreq;
+   // Return the count of remaining events, tasklets and poll requests.
+   return PROCESS_PENDING();
+}
+
+
+UTILS_HOT_FUNC int process_run_batch(size_t max_events, rtimer_timespan_t max_rtimer_ticks)
+{
+   rtimer_timestamp_t start = 0;
+   size_t delivered = 0;
+
+   if(max_rtimer_ticks)
+   {
+      start = rtimer_now();
+   }
+
+#if defined(CONFIG_MYOS_STATISTICS)
+   rtimer_timespan_t proctime = max_rtimer_ticks ? start : rtimer_now();
+#endif
+
+   do
+   {
+      // Tasklets and polls which arrived meanwhile are handled before the next event.
+      PROCESS_DEFER_RUN();
+      process_run_polls();
+
+      if(!process_run_event())
+      {
+         break;
+      }
+      delivered++;
+
+      if(max_events && delivered >= max_events)
+      {
+         break;
+      }
+   }
+   while(!max_rtimer_ticks || (rtimer_timespan_t)(rtimer_now() - start) < max_rtimer_ticks);
+
+   // Update processing time statistics, once for the whole batch.
+#if defined(CONFIG_MYOS_STATISTICS)
+   proctime = rtimer_now() - proctime;
+   if(proctime > myos_stats.maxproctime)
+   {
+      myos_stats.maxproctime = proctime;
+   }
+#endif
+
+   // Return the count of remaining events, tasklets and poll requests.
+   return PROCESS_PENDING();
+}
+
+
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+void process_stats_snapshot(process_t *process, process_stats_t *snapshot, bool reset)
+{
+   if(snapshot)
+   {
+      *snapshot = process->stats;
+   }
+
+   if(reset)
+   {
+      memset(&process->stats, 0, sizeof(process->stats));
+      process->stats.rate_start = timestamp_now();
+   }
+}
+
+
+uint32_t process_stats_percentile(const uint32_t *hist, uint8_t percent)
+{
+   uint64_t total = 0, sum = 0;
+
+   for(int k = 0; k < CONFIG_MYOS_STATISTICS_HIST_BUCKETS; k++)
+   {
+      total += hist[k];
+   }
+
+   for(int k = 0; k < CONFIG_MYOS_STATISTICS_HIST_BUCKETS; k++)
+   {
+      sum += hist[k];
+      if(hist[k] && sum * 100 >= total * percent)
+      {
+         return k == CONFIG_MYOS_STATISTICS_HIST_BUCKETS - 1 ? UINT32_MAX : (uint32_t)1 << k;
+      }
+   }
+
+   return 0;
+}
+#endif
+
+
+process_t *process_running_next(process_t *process)
+{
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+   bool found = process == NULL;
+
+   PROCESS_FOREACH(next)
+   {
+      if(found && PROCESS_IS_RUNNING(next) && PROCESS_IS_LOCAL(next) && !PROCESS_IS_SUSPENDED(next))
+      {
+         return next;
+      }
+      found |= next == process;
+   }
+
+   return NULL;
+#else
+   plist_t *list = &PROCESS_INSTANCE()->running_list;
+   process_t *next = (process_t*)plist_next(list, process ? process : (process_t*)list);
+
+   return next != (process_t*)list ? next : NULL;
+#endif
+}
+
+
+#if CONFIG_MYOS_INSTANCES > 1
+void process_instance_bind(uint8_t instance)
+{
+   if(instance < CONFIG_MYOS_INSTANCES)
+   {
+      process_instance = &myos_instances[instance];
+   }
 }
 
 
+uint8_t process_instance_id(void)
+{
+   return PROCESS_INSTANCE() - myos_instances;
+}
+#endif
@@ -87,6 +87,15 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "rtimer.h"
+#include "timestamp.h"
+#include "arena.h"
+#include "wcet.h"
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE) || defined(CONFIG_MYOS_PROC_AUTOSTART)
+#include <zephyr/sys/iterable_sections.h>
+#endif
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+#include "slist.h"
+#endif
 
 /**
  * @file
@@ -129,6 +138,7 @@ typedef slist_node_t plist_node_t;
 #define PLIST_NODE_TYPE                              SLIST_NODE_TYPE
 #define plist_init(listptr)                          slist_init(listptr)
 #define plist_erase(listptr,nodeptr)                 slist_erase(listptr,nodeptr)
+#define plist_erase_hint(listptr,hintptr,nodeptr)    slist_erase_hint(listptr,hintptr,nodeptr)
 #define plist_next(listptr,nodeptr)                  slist_next(listptr,nodeptr)
 #define plist_push_front(listptr,nodeptr)            slist_push_front(listptr,nodeptr)
 #define plist_prev(listptr,nodeptr)                  slist_prev(listptr,nodeptr)
@@ -140,6 +150,7 @@ typedef dlist_node_t plist_node_t;
 #define PLIST_NODE_TYPE                              DLIST_NODE_TYPE
 #define plist_init(listptr)                          dlist_init(listptr)
 #define plist_erase(listptr,nodeptr)                 dlist_erase(listptr,nodeptr)
+#define plist_erase_hint(listptr,hintptr,nodeptr)    dlist_erase(listptr,nodeptr)
 #define plist_next(listptr,nodeptr)                  dlist_next(listptr,nodeptr)
 #define plist_push_front(listptr,nodeptr)            dlist_push_front(listptr,nodeptr)
 #define plist_prev(listptr,nodeptr)                  dlist_prev(listptr,nodeptr)
@@ -206,9 +217,60 @@ typedef dlist_node_t plist_node_t;
  */
 #define PROCESS_EVENT_EXIT      4
 
+/**
+ * @def PROCESS_EVENT_EXITED
+ * @brief Event broadcast to all running processes after a process has terminated.
+ *
+ * @details
+ * Only posted with CONFIG_MYOS_PROC_BROADCAST. The event data is the terminated process.
+ */
+#define PROCESS_EVENT_EXITED    5
+
 typedef struct process_t process_t;
+typedef struct process_child_t process_child_t;
 typedef struct process_event_t process_event_t;
 typedef uint8_t process_event_id_t;
+typedef uint8_t process_event_prio_t;
+
+/**
+ * @def PROCESS_EVENT_PRIO_HIGHEST
+ * @brief Highest event priority level.
+ */
+#define PROCESS_EVENT_PRIO_HIGHEST  0
+
+/**
+ * @def PROCESS_EVENT_PRIO_LOWEST
+ * @brief Lowest event priority level.
+ */
+#define PROCESS_EVENT_PRIO_LOWEST   (CONFIG_MYOS_PROC_EVENT_PRIO_LEVELS-1)
+
+/**
+ * @def PROCESS_EVENT_PRIO_DEFAULT
+ * @brief Event priority level used by process_post().
+ */
+#define PROCESS_EVENT_PRIO_DEFAULT  CONFIG_MYOS_PROC_EVENT_PRIO_DEFAULT
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+typedef uint8_t process_suspend_t;
+
+/**
+ * @def PROCESS_SUSPEND_NONE
+ * @brief The process is not suspended.
+ */
+#define PROCESS_SUSPEND_NONE  0
+
+/**
+ * @def PROCESS_SUSPEND_DROP
+ * @brief Events and polls to the suspended process are dropped.
+ */
+#define PROCESS_SUSPEND_DROP  1
+
+/**
+ * @def PROCESS_SUSPEND_PARK
+ * @brief Events and polls to the suspended process are parked until process_resume().
+ */
+#define PROCESS_SUSPEND_PARK  2
+#endif
 
 
 
@@ -227,6 +289,37 @@ typedef uint8_t process_event_id_t;
  */
 typedef int(*process_thread_t)(process_t *process, process_event_t *evt);
 
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+/**
+ * @struct process_stats_t
+ * @brief Log2-bucketed histograms of a process.
+ *
+ * @details
+ * Bucket 0 counts the value 0, bucket k counts the values from 2^(k-1) to 2^k-1, the last
+ * bucket also counts all larger values. Times are in rtimer ticks.
+ *
+ * @var process_stats_t::slicetime
+ * Histogram of the time the process spent handling an event.
+ * @var process_stats_t::waittime
+ * Histogram of the time the events of the process spent in the event queues. Waits longer
+ * than half the rtimer range wrap around.
+ * @var process_stats_t::rate
+ * Histogram of the number of events handled per second. A second is accounted with the
+ * first event after it has passed, seconds without any event are not counted.
+ * @var process_stats_t::rate_start
+ * Start of the current second.
+ * @var process_stats_t::rate_count
+ * Number of events handled in the current second.
+ */
+typedef struct {
+   uint32_t slicetime[CONFIG_MYOS_STATISTICS_HIST_BUCKETS];
+   uint32_t waittime[CONFIG_MYOS_STATISTICS_HIST_BUCKETS];
+   uint32_t rate[CONFIG_MYOS_STATISTICS_HIST_BUCKETS];
+   timestamp_t rate_start;
+   uint32_t rate_count;
+}process_stats_t;
+#endif
+
 /**
  * @struct process_t
  * @brief Represents a process in the system.
@@ -236,7 +329,8 @@ typedef int(*process_thread_t)(process_t *process, process_event_t *evt);
  * with additional features such as event handling and interaction with other processes.
  *
  * @var process_t::PLIST_NODE_TYPE
- * Node type for including this process in a process list.
+ * Node type for including this process in a process list. Not present with
+ * CONFIG_MYOS_PROC_STATIC_TABLE, where the process table replaces the list.
  * @var process_t::thread
  * The protothread function representing the process logic.
  * @var process_t::data
@@ -245,11 +339,74 @@ typedef int(*process_thread_t)(process_t *process, process_event_t *evt);
  * Protothread state for this process.
  * @var process_t::maxslicetime
  * (Optional, with CONFIG_MYOS_STATISTICS) Records the maximum time slice used by this process.
+ * @var process_t::stats
+ * (Optional, with CONFIG_MYOS_STATISTICS_HISTOGRAMS) Histograms of this process.
+ * @var process_t::busy
+ * (Optional, with CONFIG_MYOS_STATISTICS_LOAD) rtimer ticks spent in this process in the
+ * current load window.
+ * @var process_t::events
+ * (Optional, with CONFIG_MYOS_STATISTICS_LOAD) Events delivered to this process in the
+ * current load window.
+ * @var process_t::lastbusy
+ * (Optional, with CONFIG_MYOS_STATISTICS_LOAD) `busy` of the last closed load window.
+ * @var process_t::lastevents
+ * (Optional, with CONFIG_MYOS_STATISTICS_LOAD) `events` of the last closed load window.
+ * @var process_t::wcet
+ * (Optional, with CONFIG_MYOS_WCET_PROCESS) Execution times of the deliveries to this process.
+ * @var process_t::budget
+ * (Optional, with CONFIG_MYOS_PROC_BUDGET) Time slice budget in rtimer ticks, see
+ * PROCESS_YIELD_IF_BUDGET_EXCEEDED().
+ * @var process_t::slicestart
+ * (Optional, with CONFIG_MYOS_PROC_BUDGET) rtimer timestamp at which the delivery of the
+ * current event to this process started.
+ * @var process_t::locals
+ * (Optional, with CONFIG_MYOS_PROC_LOCALS) Thread locals of this process, NULL for processes
+ * defined with PROCESS(), see PROCESS_WITH_LOCALS().
+ * @var process_t::localsize
+ * (Optional, with CONFIG_MYOS_PROC_LOCALS) Size of the thread locals in bytes.
+ * @var process_t::child
+ * (Optional, with CONFIG_MYOS_PROC_CHILD) Innermost running child thread, which receives
+ * the events of this process, NULL if the process thread itself runs.
+ * @var process_t::waitfor
+ * (Optional, with CONFIG_MYOS_PROC_EVENT_FILTER) Event the process waits for in
+ * PROCESS_WAIT_EVENT(), only valid while `filter` is set.
+ * @var process_t::filter
+ * (Optional, with CONFIG_MYOS_PROC_EVENT_FILTER) Flag indicating that other events than
+ * `waitfor` and PROCESS_EVENT_EXIT are dropped without running the thread.
+ * @var process_t::suspended
+ * (Optional, with CONFIG_MYOS_PROC_SUSPEND) PROCESS_SUSPEND_DROP or PROCESS_SUSPEND_PARK
+ * while the process is suspended, PROCESS_SUSPEND_NONE otherwise.
+ * @var process_t::pollparked
+ * (Optional, with CONFIG_MYOS_PROC_SUSPEND) Flag indicating that a poll request arrived
+ * while the process was suspended with PROCESS_SUSPEND_PARK.
+ * @var process_t::parkhead
+ * (Optional, with CONFIG_MYOS_PROC_SUSPEND) Oldest event parked for this process.
+ * @var process_t::parktail
+ * (Optional, with CONFIG_MYOS_PROC_SUSPEND) Newest event parked for this process.
+ * @var process_t::lazy
+ * (Optional, with CONFIG_MYOS_PROC_LAZY_START) Flag indicating that the process was started
+ * with process_start_lazy() and has not received PROCESS_EVENT_START yet.
  * @var process_t::pollreq
  * Flag indicating whether this process has requested to be polled.
+ * @var process_t::pollnext
+ * Next process in the pending-poll queue, only valid while `pollreq` is set.
+ * @var process_t::instance
+ * (Optional, with CONFIG_MYOS_INSTANCES > 1) Index of the MyOS instance which started the
+ * process. Its events are delivered by the thread of that instance only.
+ * @var process_t::postwait
+ * (Optional, with CONFIG_MYOS_PROC_POST_WAIT) Flag indicating whether this process waits
+ * for room in the event queue, see PROCESS_POST_WAIT().
+ * @var process_t::postwaitnext
+ * (Optional, with CONFIG_MYOS_PROC_POST_WAIT) Next process waiting for room in the event
+ * queue, only valid while `postwait` is set.
+ * @var process_t::queued
+ * (Optional, with CONFIG_MYOS_PROC_POST_QUOTA) Number of events posted by this process
+ * which are pending in the priority level queues.
  */
 struct process_t {
+#if !defined(CONFIG_MYOS_PROC_STATIC_TABLE)
    PLIST_NODE_TYPE;
+#endif
    process_thread_t thread;
    void* data;
    pt_t pt;
@@ -258,7 +415,65 @@ struct process_t {
    rtimer_timespan_t maxslicetime;
 #endif
 
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   process_stats_t stats;
+#endif
+
+#if defined(CONFIG_MYOS_STATISTICS_LOAD)
+   uint32_t busy;
+   uint32_t events;
+   uint32_t lastbusy;
+   uint32_t lastevents;
+#endif
+
+#if defined(CONFIG_MYOS_WCET_PROCESS)
+   wcet_probe_t wcet;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+   rtimer_timespan_t budget;
+   rtimer_timestamp_t slicestart;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_LOCALS)
+   void *locals;
+   uint16_t localsize;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_CHILD)
+   process_child_t *child;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_FILTER)
+   process_event_id_t waitfor;
+   bool filter;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+   process_suspend_t suspended;
+   bool pollparked;
+   struct process_parked_t *parkhead;
+   struct process_parked_t *parktail;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+   bool lazy;
+#endif
+
    bool pollreq;
+   struct process_t *pollnext;
+
+#if CONFIG_MYOS_INSTANCES > 1
+   uint8_t instance;
+#endif
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+   bool postwait;
+   struct process_t *postwaitnext;
+#if CONFIG_MYOS_PROC_POST_QUOTA > 0
+   uint16_t queued;
+#endif
+#endif
 } ;
 
 /**
@@ -277,15 +492,33 @@ struct process_t {
  * Pointer to the process that posted this event.
  * @var process_event_t::to
  * Pointer to the process that the event is directed to.
+ * @var process_event_t::posted
+ * (Optional, with CONFIG_MYOS_STATISTICS_HISTOGRAMS) rtimer timestamp of the post.
  */
 struct process_event_t {
    process_event_id_t id;
    void *data;
    process_t *from;
    process_t *to;
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+   rtimer_timestamp_t posted;
+#endif
 };
 
 
+/**
+ * @def PROCESS_THREAD_LOCAL
+ * @brief Storage class of the scheduler variables every MyOS instance has its own copy of.
+ *
+ * @details
+ * Thread-local with CONFIG_MYOS_INSTANCES > 1, empty otherwise.
+ */
+#if CONFIG_MYOS_INSTANCES > 1
+#define PROCESS_THREAD_LOCAL __thread
+#else
+#define PROCESS_THREAD_LOCAL
+#endif
+
 /**
  * @var process_current
  * @brief Pointer to the currently executing process.
@@ -293,9 +526,10 @@ struct process_event_t {
  * @details
  * This global pointer keeps track of the process that is currently running in the system.
  * It is used by the process scheduler to manage the execution context and to switch
- * between different processes.
+ * between different processes. With CONFIG_MYOS_INSTANCES > 1 the thread of every
+ * instance has its own.
  */
-extern process_t *process_current;
+extern PROCESS_THREAD_LOCAL process_t *process_current;
 
 /**
  * @def PROCESS_THIS()
@@ -350,10 +584,94 @@ extern process_t *process_current;
  * This macro declares a new process and its associated thread function. It initializes
  * the process structure and sets up the process thread. The process is ready to be
  * started with process_start().
+ *
+ * With CONFIG_MYOS_PROC_STATIC_TABLE the process is placed in the iterable linker section
+ * of the static process table, which assigns its process_id().
  */
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
 #define PROCESS(name,threadname) \
    int process_thread_##threadname(process_t *process, process_event_t *evt);  \
-   process_t name = {{0},process_thread_##threadname,0,{0},false}
+   STRUCT_SECTION_ITERABLE(process_t, name) = {.thread = process_thread_##threadname, .data = 0, .pollreq = false, .pollnext = NULL}
+#else
+#define PROCESS(name,threadname) \
+   int process_thread_##threadname(process_t *process, process_event_t *evt);  \
+   process_t name = {.thread = process_thread_##threadname, .data = 0, .pollreq = false, .pollnext = NULL}
+#endif
+
+#if defined(CONFIG_MYOS_PROC_LOCALS)
+/**
+ * @def PROCESS_LOCALS_TYPEDEF(threadname, ...)
+ * @brief Declares the local variables of a process thread.
+ *
+ * @param threadname The name of the process thread function.
+ * @param ... The struct type holding the locals, e.g. `struct { int i; uint8_t *p; }`.
+ *
+ * @details
+ * Protothread locals do not survive a wait, so they are usually `static`, which ties
+ * them to the thread function and allows only one process per thread. Locals declared
+ * here live in every process defined with PROCESS_WITH_LOCALS() instead, so several
+ * processes can run the same thread, each with its own variables. The thread accesses
+ * them with PROCESS_LOCALS(). They are zeroed by process_start().
+ *
+ * Example usage:
+ * @code
+ * PROCESS_LOCALS_TYPEDEF(uart_rx, struct {
+ *    uint8_t count;
+ *    uint8_t line[32];
+ * });
+ *
+ * PROCESS_WITH_LOCALS(uart0_rx, uart_rx);
+ * PROCESS_WITH_LOCALS(uart1_rx, uart_rx);
+ *
+ * PROCESS_THREAD(uart_rx)
+ * {
+ *    PROCESS_BEGIN();
+ *    for(;;) {
+ *       PROCESS_WAIT_EVENT_UNTIL(PROCESS_EVENT_ID() == UART_EVENT_RX);
+ *       PROCESS_LOCALS(uart_rx)->line[PROCESS_LOCALS(uart_rx)->count++] = ...;
+ *    }
+ *    PROCESS_END();
+ * }
+ * @endcode
+ */
+#define PROCESS_LOCALS_TYPEDEF(threadname,...) \
+   typedef __VA_ARGS__ process_locals_##threadname##_t
+
+/**
+ * @def PROCESS_LOCALS(threadname)
+ * @brief Accesses the locals of the current process.
+ *
+ * @param threadname The name of the process thread function.
+ * @return Pointer to the locals declared with PROCESS_LOCALS_TYPEDEF().
+ */
+#define PROCESS_LOCALS(threadname) \
+   ((process_locals_##threadname##_t*)process->locals)
+
+/**
+ * @def PROCESS_WITH_LOCALS(name, threadname)
+ * @brief Declares and initializes a process with its own storage for the thread locals.
+ *
+ * @param name The name of the process variable.
+ * @param threadname The name of the process thread function, whose locals were
+ *        declared with PROCESS_LOCALS_TYPEDEF().
+ *
+ * @details
+ * Like PROCESS(), but also defines the locals of the process next to it.
+ */
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+#define PROCESS_WITH_LOCALS(name,threadname) \
+   int process_thread_##threadname(process_t *process, process_event_t *evt);  \
+   static process_locals_##threadname##_t process_locals_##name; \
+   STRUCT_SECTION_ITERABLE(process_t, name) = {.thread = process_thread_##threadname, .data = 0, \
+      .locals = &process_locals_##name, .localsize = sizeof(process_locals_##name), .pollreq = false, .pollnext = NULL}
+#else
+#define PROCESS_WITH_LOCALS(name,threadname) \
+   int process_thread_##threadname(process_t *process, process_event_t *evt);  \
+   static process_locals_##threadname##_t process_locals_##name; \
+   process_t name = {.thread = process_thread_##threadname, .data = 0, \
+      .locals = &process_locals_##name, .localsize = sizeof(process_locals_##name), .pollreq = false, .pollnext = NULL}
+#endif
+#endif
 
 /**
  * @def PROCESS_EXTERN(name)
@@ -368,6 +686,123 @@ extern process_t *process_current;
 #define PROCESS_EXTERN(name) \
       extern process_t name
 
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+/**
+ * @typedef process_id_t
+ * @brief Index of a process in the static process table.
+ *
+ * @details
+ * All processes defined with PROCESS() form one array in the linker section of the
+ * process table, sorted by name. The id of a process is its index in that array, so
+ * there can be at most 255 processes.
+ */
+typedef uint8_t process_id_t;
+
+/**
+ * @def PROCESS_ID_NONE
+ * @brief Process id standing for no process, e.g. the sender of an event posted from an ISR.
+ */
+#define PROCESS_ID_NONE   UINT8_MAX
+
+STRUCT_SECTION_START_EXTERN(process_t);
+
+/**
+ * @brief Returns the id of a process.
+ *
+ * @param process Pointer to a process defined with PROCESS(), or NULL.
+ * @return Index of the process in the process table, PROCESS_ID_NONE for NULL.
+ */
+static inline process_id_t process_id(const process_t *process)
+{
+   return process ? (process_id_t)(process - TYPE_SECTION_START(process_t)) : PROCESS_ID_NONE;
+}
+
+/**
+ * @brief Returns the process with a given id.
+ *
+ * @param id Process id as returned by process_id().
+ * @return Pointer to the process, NULL for PROCESS_ID_NONE.
+ */
+static inline process_t* process_by_id(process_id_t id)
+{
+   return id == PROCESS_ID_NONE ? NULL : &TYPE_SECTION_START(process_t)[id];
+}
+
+/**
+ * @def PROCESS_FOREACH(iterator)
+ * @brief Iterates over all processes of the process table, running or not.
+ *
+ * @param iterator Name of the `process_t*` loop variable.
+ *
+ * @code
+ * PROCESS_FOREACH(p)
+ * {
+ *    if(PROCESS_IS_RUNNING(p)) { ... }
+ * }
+ * @endcode
+ */
+#define PROCESS_FOREACH(iterator) \
+   STRUCT_SECTION_FOREACH(process_t, iterator)
+#endif
+
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+/**
+ * @def PROCESS_BROADCAST
+ * @brief Target of events which are delivered to all running processes.
+ */
+#define PROCESS_BROADCAST   NULL
+
+/**
+ * @struct process_group_member_t
+ * @brief Membership of a process in a process group, see process_group_join().
+ *
+ * @var process_group_member_t::SLIST_NODE_TYPE
+ * Node in the member list of the group.
+ * @var process_group_member_t::process
+ * The member process.
+ */
+typedef struct {
+   SLIST_NODE_TYPE;
+   process_t *process;
+} process_group_member_t;
+
+/**
+ * @brief Thread function of all process groups, never called.
+ *
+ * @details
+ * Marks a process_t as a group, see PROCESS_IS_GROUP().
+ */
+int process_group_thread(process_t *process, process_event_t *evt);
+
+/**
+ * @def PROCESS_GROUP(name)
+ * @brief Declares and initializes a process group.
+ *
+ * @param name The name of the group variable.
+ *
+ * @details
+ * A group is a pseudo process which is used as target of events. An event posted to a
+ * group takes a single slot of the event queue and is delivered to all member processes
+ * when it is dispatched, in the order they joined. The group itself is never started.
+ */
+#if defined(CONFIG_MYOS_PROC_STATIC_TABLE)
+#define PROCESS_GROUP(name) \
+   static slistt_t name##_members = SLISTT_INITIALIZER(name##_members); \
+   STRUCT_SECTION_ITERABLE(process_t, name) = {.thread = process_group_thread, .data = &name##_members, .pollreq = false, .pollnext = NULL}
+#else
+#define PROCESS_GROUP(name) \
+   static slistt_t name##_members = SLISTT_INITIALIZER(name##_members); \
+   process_t name = {.thread = process_group_thread, .data = &name##_members, .pollreq = false, .pollnext = NULL}
+#endif
+
+/**
+ * @def PROCESS_IS_GROUP(processptr)
+ * @brief Check if a process is a process group.
+ */
+#define PROCESS_IS_GROUP(processptr) \
+   ((processptr)->thread == process_group_thread)
+#endif
+
 /**
  * @def PROCESS_DATA()
  * @brief Accesses the user-defined data associated with the current process.
@@ -444,6 +879,110 @@ extern process_t *process_current;
 #define PROCESS_THREAD(name) \
 int process_thread_##name(process_t *process, process_event_t *evt)
 
+#if defined(CONFIG_MYOS_PROC_CHILD)
+/**
+ * @typedef process_child_thread_t
+ * @brief Function type of child threads.
+ */
+typedef int(*process_child_thread_t)(process_child_t *process, process_event_t *evt);
+
+/**
+ * @struct process_child_t
+ * @brief Child thread of a process, started with PROCESS_SPAWN().
+ *
+ * @details
+ * PT_SPAWN() runs the child from its parent, so every event passes through every level
+ * of a nested state machine. A process instead keeps its innermost running child in
+ * `process_t::child` and process_deliver_event() calls that child directly, the parents
+ * are only resumed when their child has terminated. The cost of an event does not depend
+ * on the nesting depth.
+ *
+ * Inside a child thread `process` is the child, so PROCESS_PT() and PROCESS_DATA() refer
+ * to the child, all other process macros work as in the process thread and PROCESS_THIS()
+ * is the process. A PROCESS_EVENT_EXIT terminates the children one after the other, from
+ * the innermost to the process thread.
+ *
+ * @var process_child_t::thread
+ * The child thread function.
+ * @var process_child_t::data
+ * Data passed to PROCESS_SPAWN().
+ * @var process_child_t::pt
+ * Protothread state of the child.
+ * @var process_child_t::parent
+ * Child which spawned this child, NULL if it was the process thread.
+ */
+struct process_child_t {
+   process_child_thread_t thread;
+   void *data;
+   pt_t pt;
+   process_child_t *parent;
+};
+
+/**
+ * @def PROCESS_CHILD_THREAD(name)
+ * @brief Declares the function implementing a child thread.
+ *
+ * @param name The name of the child thread function.
+ */
+#define PROCESS_CHILD_THREAD(name) \
+int process_child_thread_##name(process_child_t *process, process_event_t *evt)
+
+/**
+ * @def PROCESS_SPAWN(childptr, threadname, dataptr)
+ * @brief Starts a child thread and waits until it has terminated.
+ *
+ * @param childptr Pointer to the process_child_t of the child, which must stay valid
+ *        until the child has terminated.
+ * @param threadname The name of the child thread function.
+ * @param dataptr Data passed to the child thread.
+ *
+ * @details
+ * The child runs at once with the current event. Unless it terminates right away, the
+ * calling thread is suspended and the following events of the process go straight to
+ * the child. Can be used in the process thread and in child threads.
+ *
+ * Example usage:
+ * @code
+ * PROCESS_CHILD_THREAD(handshake)
+ * {
+ *    PROCESS_BEGIN();
+ *    send_hello();
+ *    PROCESS_WAIT_EVENT_UNTIL(PROCESS_EVENT_ID() == LINK_EVENT_ACK);
+ *    PROCESS_END();
+ * }
+ *
+ * PROCESS_THREAD(link)
+ * {
+ *    static process_child_t child;
+ *
+ *    PROCESS_BEGIN();
+ *    PROCESS_SPAWN(&child, handshake, NULL);
+ *    ...
+ *    PROCESS_END();
+ * }
+ * @endcode
+ */
+#define PROCESS_SPAWN(childptr,threadname,dataptr) \
+   do{ \
+      if(!process_child_start(PROCESS_THIS(), (childptr), process_child_thread_##threadname, (dataptr), evt)) \
+      { \
+         PT_YIELD(&PROCESS_PT()); \
+      } \
+   }while(0)
+
+/**
+ * @brief Starts a child thread of a process, use PROCESS_SPAWN().
+ *
+ * @param process The process, the child receives its events.
+ * @param child The child to start.
+ * @param thread The child thread function.
+ * @param data Data passed to the child.
+ * @param evt Event the child runs with first.
+ * @return True if the child has terminated already, False if it is running.
+ */
+bool process_child_start(process_t *process, process_child_t *child, process_child_thread_t thread, void *data, process_event_t *evt);
+#endif
+
 /**
  * @def PROCESS_RESPOND(evtid, dataptr)
  * @brief Respond to an event within a process.
@@ -482,10 +1021,31 @@ int process_thread_##name(process_t *process, process_event_t *evt)
  *
  * @details
  * This macro checks if a given process is currently running by examining its protothread
- * state. It is useful for determining the status of processes in the system.
+ * state. It is useful for determining the status of processes in the system. A process
+ * started with process_start_lazy() is running before its thread has run.
  */
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+#define PROCESS_IS_RUNNING(processptr) \
+   (PT_IS_RUNNING(&(processptr)->pt) || (processptr)->lazy)
+#else
 #define PROCESS_IS_RUNNING(processptr) \
    (PT_IS_RUNNING(&(processptr)->pt))
+#endif
+
+/**
+ * @def PROCESS_IS_SUSPENDED(processptr)
+ * @brief Check if a running process is suspended, see process_suspend().
+ *
+ * @param processptr Pointer to the process.
+ * @return True if the process is suspended, always False without CONFIG_MYOS_PROC_SUSPEND.
+ */
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+#define PROCESS_IS_SUSPENDED(processptr) \
+   ((processptr)->suspended != PROCESS_SUSPEND_NONE)
+#else
+#define PROCESS_IS_SUSPENDED(processptr) \
+   (false)
+#endif
 
 /**
  * @def PROCESS_BEGIN()
@@ -519,8 +1079,24 @@ int process_thread_##name(process_t *process, process_event_t *evt)
  * @details
  * This macro is used within a process thread to block the process's execution until
  * a specific event with the given ID is posted to it.
+ *
+ * With CONFIG_MYOS_PROC_EVENT_FILTER the awaited event is stored in the process, and
+ * process_deliver_event() drops all other events, except PROCESS_EVENT_EXIT, without
+ * switching to the process. The thread would only have discarded them. This also
+ * applies to PROCESS_YIELD(). Waits on a condition, PROCESS_WAIT_EVENT_UNTIL(), still
+ * run the thread for every event.
  */
+#if defined(CONFIG_MYOS_PROC_EVENT_FILTER)
+#define PROCESS_WAIT_EVENT(evtid) \
+   do{ \
+      PROCESS_THIS()->waitfor = (evtid); \
+      PROCESS_THIS()->filter = true; \
+      PT_YIELD_UNTIL(&PROCESS_PT(), PROCESS_EVENT_ID() == (evtid)); \
+      PROCESS_THIS()->filter = false; \
+   }while(0)
+#else
 #define PROCESS_WAIT_EVENT(evtid) PT_YIELD_UNTIL(&PROCESS_PT(), PROCESS_EVENT_ID() == evtid)
+#endif
 
 /**
  * @def PROCESS_WAIT_EVENT_UNTIL(cond)
@@ -544,6 +1120,33 @@ int process_thread_##name(process_t *process, process_event_t *evt)
  */
 #define PROCESS_WAIT_ANY_EVENT() PT_YIELD(&PROCESS_PT())
 
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+/**
+ * @def PROCESS_POST_WAIT(to, evtid, dataptr)
+ * @brief Posts an event, blocking the process until the event queue has room for it.
+ *
+ * @param to Pointer to the target process.
+ * @param evtid The event identifier.
+ * @param dataptr Pointer to data associated with the event.
+ *
+ * @details
+ * Tries `process_post_or_wait` and blocks the process until it succeeds. The process is
+ * polled when an event has been taken from the event queue, and retries then. Events which
+ * arrive meanwhile are consumed by the wait. The arguments are evaluated for every try, so
+ * they must not refer to local variables of the process thread.
+ *
+ * Usage example:
+ * @code
+ * while(1) {
+ *    PROCESS_WAIT_EVENT(ADC_EVENT_SAMPLE);
+ *    PROCESS_POST_WAIT(&filter_process, FILTER_EVENT_SAMPLE, PROCESS_EVENT_DATA());
+ * }
+ * @endcode
+ */
+#define PROCESS_POST_WAIT(to,evtid,dataptr) \
+   PT_WAIT_UNTIL(&PROCESS_PT(), process_post_or_wait(to, evtid, dataptr))
+#endif
+
 /**
  * @def PROCESS_YIELD()
  * @brief Temporarily suspends the process.
@@ -559,6 +1162,46 @@ int process_thread_##name(process_t *process, process_event_t *evt)
       PROCESS_WAIT_EVENT(PROCESS_EVENT_CONTINUE); \
    }while(0)
 
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+/**
+ * @def PROCESS_BUDGET_EXCEEDED()
+ * @brief Checks whether the current time slice has used up the budget of the process.
+ *
+ * @details
+ * The slice starts when the event currently handled is delivered, the budget is set with
+ * process_start_budget() or defaults to CONFIG_MYOS_PROC_BUDGET_DEFAULT.
+ */
+#define PROCESS_BUDGET_EXCEEDED() \
+   ((rtimer_timespan_t)(rtimer_now() - PROCESS_THIS()->slicestart) >= PROCESS_THIS()->budget)
+
+/**
+ * @def PROCESS_YIELD_IF_BUDGET_EXCEEDED()
+ * @brief Yields only if the current time slice has used up the budget of the process.
+ *
+ * @details
+ * A long computation calls this once per step instead of PROCESS_YIELD(). It keeps the
+ * processor for up to its budget, however long a step takes, so it neither blocks the
+ * other processes for too long nor pays an event round trip for every step. Without
+ * CONFIG_MYOS_PROC_BUDGET this is PROCESS_YIELD().
+ *
+ * @code
+ * for(i = 0; i < n; i++) {
+ *    compute_step(i);
+ *    PROCESS_YIELD_IF_BUDGET_EXCEEDED();
+ * }
+ * @endcode
+ */
+#define PROCESS_YIELD_IF_BUDGET_EXCEEDED() \
+   do{ \
+      if(PROCESS_BUDGET_EXCEEDED()) \
+      { \
+         PROCESS_YIELD(); \
+      } \
+   }while(0)
+#else
+#define PROCESS_YIELD_IF_BUDGET_EXCEEDED() PROCESS_YIELD()
+#endif
+
 
 /**
  * @def PROCESS_EXITHANDLER(handler)
@@ -642,6 +1285,99 @@ void process_init(void);
  */
 bool process_start(process_t *process, void* data);
 
+#if defined(CONFIG_MYOS_PROC_BUDGET)
+/**
+ * @brief Starts a process with a time slice budget.
+ *
+ * @param process Pointer to the process to be started.
+ * @param data Pointer to data to be passed to the process.
+ * @param budget Time slice budget in rtimer ticks, see PROCESS_YIELD_IF_BUDGET_EXCEEDED().
+ * @return True if the process was successfully started, False otherwise.
+ *
+ * @details
+ * Like process_start(), which uses a budget of CONFIG_MYOS_PROC_BUDGET_DEFAULT.
+ */
+bool process_start_budget(process_t *process, void* data, rtimer_timespan_t budget);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+/**
+ * @brief Starts a process without running its thread.
+ *
+ * @param process Pointer to the process to be started.
+ * @param data Pointer to data to be passed to the process.
+ * @return True if the process was successfully started, False otherwise.
+ *
+ * @details
+ * Like process_start(), but PROCESS_EVENT_START is delivered right before the first event
+ * or poll of the process, so the thread runs up to its first wait only when there is work
+ * for it. The process counts as running from the start on and receives broadcasts. Its
+ * first PROCESS_EVENT_EXIT terminates it without PROCESS_EVENT_START.
+ *
+ * Example usage:
+ * @code
+ * process_start_lazy(&logger_process, NULL);   // runs on the first log event
+ * @endcode
+ */
+bool process_start_lazy(process_t *process, void* data);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_AUTOSTART)
+/**
+ * @struct process_autostart_t
+ * @brief Entry of the autostart table, see PROCESS_AUTOSTART().
+ *
+ * @var process_autostart_t::process
+ * The process to start.
+ * @var process_autostart_t::lazy
+ * Start it with process_start_lazy().
+ */
+typedef struct process_autostart_t {
+   process_t *process;
+   bool lazy;
+} process_autostart_t;
+
+/**
+ * @def PROCESS_AUTOSTART(name, level)
+ * @brief Starts a process from myos_init().
+ *
+ * @param name The process, defined with PROCESS().
+ * @param level Init level, a single digit from 0 to 9.
+ *
+ * @details
+ * myos_init() starts the processes of level 0 first, then those of level 1 and so on, and
+ * within a level in the order of their names, like the Zephyr SYS_INIT() priorities. The
+ * time to the first iteration of a critical process is bounded by the levels before it,
+ * no matter how many processes there are in the later levels.
+ *
+ * @code
+ * PROCESS_AUTOSTART(control, 0);
+ * PROCESS_AUTOSTART_LAZY(logger, 9);
+ * @endcode
+ */
+#define PROCESS_AUTOSTART(name,level) \
+   PROCESS_AUTOSTART_ENTRY(name, level, false)
+
+#if defined(CONFIG_MYOS_PROC_LAZY_START)
+/**
+ * @def PROCESS_AUTOSTART_LAZY(name, level)
+ * @brief Starts a process from myos_init() with process_start_lazy(), see PROCESS_AUTOSTART().
+ */
+#define PROCESS_AUTOSTART_LAZY(name,level) \
+   PROCESS_AUTOSTART_ENTRY(name, level, true)
+#endif
+
+#define PROCESS_AUTOSTART_ENTRY(name,level,lazystart) \
+   BUILD_ASSERT((level) >= 0 && (level) <= 9, "PROCESS_AUTOSTART level is a single digit"); \
+   static const STRUCT_SECTION_ITERABLE_NAMED(process_autostart_t, level##_##name, \
+      process_autostart_##name) = {.process = &name, .lazy = (lazystart)}
+
+/**
+ * @brief Starts the processes of PROCESS_AUTOSTART(), called by myos_init().
+ */
+void process_autostart(void);
+#endif
+
 /**
  * @brief Exits a process.
  *
@@ -670,6 +1406,53 @@ bool process_start(process_t *process, void* data);
  */
 bool process_exit(process_t *process);
 
+#if defined(CONFIG_MYOS_PROC_SUSPEND)
+/**
+ * @brief Suspends a running process.
+ *
+ * @param process Pointer to the process to be suspended.
+ * @param policy PROCESS_SUSPEND_DROP to drop the events and polls to the process while it
+ *        is suspended, PROCESS_SUSPEND_PARK to keep them for process_resume().
+ * @return True if the process was suspended, False if it is not running or already
+ *         suspended.
+ *
+ * @details
+ * The process is taken out of the list of running processes, so broadcasts and
+ * process_running_next() skip it, and its thread does not run until it is resumed, except
+ * for PROCESS_EVENT_EXIT, which is always delivered. Its ptimers, etimers and rtimers keep
+ * running, their events are dropped or parked like all others.
+ *
+ * Parked events take a slot of the pool of CONFIG_MYOS_PROC_SUSPEND_PARK_COUNT slots shared
+ * by all suspended processes. Events that find the pool empty are dropped and set
+ * `myos_stats.errflags.parkpool`. Polls are parked without a slot, repeated polls are
+ * merged as usual.
+ *
+ * A process may suspend itself, it then keeps running until it yields. With
+ * CONFIG_MYOS_INSTANCES > 1 only processes of the own instance are suspended and resumed.
+ *
+ * @code
+ * process_suspend(&sensor_process, PROCESS_SUSPEND_PARK);
+ * ...
+ * process_resume(&sensor_process);
+ * @endcode
+ */
+bool process_suspend(process_t *process, process_suspend_t policy);
+
+/**
+ * @brief Resumes a suspended process.
+ *
+ * @param process Pointer to the process to be resumed.
+ * @return True if the process was resumed, False if it is not suspended.
+ *
+ * @details
+ * Puts the process back into the list of running processes and delivers its parked events
+ * synchronously, in the order they were posted and before any event posted after the resume.
+ * A parked poll request is queued again. Must be called from the MyOS thread, not from an
+ * ISR.
+ */
+bool process_resume(process_t *process);
+#endif
+
 /**
  * @brief Posts an event to a process.
  *
@@ -699,6 +1482,319 @@ bool process_exit(process_t *process);
  */
 bool process_post(process_t *to, process_event_id_t evtid, void* data);
 
+#if defined(CONFIG_MYOS_PROC_EVENT_PAYLOAD_POOL)
+/**
+ * @brief Reserves a payload slot for an event.
+ *
+ * @return Pointer to a payload slot of CONFIG_MYOS_PROC_EVENT_PAYLOAD_SIZE bytes,
+ *         NULL if all slots are in use.
+ *
+ * @details
+ * The slot is passed as `data` to `process_post`, `process_post_prio` or
+ * `process_post_sync`. Every successful post takes a reference to the slot, and
+ * `process_deliver_event` drops it once the recipient has handled the event, or
+ * has discarded it because it is not running anymore. The slot returns to the
+ * pool with the last reference, so the producer neither copies the data nor
+ * keeps it alive by convention.
+ *
+ * @note
+ * A slot may be posted to several processes, but all posts must be done before
+ * the first of them is delivered. Since `process_post_sync` delivers immediately,
+ * it must be the last post of a slot. A slot which could not be posted must be
+ * returned with `process_post_free`. Slots must not be allocated or posted from
+ * ISRs or other threads, `process_post_isr` and `process_post_remote` do not take
+ * references and assert that `data` is not a slot.
+ *
+ * Example usage:
+ * @code
+ * sample_t *sample = process_post_alloc();
+ * if(sample) {
+ *    sample->value = adc_value;
+ *    if(!process_post(&filter_process, SAMPLE_EVENT, sample)) {
+ *       process_post_free(sample);
+ *    }
+ * }
+ * @endcode
+ */
+void* process_post_alloc(void);
+
+/**
+ * @brief Returns a payload slot which has not been posted.
+ *
+ * @param payload Pointer returned by `process_post_alloc`. Slots which are
+ *        referenced by posted events are not released.
+ */
+void process_post_free(void *payload);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_SCRATCH)
+/**
+ * @brief Allocates scratch memory for the event which is being handled.
+ *
+ * @details
+ * The memory comes from the scratch arena of the process module and is released when
+ * the thread of the calling process returns, that is at its next wait or yield. It
+ * replaces oversized `static` buffers for temporary data, since protothread locals do
+ * not survive a wait. The block is aligned to ARENA_ALIGNMENT. An event delivered with
+ * `process_post_sync` from the handler gets a nested scope, the blocks of the caller
+ * stay valid.
+ *
+ * Example usage:
+ * @code
+ * PROCESS_WAIT_EVENT_UNTIL(PROCESS_EVENT_ID() == FRAME_EVENT);
+ * uint8_t *decoded = process_scratch_alloc(frame_len);
+ * if(decoded) {
+ *    decode(PROCESS_EVENT_DATA(), decoded);
+ *    ...
+ * }
+ * @endcode
+ *
+ * @param size Number of bytes.
+ * @return The block, NULL if the scratch arena (CONFIG_MYOS_PROC_SCRATCH_SIZE) is exhausted.
+ */
+void* process_scratch_alloc(size_t size);
+
+/**
+ * @brief Returns the scratch arena used by `process_scratch_alloc`, e.g. for arena_peak().
+ *
+ * @details
+ * With CONFIG_MYOS_INSTANCES > 1 every instance has its own, this is the one of the
+ * instance of the calling thread.
+ */
+arena_t* process_scratch_arena(void);
+#endif
+
+/**
+ * @brief Posts an event to a process from an interrupt service routine.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was successfully posted, False if the ISR event queue is full.
+ *
+ * @details
+ * Works like `process_post`, but queues the event in a lock-free single-producer/
+ * single-consumer ringbuffer of CONFIG_MYOS_PROC_ISR_EVENT_QUEUE_SIZE events, so no
+ * interrupts are locked. The `from` field of the event is NULL. `process_run` delivers
+ * the events posted from ISRs before the events of the regular event queue.
+ *
+ * @note
+ * There is a single producer side. All callers of this function must not preempt each
+ * other, i.e. call it from ISRs of the same interrupt priority only, or from a single
+ * ISR. `process_post` must not be called from ISRs.
+ *
+ * `data` is handed over as is, pooled payloads from `process_post_alloc` must not be
+ * used.
+ *
+ * Example usage:
+ * @code
+ * void uart_isr(void) {
+ *    process_post_isr(&uart_process, UART_EVENT_RX, NULL);
+ * }
+ * @endcode
+ */
+bool process_post_isr(process_t *to, process_event_id_t evtid, void* data);
+
+#if defined(CONFIG_MYOS_PROC_EVENT_EDF)
+/**
+ * @brief Posts an event to a process with a deadline.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @param deadline Timestamp by which the event should have been delivered.
+ * @return True if the event was successfully posted, False if the deadline queue is full.
+ *
+ * @details
+ * Queues the event in an earliest-deadline-first queue of CONFIG_MYOS_PROC_EDF_QUEUE_SIZE
+ * events. `process_run` delivers the event with the earliest deadline first, events with
+ * the same deadline in the order they were posted. Deadline events are delivered after
+ * the events posted from ISRs and other threads and before the events of the priority
+ * levels. All pending deadlines must be within half the timestamp range of each other.
+ *
+ * Expired etimers post their events with a deadline of the timer stop plus the slack
+ * of the etimer, see `etimer_start_slack`.
+ *
+ * Example usage:
+ * @code
+ * process_post_deadline(&control_process, CONTROL_EVENT_SAMPLE, NULL, timestamp_now() + 2);
+ * @endcode
+ */
+bool process_post_deadline(process_t *to, process_event_id_t evtid, void* data, timestamp_t deadline);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_POST_REMOTE)
+/**
+ * @brief Posts an event to a process from another Zephyr thread or CPU core.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was successfully posted, False if the mailbox is full.
+ *
+ * @details
+ * Queues the event in a lock-free multi-producer mailbox of
+ * CONFIG_MYOS_PROC_REMOTE_EVENT_QUEUE_SIZE slots and wakes up the MyOS thread. Any number
+ * of threads, ISRs and cores may post concurrently, no lock is taken. The `from` field of
+ * the event is NULL. `process_run` delivers remote events after the events posted from
+ * ISRs and before the events of the regular event queue.
+ *
+ * @note
+ * With CONFIG_MYOS_INSTANCES > 1 every instance has its own mailbox, the event is queued
+ * in the one of the instance `to` belongs to. Events posted to a process of another
+ * instance from within a process take the same way.
+ *
+ * `data` is handed over to the MyOS thread as is. It must stay valid until the event has
+ * been handled, and pooled payloads from `process_post_alloc` must not be used, because
+ * the pool is not shared between threads. An assertion rejects them.
+ *
+ * Example usage:
+ * @code
+ * void sensor_thread(void) {
+ *    for(;;) {
+ *       k_sleep(K_MSEC(100));
+ *       process_post_remote(&sensor_process, SENSOR_EVENT_SAMPLE, NULL);
+ *    }
+ * }
+ * @endcode
+ */
+bool process_post_remote(process_t *to, process_event_id_t evtid, void* data);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_BROADCAST)
+/**
+ * @brief Adds a process to a process group.
+ *
+ * @param group The group, defined with PROCESS_GROUP().
+ * @param member Membership node, must stay valid until process_group_leave().
+ * @param process The process which receives the events of the group.
+ *
+ * Example usage:
+ * @code
+ * PROCESS_GROUP(sensor_listeners);
+ * static process_group_member_t membership;
+ *
+ * process_group_join(&sensor_listeners, &membership, PROCESS_THIS());
+ * @endcode
+ */
+void process_group_join(process_t *group, process_group_member_t *member, process_t *process);
+
+/**
+ * @brief Removes a process from a process group.
+ *
+ * @param group The group the member has joined.
+ * @param member Membership node passed to process_group_join().
+ */
+void process_group_leave(process_t *group, process_group_member_t *member);
+
+/**
+ * @brief Posts an event to all running processes.
+ *
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was successfully posted, False if the event queue is full.
+ *
+ * @details
+ * Queues a single event with the target PROCESS_BROADCAST. It is delivered to every
+ * running process, including the sender, when it is dispatched. A process started by
+ * one of the recipients does not receive it anymore. Pooled payloads are released after
+ * the last recipient.
+ */
+static inline bool process_post_broadcast(process_event_id_t evtid, void* data)
+{
+   return process_post(PROCESS_BROADCAST, evtid, data);
+}
+
+/**
+ * @brief Posts an event to all members of a process group.
+ *
+ * @param group The group, defined with PROCESS_GROUP().
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was successfully posted, False if the event queue is full.
+ *
+ * @details
+ * Queues a single event, which is delivered to the running members of the group when
+ * it is dispatched, see PROCESS_GROUP(). Any other post function may be used with a
+ * group as target as well.
+ */
+static inline bool process_post_group(process_t *group, process_event_id_t evtid, void* data)
+{
+   return process_post(group, evtid, data);
+}
+#endif
+
+#if defined(CONFIG_MYOS_PROC_EVENT_COALESCE)
+/**
+ * @brief Posts an event to a process, merging it with a pending one.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was posted or merged, False if the event queue is full.
+ *
+ * @details
+ * Works like `process_post`, but if an event with the same target and id which was posted
+ * with `process_post_coalesce` is still pending, only its data is replaced by `data`. The
+ * pending event keeps its place in the queue, the target receives the most recent data
+ * once. Bursty producers thus take at most one slot of the event queue per target and id.
+ *
+ * Pending coalescable events are tracked in a hash index of
+ * CONFIG_MYOS_PROC_COALESCE_INDEX_SIZE entries. If more than half of them are in use, the
+ * event is queued like a plain post.
+ *
+ * Example usage:
+ * @code
+ * void sensor_sample(int16_t *sample) {
+ *    process_post_coalesce(&filter_process, SENSOR_EVENT_SAMPLE, sample);
+ * }
+ * @endcode
+ */
+bool process_post_coalesce(process_t *to, process_event_id_t evtid, void* data);
+#endif
+
+#if defined(CONFIG_MYOS_PROC_POST_WAIT)
+/**
+ * @brief Posts an event, or registers the current process to be polled once it may retry.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @return True if the event was posted, False if the caller has to retry.
+ *
+ * @details
+ * Works like `process_post`. If the event queue is full, or if CONFIG_MYOS_PROC_POST_QUOTA
+ * of the events posted by the current process are still pending, the event is not posted
+ * and the process is appended to a FIFO of waiting processes. Whenever an event is taken
+ * from the priority level queues, the first waiting process is polled. Must be called from
+ * a process, PROCESS_POST_WAIT() is the blocking wrapper.
+ */
+bool process_post_or_wait(process_t *to, process_event_id_t evtid, void* data);
+#endif
+
+/**
+ * @brief Posts an event to a process with a given priority.
+ *
+ * @param to Pointer to the target process to which the event is posted.
+ * @param evtid The event identifier.
+ * @param data Pointer to data associated with the event.
+ * @param prio Priority level, PROCESS_EVENT_PRIO_HIGHEST (0) up to PROCESS_EVENT_PRIO_LOWEST.
+ * @return True if the event was successfully posted, False if the queue of that
+ *         priority level is full or the priority level does not exist.
+ *
+ * @details
+ * Works like `process_post`, but queues the event in the ringbuffer of the given
+ * priority level. `process_run` always delivers the events of the highest non-empty
+ * priority level first, events of the same level are delivered in FIFO order.
+ * `process_post` is a shortcut for posting with PROCESS_EVENT_PRIO_DEFAULT.
+ *
+ * Example usage:
+ * @code
+ * process_post_prio(&control_process, CONTROL_EVENT, sample, PROCESS_EVENT_PRIO_HIGHEST);
+ * @endcode
+ */
+bool process_post_prio(process_t *to, process_event_id_t evtid, void* data, process_event_prio_t prio);
+
 /**
  * @brief Posts an event to a process synchronously.
  *
@@ -739,7 +1835,8 @@ bool process_post_sync(process_t *to, process_event_id_t evtid, void* data);
  * @details
  * This function runs the process scheduler of the operating system. It handles
  * all pending poll requests and then delivers events from the event queue to
- * the corresponding processes.
+ * the corresponding processes. Events posted with `process_post_isr` are taken
+ * first, otherwise the event is taken from the highest non-empty priority level.
  *
  * Poll requests are typically triggered by interrupts and are processed first.
  * Each process that has a pending poll request will be handled, and the
@@ -765,6 +1862,40 @@ bool process_post_sync(process_t *to, process_event_id_t evtid, void* data);
  */
 int process_run(void);
 
+/**
+ * @brief Runs the process scheduler for a batch of events.
+ *
+ * @param max_events Maximum number of events to deliver, 0 for no limit.
+ * @param max_rtimer_ticks Time budget in rtimer ticks, 0 for no limit.
+ * @return The number of events remaining in the event queue plus the number
+ *         of outstanding poll requests.
+ *
+ * @details
+ * Works like `process_run`, but delivers events until the event queue is empty,
+ * `max_events` events have been delivered or `max_rtimer_ticks` have elapsed since
+ * the call, whichever comes first. The budget is checked after each event, so at
+ * least one event is delivered if there is any, and a single long running event
+ * handler may exceed the time budget.
+ *
+ * Pending poll requests are handled before every event, which costs a single
+ * check if no poll request has arrived. The statistics timestamps
+ * are taken once per batch instead of once per event, which makes this function
+ * suited to drain bursts of events, e.g. from an ISR.
+ *
+ * @note
+ * With `CONFIG_MYOS_STATISTICS` the maximum processing time statistic covers the
+ * whole batch.
+ *
+ * Example usage:
+ * @code
+ * while(1) {
+ *   // Deliver up to 16 events or for up to 1000 rtimer ticks.
+ *   process_run_batch(16, 1000);
+ * }
+ * @endcode
+ */
+int process_run_batch(size_t max_events, rtimer_timespan_t max_rtimer_ticks);
+
 /**
  * @brief Requests a poll for a specific process.
  *
@@ -773,17 +1904,20 @@ int process_run(void);
  * @details
  * This function is used to request a poll for a specific process. When called,
  * it sets the `pollreq` flag of the specified process to true, indicating that
- * the process should be polled. Additionally, it sets a global flag
- * `process_global_pollreq` to true, indicating that at least one process needs
- * to be polled.
+ * the process should be polled, and appends the process to the pending-poll
+ * queue. Polling a process which already has a pending poll request has no
+ * further effect.
  *
- * The actual polling is performed in the `process_run` function, where all
- * processes with the `pollreq` flag set will be processed.
+ * The actual polling is performed in the `process_run` function, which only
+ * visits the processes in the pending-poll queue, in the order they were polled.
+ * The cost of dispatching polls therefore scales with the number of polled
+ * processes, not with the number of running processes.
  *
  * @note
  * This function is typically used by interrupt service routines or other parts
  * of the system that need to trigger a process to run outside of its normal
- * scheduling.
+ * scheduling. The pending-poll queue is updated within a critical section, so
+ * this function is safe to be called from an ISR.
  *
  * Debugging messages are printed with information about the process polling
  * request if the DEBUG_PROCESS macro is defined.
@@ -795,6 +1929,78 @@ int process_run(void);
  */
 void process_poll(process_t *process);
 
+#if defined(CONFIG_MYOS_STATISTICS_HISTOGRAMS)
+/**
+ * @brief Copies the histograms of a process, optionally resetting them.
+ *
+ * @param process Pointer to the process.
+ * @param snapshot Pointer to the copy, may be NULL to only reset.
+ * @param reset If true, the histograms of the process are cleared after the copy.
+ *
+ * @details
+ * Must be called from the MyOS thread, e.g. from a process, like all other functions
+ * updating the histograms.
+ *
+ * Example usage:
+ * @code
+ * process_stats_t s;
+ * process_stats_snapshot(&my_process, &s, true);
+ * printf("p99 slice time < %u ticks\n", (unsigned)process_stats_percentile(s.slicetime, 99));
+ * @endcode
+ */
+void process_stats_snapshot(process_t *process, process_stats_t *snapshot, bool reset);
+
+/**
+ * @brief Returns an upper bound of a percentile of a histogram.
+ *
+ * @param hist One of the histograms of a `process_stats_t`.
+ * @param percent The percentile, 0 to 100.
+ * @return The exclusive upper bound 2^k of the bucket k holding the percentile, 0 if the
+ *         histogram is empty. UINT32_MAX if the percentile is in the last bucket.
+ */
+uint32_t process_stats_percentile(const uint32_t *hist, uint8_t percent);
+#endif
+
+/**
+ * @brief Iterates over the running processes.
+ *
+ * @param process The previous process, NULL to get the first one.
+ * @return The next running process, NULL after the last one.
+ *
+ * @details
+ * Suspended processes are skipped, see process_suspend(). With CONFIG_MYOS_INSTANCES > 1
+ * only the processes of the instance of the calling thread are returned.
+ *
+ * The current process must not exit while it is the iterator, so this is meant for the
+ * MyOS thread or for other threads with the scheduler locked.
+ *
+ * @code
+ * for(process_t *p = process_running_next(NULL); p != NULL; p = process_running_next(p))
+ * {
+ *    ...
+ * }
+ * @endcode
+ */
+process_t *process_running_next(process_t *process);
+
+#if CONFIG_MYOS_INSTANCES > 1
+/**
+ * @brief Binds the calling thread to a MyOS instance.
+ *
+ * @param instance Index of the instance, less than CONFIG_MYOS_INSTANCES.
+ *
+ * @details
+ * Called once by the thread of an instance before it calls `process_run`, see
+ * `myos_instance_start`. Threads which are not bound use the first instance.
+ */
+void process_instance_bind(uint8_t instance);
+
+/**
+ * @brief Returns the index of the MyOS instance of the calling thread.
+ */
+uint8_t process_instance_id(void);
+#endif
+
 #endif /* PROCESS_H_ */
 
 
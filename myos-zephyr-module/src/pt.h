@@ -62,6 +62,8 @@
  * - Removal of the local auto variable PT_YIELD_FLAG required for suspending the task.
  * - Addition of the LC_SET_YIELD macro to properly suspend and resume protothreads.
  * - Modifications to enhance portability and efficiency in different environments.
+ * - Optional local continuations based on GCC labels as values
+ *   (CONFIG_MYOS_PT_LC_ADDRLABELS).
  *
  * Protothreads are particularly effective in event-driven systems where tasks do
  * not need to be executed simultaneously but rather wait for specific events or
@@ -78,8 +80,47 @@
 #define PT_H_
 
 #include <stdint.h>
+#include <stddef.h>
 
 
+#if defined(CONFIG_MYOS_PT_LC_ADDRLABELS)
+
+/**
+ * @brief Typedef for local continuation state.
+ *
+ * @details The address of the label to resume at. NULL resumes at the beginning,
+ *          LC_DEFAULT at the end of the protothread.
+ */
+typedef void * lc_t;
+
+/**
+ * @brief Local continuations based on the GCC "labels as values" extension.
+ *
+ * @details Resuming is a single indirect jump instead of a switch dispatch over
+ *          all the wait points. The labels are numbered with __COUNTER__, so unlike
+ *          the switch implementation several waits may share a source line and
+ *          switch statements may contain waits. The end label is unique per
+ *          function, which allows one protothread per function, as before.
+ */
+/*!\{*/
+
+#define LC_CONCAT2(s1,s2) s1##s2
+#define LC_CONCAT(s1,s2) LC_CONCAT2(s1,s2)
+#define LC_LABEL(n) LC_CONCAT(lc_label_,n)
+
+#define LC_INIT(s) s = NULL;
+#define LC_DEFAULT ((lc_t)~(uintptr_t)0)
+#define LC_SET_DEFAULT(s) s = LC_DEFAULT
+#define LC_RESUME(s) do { if((s) == LC_DEFAULT) goto lc_end; if((s) != NULL) goto *(s); } while(0);
+#define LC_SET(s) LC_SET_LABEL(s,LC_LABEL(__COUNTER__))
+#define LC_SET_LABEL(s,label) s = &&label; label:
+#define LC_SET_YIELD(s,retval) LC_SET_YIELD_LABEL(s,retval,LC_LABEL(__COUNTER__))
+#define LC_SET_YIELD_LABEL(s,retval,label) s = &&label; return retval; label:
+#define LC_END(s) lc_end:;
+/*!\}*/
+
+#else
+
 /**
  * @brief Typedef for local continuation state.
  *
@@ -183,6 +224,8 @@ typedef uint16_t lc_t;
  */
 #define LC_END(s) default:;}
 
+#endif /* CONFIG_MYOS_PT_LC_ADDRLABELS */
+
 
 
 /**
@@ -271,7 +314,7 @@ typedef uint8_t ptstate_t;
  * }
  * \endcode
  */
-#define PT_IS_RUNNING(pt) ( ((pt)->lc > 0) && ((pt)->lc != LC_DEFAULT) )
+#define PT_IS_RUNNING(pt) ( ((pt)->lc != 0) && ((pt)->lc != LC_DEFAULT) )
 
 
 
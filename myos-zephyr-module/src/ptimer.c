@@ -55,7 +55,9 @@
  *     }
  * @endcode
  */
+#if !defined(CONFIG_MYOS_PTIMER_ENGINE_WHEEL)
 static ptlist_t ptimer_running_list;
+#endif
 
 /*!
  * @var ptimer_next_stop
@@ -97,6 +99,14 @@ timestamp_t ptimer_next_stop = 0;
  */
 bool ptimer_pending = false;
 
+/*!
+ * @var ptimer_sweep
+ * @brief Number of the current expiry pass of ptimer_process, wrapping around.
+ * @details The handlers called within one pass see the same value. The etimer batches use it to
+ *          tell which etimers expired together.
+ */
+uint8_t ptimer_sweep = 0;
+
 #if defined(CONFIG_MYOS_STATISTICS)
 /*!
  * @var ptimer_list_size
@@ -139,6 +149,73 @@ const process_event_t ptimer_poll_evt = {
       .data = NULL
 };
 
+#if defined(CONFIG_MYOS_STATISTICS)
+#define ptimer_stats_add()                                        \
+   do{                                                            \
+      if(++ptimer_list_size > myos_stats.ptlist_size_max)         \
+      {                                                           \
+         myos_stats.ptlist_size_max = ptimer_list_size;           \
+      }                                                           \
+   }while(0)
+#define ptimer_stats_remove() do{ptimer_list_size--;}while(0)
+#else
+#define ptimer_stats_add() do{}while(0)
+#define ptimer_stats_remove() do{}while(0)
+#endif
+
+/*!
+ * @brief      Time at which the ptimer engine fires a process timer.
+ * @details    The stop time of the timer, or for a timer with slack the stop time + slack aligned down to a
+ *             multiple of the largest power of two not above the slack. The alignment works on the wrapping
+ *             timestamps, because the power of two divides the timestamp range.
+ *
+ * @param[in]  ptimer Pointer to the process timer.
+ * @return     The expiry time, truncated to timestamp_t.
+ */
+static inline timestamp_t ptimer_stop_of(const ptimer_t *ptimer)
+{
+   timestamp_t stop = (timestamp_t)timer_timestamp_stop(&ptimer->timer);
+
+   if( ptimer->slack )
+   {
+      timestamp_t grid = (timestamp_t)1 << (63 - __builtin_clzll((unsigned long long)ptimer->slack));
+      stop = (timestamp_t)(stop + ptimer->slack) & (timestamp_t)~(grid - 1);
+   }
+
+   return stop;
+}
+
+/*!
+ * @def ptimer_due(ptimerptr)
+ * @brief Checks if the ptimer engine has to fire a process timer.
+ */
+#define ptimer_due(ptimerptr) timestamp_passed(ptimer_stop_of(ptimerptr))
+
+
+/*!
+ * @brief      Expires a running process timer.
+ * @details    Marks the ptimer as no longer running, updates the statistics and calls the
+ *             handler of the ptimer if there is one. The ptimer must already be unlinked
+ *             from the engine, so the handler may re-arm it right away.
+ *
+ * @param[in]  ptimer Pointer to the expired process timer.
+ */
+static void ptimer_fire(ptimer_t *ptimer)
+{
+   ptimer->running = false;
+   ptimer_stats_remove();
+
+   // Call the handler if it exists
+   if(ptimer->handler)
+   {
+      TRACE(TRACE_PTIMER, 0, 0, ptimer, ptimer->handler);
+      ptimer->handler((void*)(ptimer));
+   }
+}
+
+
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_SCAN)
+
 /*!
  * @brief      Updates the next stop time for process timers.
  * @details    This internal function is crucial for efficient ptimer management in MyOS. It calculates
@@ -160,7 +237,7 @@ const process_event_t ptimer_poll_evt = {
  */
 static void ptimer_next_stop_update(ptimer_t *ptimer)
 {
-   timestamp_t this_stop = timer_timestamp_stop(&ptimer->timer);
+   timestamp_t this_stop = ptimer_stop_of(ptimer);
 
    if( ptimer_pending )
    {
@@ -205,13 +282,7 @@ void ptimer_add_to_list(ptimer_t *ptimer)
    if ( !ptimer->running )
    {
       ptlist_push_front(&ptimer_running_list,ptimer);
-
-#if defined(CONFIG_MYOS_STATISTICS)
-      if(++ptimer_list_size > myos_stats.ptlist_size_max)
-      {
-          myos_stats.ptlist_size_max = ptimer_list_size;
-      }
-#endif
+      ptimer_stats_add();
    }
 
    ptimer->running = true;
@@ -249,21 +320,533 @@ void ptimer_remove_from_list(ptimer_t *ptimer)
    {
       ptimer->running = false;
       ptlist_erase(&ptimer_running_list,ptimer);
+      ptimer_stats_remove();
+   }
+}
 
-#if defined(CONFIG_MYOS_STATISTICS)
-      ptimer_list_size--;
+
+/*!
+ * @brief      Handles expired process timers (full scan engine).
+ * @details    Iterates over the whole ptimer_running_list, fires the expired ptimers and recalculates
+ *             ptimer_next_stop from the remaining ones. The cost is linear in the number of running ptimers.
+ */
+static UTILS_HOT_FUNC void ptimer_expire(void)
+{
+   // Iterate over running ptimers, prev is the predecessor of curr for O(1) removal
+   ptlist_node_t *prev = ptlist_end(&ptimer_running_list);
+   ptimer_t *curr = (ptimer_t*)ptlist_begin(&ptimer_running_list);
+   while(curr != (ptimer_t*)ptlist_end(&ptimer_running_list))
+   {
+      ptimer_t *next = (ptimer_t*)ptlist_next(&ptimer_running_list, curr);
+
+      // Process expired ptimers
+      if(ptimer_due(curr))
+      {
+         // Remove ptimer from list
+         ptlist_erase_hint(&ptimer_running_list, prev, curr);
+         ptimer_fire(curr);
+
+         // The handler may have stopped prev, any ptimer still in the list is a valid hint
+         if(prev != ptlist_end(&ptimer_running_list) && !((ptimer_t*)prev)->running)
+         {
+            prev = ptlist_end(&ptimer_running_list);
+         }
+      }
+      else
+      {
+         // Update the next stop time
+         ptimer_next_stop_update(curr);
+         prev = (ptlist_node_t*)curr;
+      }
+
+      // Move to the next ptimer
+      curr = next;
+   }
+}
+
+#elif defined(CONFIG_MYOS_PTIMER_ENGINE_SORTED) || defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+
+#define PTIMER_TIER_WINDOW    ((timespan_t)CONFIG_MYOS_PTIMER_TIER_WINDOW)
+
+/*!
+ * @var ptimer_far_list
+ * @brief Unsorted overflow list of the ptimers which are not due before ptimer_horizon.
+ * @details ptimer_running_list is the near tier and only holds the ptimers which are due before
+ *          ptimer_horizon, sorted by their stop time. The far tier is only scanned when the
+ *          horizon is reached, i.e. once per window, so long timers neither lengthen the sorted
+ *          insert nor add any cost to the expiry passes in between.
+ */
+static ptlist_t ptimer_far_list;
+
+/*!
+ * @var ptimer_horizon
+ * @brief End of the near tier window.
+ * @details Set to the current timestamp plus CONFIG_MYOS_PTIMER_TIER_WINDOW on every migration.
+ *          The window is at most a quarter of the timestamp range, so the stop time of any ptimer
+ *          compares correctly against the horizon with timestamp_less_than() across wraparounds.
+ */
+static timestamp_t ptimer_horizon;
+
+/*!
+ * @def ptimer_unlink(ptimer)
+ * @brief Unlinks a ptimer from the tier it is in, neither list flavour needs the list head.
+ */
+#define ptimer_unlink(ptimer) ptlist_erase(NULL,ptimer)
+
+#else
+
+#define ptimer_unlink(ptimer) ptlist_erase(&ptimer_running_list,ptimer)
+
+#endif /* CONFIG_MYOS_PTIMER_ENGINE_TIERED */
+
+/*!
+ * @brief      Publishes the stop time of the head of the sorted list.
+ * @details    The head of ptimer_running_list is always the ptimer which expires next, so
+ *             ptimer_next_stop is simply taken from there. If the list is empty, there is
+ *             nothing pending for the tick handler. With the tiered engine the horizon is
+ *             published instead when it comes first and there are ptimers in the far tier.
+ */
+static void ptimer_next_stop_update(void)
+{
+   if( ptlist_empty(&ptimer_running_list) )
+   {
+      ptimer_pending = false;
+   }
+   else
+   {
+      ptimer_next_stop = ptimer_stop_of((ptimer_t*)ptlist_front(&ptimer_running_list));
+      ptimer_pending = true;
+   }
+
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+   if( !ptlist_empty(&ptimer_far_list) &&
+       (!ptimer_pending || timestamp_less_than(ptimer_horizon, ptimer_next_stop)) )
+   {
+      ptimer_next_stop = ptimer_horizon;
+      ptimer_pending = true;
+   }
 #endif
+}
+
+/*!
+ * @brief      Inserts a process timer ordered by its stop time.
+ * @details    Ptimers with equal stop times stay in the order they were armed. With the doubly-linked
+ *             list the insertion point is searched from the tail, so timers armed with increasing
+ *             deadlines (the common case for periodic timers) are appended in O(1). The singly-linked
+ *             list can only be searched from the head.
+ *
+ * @param[in]  ptimer Pointer to the process timer to insert. Must not be linked.
+ */
+static void ptimer_insert_sorted(ptimer_t *ptimer)
+{
+   timestamp_t this_stop = ptimer_stop_of(ptimer);
+   ptlist_node_t *pos;
+
+#if defined(CONFIG_MYOS_PTIMER_LIST_TYPE_DLIST)
+   pos = ptlist_back(&ptimer_running_list);
+   while( pos != ptlist_end(&ptimer_running_list) &&
+          timestamp_less_than(this_stop, ptimer_stop_of((ptimer_t*)pos)) )
+   {
+      pos = ptlist_prev(&ptimer_running_list, pos);
+   }
+#else
+   pos = ptlist_end(&ptimer_running_list);
+   while( ptlist_next(&ptimer_running_list, pos) != ptlist_end(&ptimer_running_list) &&
+          !timestamp_less_than(this_stop, ptimer_stop_of((ptimer_t*)ptlist_next(&ptimer_running_list, pos))) )
+   {
+      pos = ptlist_next(&ptimer_running_list, pos);
+   }
+#endif
+
+   ptlist_insert_after(&ptimer_running_list, pos, ptimer);
+}
+
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+
+/*!
+ * @brief      Inserts a process timer into the tier matching its stop time.
+ * @details    Ptimers due before ptimer_horizon are inserted sorted into the near tier, all
+ *             others are pushed to the far tier in O(1). When no ptimer is running the horizon
+ *             is stale, so it is moved to one window from now first.
+ *
+ * @param[in]  ptimer Pointer to the process timer to insert. Must not be linked.
+ */
+static void ptimer_insert_tier(ptimer_t *ptimer)
+{
+   if( ptlist_empty(&ptimer_running_list) && ptlist_empty(&ptimer_far_list) )
+   {
+      ptimer_horizon = timestamp_now() + PTIMER_TIER_WINDOW;
+   }
+
+   if( timestamp_less_than(ptimer_stop_of(ptimer), ptimer_horizon) )
+   {
+      ptimer_insert_sorted(ptimer);
+   }
+   else
+   {
+      ptlist_push_front(&ptimer_far_list, ptimer);
+   }
+}
+
+/*!
+ * @brief      Moves the window of the near tier forward once the horizon has been reached.
+ * @details    The new horizon is one window from now. The far tier is scanned once and every
+ *             ptimer which is due before the new horizon is moved into the near tier.
+ */
+static void ptimer_tier_migrate(void)
+{
+   timestamp_t now = timestamp_now();
+
+   if( ptlist_empty(&ptimer_far_list) || timestamp_less_than(now, ptimer_horizon) )
+   {
+      return;
+   }
+
+   ptimer_horizon = now + PTIMER_TIER_WINDOW;
+
+   ptlist_node_t *prev = ptlist_end(&ptimer_far_list);
+   ptimer_t *curr = (ptimer_t*)ptlist_begin(&ptimer_far_list);
+   while(curr != (ptimer_t*)ptlist_end(&ptimer_far_list))
+   {
+      ptimer_t *next = (ptimer_t*)ptlist_next(&ptimer_far_list, curr);
+
+      if( timestamp_less_than(ptimer_stop_of(curr), ptimer_horizon) )
+      {
+         ptlist_erase_hint(&ptimer_far_list, prev, curr);
+         ptimer_insert_sorted(curr);
+      }
+      else
+      {
+         prev = (ptlist_node_t*)curr;
+      }
+
+      curr = next;
+   }
+}
+
+#define ptimer_insert(ptimer) ptimer_insert_tier(ptimer)
+
+#else
+
+#define ptimer_insert(ptimer) ptimer_insert_sorted(ptimer)
+
+#endif /* CONFIG_MYOS_PTIMER_ENGINE_TIERED */
+
+/*!
+ * @brief      Adds a process timer to the sorted active list.
+ * @details    A ptimer which is already running is unlinked first, so restarting or resetting it moves
+ *             it to the position of its new stop time. ptimer_next_stop only changes if the ptimer ends
+ *             up at the head of the list.
+ *
+ * @param[in]  ptimer Pointer to the process timer to add to the running list.
+ */
+void ptimer_add_to_list(ptimer_t *ptimer)
+{
+   if ( ptimer->running )
+   {
+      ptimer_unlink(ptimer);
+   }
+   else
+   {
+      ptimer_stats_add();
+   }
+
+   ptimer->running = true;
+   ptimer_insert(ptimer);
+   ptimer_next_stop_update();
+}
+
+
+/*!
+ * @brief      Removes a process timer from the sorted active list.
+ * @details    Removing any ptimer but the head leaves ptimer_next_stop untouched.
+ *
+ * @param[in]  ptimer Pointer to the process timer to remove from the running list.
+ */
+void ptimer_remove_from_list(ptimer_t *ptimer)
+{
+   if( ptimer->running )
+   {
+      bool was_head = ((ptimer_t*)ptlist_front(&ptimer_running_list) == ptimer);
+
+      ptimer->running = false;
+      ptimer_unlink(ptimer);
+      ptimer_stats_remove();
+
+      if( was_head )
+      {
+         ptimer_next_stop_update();
+      }
    }
 }
 
 
+/*!
+ * @brief      Handles expired process timers (sorted list and tiered engines).
+ * @details    Pops ptimers from the head of ptimer_running_list as long as they are expired. The first
+ *             ptimer which is not expired ends the loop, the rest of the list is never touched.
+ *             The tiered engine first migrates the far tier if the horizon has been reached.
+ */
+static UTILS_HOT_FUNC void ptimer_expire(void)
+{
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+   ptimer_tier_migrate();
+#endif
+
+   while( !ptlist_empty(&ptimer_running_list) )
+   {
+      ptimer_t *head = (ptimer_t*)ptlist_front(&ptimer_running_list);
+
+      if( !ptimer_due(head) )
+      {
+         break;
+      }
+
+      ptlist_pop_front(&ptimer_running_list);
+      ptimer_fire(head);
+   }
+
+   ptimer_next_stop_update();
+}
+
+#elif defined(CONFIG_MYOS_PTIMER_ENGINE_WHEEL)
+
+#define PTIMER_WHEEL_BITS     CONFIG_MYOS_PTIMER_WHEEL_BITS
+#define PTIMER_WHEEL_LEVELS   CONFIG_MYOS_PTIMER_WHEEL_LEVELS
+#define PTIMER_WHEEL_SLOTS    (1U << PTIMER_WHEEL_BITS)
+#define PTIMER_WHEEL_MASK     (PTIMER_WHEEL_SLOTS - 1U)
+
+/*!
+ * @var ptimer_wheel
+ * @brief Slots of the hierarchical timer wheel.
+ * @details Level 0 has a resolution of one timestamp tick, level n of 2^(n*PTIMER_WHEEL_BITS) ticks.
+ *          A level 0 slot only holds ptimers which are due when ptimer_wheel_cursor reaches the slot.
+ *          The slots of the outer levels are cascaded down when the next inner level wraps around.
+ */
+static ptlist_t ptimer_wheel[PTIMER_WHEEL_LEVELS][PTIMER_WHEEL_SLOTS];
+
+/*!
+ * @var ptimer_wheel_cursor
+ * @brief The next timestamp tick the wheel has not processed yet.
+ */
+static timestamp_t ptimer_wheel_cursor;
+
+/*!
+ * @var ptimer_wheel_count
+ * @brief Number of ptimers currently linked into the wheel.
+ */
+static size_t ptimer_wheel_count;
+
+
+/*!
+ * @brief      Hashes a process timer into its wheel slot.
+ * @details    The level is chosen by the distance of the stop time to ptimer_wheel_cursor, the slot
+ *             within the level by the matching bits of the stop time. Ptimers which are already due
+ *             go to the current level 0 slot. Ptimers beyond the range of the outermost level are
+ *             parked in the last slot of that level and are re-hashed when it is cascaded.
+ *
+ * @param[in]  ptimer Pointer to the process timer to insert. Must not be linked.
+ */
+static void ptimer_wheel_insert(ptimer_t *ptimer)
+{
+   timestamp_t stop = ptimer_stop_of(ptimer);
+   uint64_t delta;
+   uint8_t level = 0;
+   uint8_t shift = 0;
+
+   if( timestamp_less_than(stop, ptimer_wheel_cursor) )
+   {
+      stop = ptimer_wheel_cursor;
+   }
+
+   delta = (uint64_t)TIMESTAMP_DIFF(stop, ptimer_wheel_cursor);
+
+   while( delta >= ((uint64_t)PTIMER_WHEEL_SLOTS << shift) )
+   {
+      if( level == PTIMER_WHEEL_LEVELS-1 )
+      {
+         stop = ptimer_wheel_cursor + (timestamp_t)((uint64_t)PTIMER_WHEEL_MASK << shift);
+         break;
+      }
+
+      level++;
+      shift += PTIMER_WHEEL_BITS;
+   }
+
+   ptlist_push_front(&ptimer_wheel[level][((uint64_t)stop >> shift) & PTIMER_WHEEL_MASK], ptimer);
+}
+
+/*!
+ * @brief      Unlinks a process timer from whatever wheel slot it is in.
+ * @details    Neither list flavour needs the list head to unlink a node (the singly-linked list walks
+ *             around the circle to find the predecessor), so the slot does not have to be known.
+ *
+ * @param[in]  ptimer Pointer to the linked process timer.
+ */
+#define ptimer_wheel_unlink(ptimer) ptlist_erase(NULL,ptimer)
+
+
+/*!
+ * @brief      Calculates the next tick ptimer_process has to be polled for.
+ * @details    That is the next non-empty level 0 slot, or the next level 0 wrap-around if all
+ *             remaining level 0 slots are empty, because outer levels may need to be cascaded then.
+ *             A cursor sitting right on a wrap-around has not been cascaded yet, so it is returned as is.
+ */
+static void ptimer_next_stop_update(void)
+{
+   timestamp_t stop = ptimer_wheel_cursor;
+
+   if( !ptimer_wheel_count )
+   {
+      ptimer_pending = false;
+      return;
+   }
+
+   while( (stop & PTIMER_WHEEL_MASK) && ptlist_empty(&ptimer_wheel[0][stop & PTIMER_WHEEL_MASK]) )
+   {
+      stop++;
+   }
+
+   ptimer_next_stop = stop;
+   ptimer_pending = true;
+}
+
+
+/*!
+ * @brief      Adds a process timer to the timer wheel.
+ * @details    A ptimer which is already running is unlinked first. When the wheel is empty the cursor
+ *             has not been advanced for a while, so it is moved to the current timestamp before hashing.
+ *
+ * @param[in]  ptimer Pointer to the process timer to add.
+ */
+void ptimer_add_to_list(ptimer_t *ptimer)
+{
+   if ( ptimer->running )
+   {
+      ptimer_wheel_unlink(ptimer);
+   }
+   else
+   {
+      if( !ptimer_wheel_count++ )
+      {
+         ptimer_wheel_cursor = timestamp_now();
+      }
+      ptimer_stats_add();
+   }
+
+   ptimer->running = true;
+   ptimer_wheel_insert(ptimer);
+
+   if( ptimer_pending && !timestamp_less_than(ptimer_stop_of(ptimer), ptimer_next_stop) )
+   {
+      return;
+   }
+
+   ptimer_next_stop_update();
+}
+
+
+/*!
+ * @brief      Removes a process timer from the timer wheel.
+ * @details    ptimer_next_stop is left alone, a poll for a slot which turned out empty is harmless.
+ *
+ * @param[in]  ptimer Pointer to the process timer to remove.
+ */
+void ptimer_remove_from_list(ptimer_t *ptimer)
+{
+   if( ptimer->running )
+   {
+      ptimer->running = false;
+      ptimer_wheel_unlink(ptimer);
+      ptimer_stats_remove();
+
+      if( !--ptimer_wheel_count )
+      {
+         ptimer_pending = false;
+      }
+   }
+}
+
+
+/*!
+ * @brief      Moves all ptimers of an outer level slot down into the inner levels.
+ *
+ * @param[in]  slot Pointer to the slot to cascade.
+ */
+static void ptimer_wheel_cascade(ptlist_t *slot)
+{
+   while( !ptlist_empty(slot) )
+   {
+      ptimer_t *ptimer = (ptimer_t*)ptlist_front(slot);
+      ptlist_pop_front(slot);
+      ptimer_wheel_insert(ptimer);
+   }
+}
+
+
+/*!
+ * @brief      Handles expired process timers (timer wheel engine).
+ * @details    Advances ptimer_wheel_cursor tick by tick up to the current timestamp. On every tick the
+ *             outer level slots which are due are cascaded down, then the level 0 slot of the tick is
+ *             drained. Only ptimers parked beyond the wheel range can show up there without being due,
+ *             those are re-hashed.
+ */
+static UTILS_HOT_FUNC void ptimer_expire(void)
+{
+   timestamp_t now = timestamp_now();
+
+   while( ptimer_wheel_count && timestamp_lessequal_than(ptimer_wheel_cursor, now) )
+   {
+      uint8_t level;
+      ptlist_t *slot;
+
+      for(level = PTIMER_WHEEL_LEVELS-1; level > 0; level--)
+      {
+         uint8_t shift = level*PTIMER_WHEEL_BITS;
+
+         if( ((uint64_t)ptimer_wheel_cursor & (((uint64_t)1 << shift)-1)) == 0 )
+         {
+            ptimer_wheel_cascade(&ptimer_wheel[level][((uint64_t)ptimer_wheel_cursor >> shift) & PTIMER_WHEEL_MASK]);
+         }
+      }
+
+      slot = &ptimer_wheel[0][ptimer_wheel_cursor & PTIMER_WHEEL_MASK];
+
+      while( !ptlist_empty(slot) )
+      {
+         ptimer_t *ptimer = (ptimer_t*)ptlist_front(slot);
+         ptlist_pop_front(slot);
+
+         if( !timestamp_lessequal_than(ptimer_stop_of(ptimer), ptimer_wheel_cursor) )
+         {
+            ptimer_wheel_insert(ptimer);
+            continue;
+         }
+
+         ptimer_wheel_count--;
+         ptimer_fire(ptimer);
+      }
+
+      ptimer_wheel_cursor++;
+   }
+
+   ptimer_next_stop_update();
+}
+
+#else
+#error "No ptimer engine defined."
+#endif
+
+
 /*!
  * @brief Process for handling process timers in MyOS.
  * @details This process manages the lifecycle of process timers (ptimers). It initializes the ptimer
- *          running list and continuously waits for PROCESS_EVENT_POLL events. Upon receiving an event,
- *          it iterates over the list of running ptimers, handles expired timers by calling their respective
- *          handlers, and updates the next stop time for active ptimers. This process is a core component
- *          of the MyOS timer system, ensuring timely and efficient execution of timer-based tasks.
+ *          engine and continuously waits for PROCESS_EVENT_POLL events. Upon receiving an event,
+ *          it lets the engine selected by CONFIG_MYOS_PTIMER_ENGINE handle the expired timers by calling
+ *          their respective handlers, and update the next stop time for active ptimers. This process is a core
+ *          component of the MyOS timer system, ensuring timely and efficient execution of timer-based tasks.
  *
  * Usage Example:
  * @code
@@ -274,9 +857,6 @@ void ptimer_remove_from_list(ptimer_t *ptimer)
 PROCESS(ptimer_process, ptimer_process);
 PROCESS_THREAD(ptimer_process)
 {
-
-
-
    // Initialization of the process
    PROCESS_BEGIN();
 
@@ -287,11 +867,25 @@ PROCESS_THREAD(ptimer_process)
 #endif
 
    DBG("ptimer_process: started\n");
-   
+
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_WHEEL)
+   DBG("ptimer_process: Using %d level timer wheel with %d slots per level.\n",PTIMER_WHEEL_LEVELS,PTIMER_WHEEL_SLOTS);
+
+   for(uint8_t level = 0; level < PTIMER_WHEEL_LEVELS; level++)
+   {
+      for(uint16_t slot = 0; slot < PTIMER_WHEEL_SLOTS; slot++)
+      {
+         ptlist_init(&ptimer_wheel[level][slot]);
+      }
+   }
+#else
    // Initialize the list of running ptimers
    ptlist_init(&ptimer_running_list);
+#endif
+#if defined(CONFIG_MYOS_PTIMER_ENGINE_TIERED)
+   ptlist_init(&ptimer_far_list);
+#endif
 
-DBG("%p, %p\n",&ptimer_running_list, ptimer_running_list.next);
    // Process loop
    while(1)
    {
@@ -301,38 +895,9 @@ DBG("%p, %p\n",&ptimer_running_list, ptimer_running_list.next);
 
       ptimer_pending = false;
 
-      // Iterate over running ptimers
-      ptimer_t *curr = (ptimer_t*)ptlist_begin(&ptimer_running_list);
-      while(curr != (ptimer_t*)ptlist_end(&ptimer_running_list))
-      {
-         ptimer_t *next = (ptimer_t*)ptlist_next(&ptimer_running_list, curr);
-         
-         // Process expired ptimers
-         if(ptimer_expired(curr))
-         {
-
-            // Remove ptimer from list
-            ptlist_erase(&ptimer_running_list, curr);
-            curr->running = false;
-#if defined(CONFIG_MYOS_STATISTICS)
-            ptimer_list_size--;
-#endif
-
-            // Call the handler if it exists
-            if(curr->handler)
-            {
-               curr->handler((void*)(curr));
-            }
-         }
-         else
-         {
-            // Update the next stop time
-            ptimer_next_stop_update(curr);
-         }
-
-         // Move to the next ptimer
-         curr = next;
-      }
+      ptimer_sweep++;
+      ptimer_expire();
+      timestamp_alarm_update();
    }
 
    // End of the process
@@ -341,10 +906,18 @@ DBG("%p, %p\n",&ptimer_running_list, ptimer_running_list.next);
 
 
 void ptimer_start(ptimer_t* ptimer, timespan_t span, ptimer_handler_t handler)
+{
+   ptimer_start_slack(ptimer, span, 0, handler);
+}
+
+
+void ptimer_start_slack(ptimer_t* ptimer, timespan_t span, timespan_t slack, ptimer_handler_t handler)
 {
    ptimer->handler = handler;
+   ptimer->slack = slack;
    timer_start(&ptimer->timer,span);
    ptimer_add_to_list(ptimer);
+   timestamp_alarm_update();
 }
 
 
@@ -352,6 +925,7 @@ void ptimer_restart(ptimer_t* ptimer)
 {
    timer_restart(&ptimer->timer);
    ptimer_add_to_list(ptimer);
+   timestamp_alarm_update();
 }
 
 
@@ -359,9 +933,50 @@ void ptimer_reset(ptimer_t* ptimer)
 {
    timer_reset(&ptimer->timer);
    ptimer_add_to_list(ptimer);
+   timestamp_alarm_update();
+}
+
+
+#if defined(CONFIG_MYOS_TIMESTAMP_NOW64)
+
+/*!
+ * @brief      Arms the next segment of a long process timer.
+ * @details    Calls the handler once the 64-bit stop time is reached, otherwise re-arms the embedded
+ *             ptimer for the rest of the span, limited to TIMESTAMP_QUARTER_RANGE.
+ *
+ * @param[in]  ptimer Pointer to the embedded ptimer of the long process timer.
+ */
+static void ptimer_long_segment(ptimer_t *ptimer)
+{
+   ptimer_long_t *lptimer = (ptimer_long_t*)ptimer;
+   timestamp64_t now = timestamp_now64();
+
+   if( now >= lptimer->stop )
+   {
+      if( lptimer->handler )
+      {
+         lptimer->handler(ptimer);
+      }
+      return;
+   }
+
+   timestamp64_t left = lptimer->stop - now;
+
+   ptimer_start(ptimer, left < TIMESTAMP_QUARTER_RANGE ? (timespan_t)left : TIMESTAMP_QUARTER_RANGE, ptimer_long_segment);
 }
 
 
+void ptimer_long_start(ptimer_long_t *lptimer, timestamp64_t span, ptimer_handler_t handler)
+{
+   lptimer->handler = handler;
+   lptimer->stop = timestamp_now64() + span;
+
+   ptimer_start(&lptimer->ptimer, span < TIMESTAMP_QUARTER_RANGE ? (timespan_t)span : TIMESTAMP_QUARTER_RANGE, ptimer_long_segment);
+}
+
+#endif /* CONFIG_MYOS_TIMESTAMP_NOW64 */
+
+
 
 
 
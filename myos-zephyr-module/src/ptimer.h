@@ -57,12 +57,16 @@ typedef slist_node_t ptlist_node_t;
 #define PTLIST_NODE_TYPE                              SLIST_NODE_TYPE
 #define ptlist_init(listptr)                          slist_init(listptr)
 #define ptlist_erase(listptr,nodeptr)                 slist_erase(listptr,nodeptr)
+#define ptlist_erase_hint(listptr,hintptr,nodeptr)    slist_erase_hint(listptr,hintptr,nodeptr)
 #define ptlist_next(listptr,nodeptr)                  slist_next(listptr,nodeptr)
 #define ptlist_push_front(listptr,nodeptr)            slist_push_front(listptr,nodeptr)
 #define ptlist_prev(listptr,nodeptr)                  slist_prev(listptr,nodeptr)
 #define ptlist_foreach(listptr,iterator)              slist_foreach(listptr,iterator)
-#define ptlist_find(listptr,nodeptr)                  slist_findlistptr,nodeptr)
+#define ptlist_find(listptr,nodeptr)                  slist_find(listptr,nodeptr)
 #define ptlist_begin(listptr)                         slist_begin(listptr)
+#define ptlist_front(listptr)                         slist_front(listptr)
+#define ptlist_pop_front(listptr)                     slist_pop_front(listptr)
+#define ptlist_insert_after(listptr,posptr,nodeptr)   slist_insert_after(listptr,posptr,nodeptr)
 #define ptlist_end(listptr)                           slist_end(listptr)
 #define ptlist_empty(listptr)                         slist_empty(listptr)
 #define ptlist_foreach(listptr,iterator)              slist_foreach(listptr,iterator)
@@ -74,12 +78,17 @@ typedef dlist_node_t ptlist_node_t;
 #define PTLIST_NODE_TYPE                              DLIST_NODE_TYPE
 #define ptlist_init(listptr)                          dlist_init(listptr)
 #define ptlist_erase(listptr,nodeptr)                 dlist_erase(listptr,nodeptr)
+#define ptlist_erase_hint(listptr,hintptr,nodeptr)    dlist_erase(listptr,nodeptr)
 #define ptlist_next(listptr,nodeptr)                  dlist_next(listptr,nodeptr)
 #define ptlist_push_front(listptr,nodeptr)            dlist_push_front(listptr,nodeptr)
 #define ptlist_prev(listptr,nodeptr)                  dlist_prev(listptr,nodeptr)
 #define ptlist_foreach(listptr,iterator)              dlist_foreach(listptr,iterator)
-#define ptlist_find(listptr,nodeptr)                  dlist_findlistptr,nodeptr)
+#define ptlist_find(listptr,nodeptr)                  dlist_find(listptr,nodeptr)
 #define ptlist_begin(listptr)                         dlist_begin(listptr)
+#define ptlist_front(listptr)                         dlist_front(listptr)
+#define ptlist_back(listptr)                          dlist_back(listptr)
+#define ptlist_pop_front(listptr)                     dlist_pop_front(listptr)
+#define ptlist_insert_after(listptr,posptr,nodeptr)   dlist_insert_after(listptr,(ptlist_node_t*)(posptr),(ptlist_node_t*)(nodeptr))
 #define ptlist_end(listptr)                           dlist_end(listptr)
 #define ptlist_empty(listptr)                         dlist_empty(listptr)
 #else
@@ -89,6 +98,7 @@ typedef dlist_node_t ptlist_node_t;
 
 extern timestamp_t ptimer_next_stop;
 extern bool ptimer_pending;
+extern uint8_t ptimer_sweep;
 PROCESS_EXTERN(ptimer_process);
 
 
@@ -123,6 +133,8 @@ typedef void (*ptimer_handler_t) (ptimer_t *data);
  *      Callback function to be executed when the timer expires.
  * @var ptimer_t::running
  *      Indicates whether the timer is currently active.
+ * @var ptimer_t::slack
+ *      Time by which the expiry may be delayed to coalesce it with other timers, see ptimer_start_slack().
  *
  * Usage Example:
  * @code
@@ -138,6 +150,7 @@ struct ptimer_t{
    timer_t timer;
    ptimer_handler_t handler;
    bool running;
+   timespan_t slack;
 };
 
 /*!
@@ -189,6 +202,30 @@ void ptimer_processing(void);
  */
 void ptimer_start(ptimer_t* ptimer, timespan_t span, ptimer_handler_t handler);
 
+/*!
+ * @brief Starts a process timer whose expiry may be delayed by up to a given slack.
+ * @details Works like ptimer_start(), but the ptimer engine may fire the timer anywhere from its stop time
+ *          up to stop + slack. The expiry is aligned down to a multiple of the largest power of two not above
+ *          the slack, counted from stop + slack. Timers with similar slacks therefore expire on the same ticks
+ *          and are handled in one ptimer_process pass, which saves ISR polls and scheduler passes, especially
+ *          in tickless mode. The slack is kept by ptimer_restart() and ptimer_reset(), ptimer_reset() still
+ *          advances from the unaligned stop time, so periodic timers do not drift. The slack must be less
+ *          than half the timestamp range.
+ *
+ *          ptimer_expired() still reports the unaligned stop time.
+ * @param[in] ptimer Pointer to the process timer to start.
+ * @param[in] span Duration for the timer.
+ * @param[in] slack Allowed delay of the expiry.
+ * @param[in] handler Function to be called when the timer expires.
+ *
+ * Usage Example:
+ * @code
+ *     ptimer_t housekeeping;
+ *     ptimer_start_slack(&housekeeping, 1000, 100, my_ptimer_handler); // Fires between 1000 and 1100 units
+ * @endcode
+ */
+void ptimer_start_slack(ptimer_t* ptimer, timespan_t span, timespan_t slack, ptimer_handler_t handler);
+
 /*!
  * @brief Restarts a process timer.
  * @details This function is used to restart a process timer in MyOS. It resets the timer's start time to the current
@@ -224,6 +261,23 @@ void ptimer_restart(ptimer_t* ptimer);
  */
 void ptimer_reset(ptimer_t* ptimer);
 
+/*!
+ * @brief Arms a process timer in the engine selected by CONFIG_MYOS_PTIMER_ENGINE.
+ * @details Called by ptimer_start(), ptimer_restart() and ptimer_reset() after the underlying
+ *          timer has been updated. A timer which is already running is re-queued according to
+ *          its new stop time.
+ * @param[in] ptimer Pointer to the process timer to arm.
+ */
+void ptimer_add_to_list(ptimer_t *ptimer);
+
+/*!
+ * @brief Disarms a process timer.
+ * @details Removes the process timer from the engine selected by CONFIG_MYOS_PTIMER_ENGINE.
+ *          Calling it for a timer which is not running has no effect.
+ * @param[in] ptimer Pointer to the process timer to disarm.
+ */
+void ptimer_remove_from_list(ptimer_t *ptimer);
+
 /*!
  * @def ptimer_stop(ptimerptr)
  * @brief Stops a process timer.
@@ -259,5 +313,56 @@ void ptimer_reset(ptimer_t* ptimer);
  */
 #define ptimer_expired(ptimerptr)   timer_expired(&(ptimerptr)->timer)
 
+#if defined(CONFIG_MYOS_TIMESTAMP_NOW64)
+
+/*!
+ * @struct ptimer_long_t
+ * @brief Process timer for spans beyond the range of timestamp_t.
+ * @details A coarse layer on top of the ptimer engine: the stop time is kept as a timestamp64_t and
+ *          the embedded ptimer is re-armed in segments of at most TIMESTAMP_QUARTER_RANGE until it is
+ *          reached. The engine only ever sees short spans, so short timers do not pay for long ones
+ *          and the 16-bit wraparound of timestamp_less_than() is never exceeded.
+ *
+ * @var ptimer_long_t::ptimer
+ *      The embedded ptimer, passed to the handler. Must be the first member.
+ * @var ptimer_long_t::stop
+ *      Stop time on the timestamp_now64() scale.
+ * @var ptimer_long_t::handler
+ *      Callback function to be executed when the timer expires.
+ *
+ * Usage Example:
+ * @code
+ *     static ptimer_long_t maintenance;
+ *     ptimer_long_start(&maintenance, 3600ULL * TIMESTAMP_TICKS_PER_SEC, maintenance_handler); // one hour
+ * @endcode
+ */
+typedef struct {
+   ptimer_t ptimer;
+   timestamp64_t stop;
+   ptimer_handler_t handler;
+}ptimer_long_t;
+
+/*!
+ * @brief Starts a long process timer.
+ * @param[in] lptimer Pointer to the long process timer to start.
+ * @param[in] span Duration for the timer.
+ * @param[in] handler Function called with &lptimer->ptimer when the timer expires.
+ */
+void ptimer_long_start(ptimer_long_t *lptimer, timestamp64_t span, ptimer_handler_t handler);
+
+/*!
+ * @def ptimer_long_stop(lptimerptr)
+ * @brief Stops a long process timer.
+ */
+#define ptimer_long_stop(lptimerptr) ptimer_stop(&(lptimerptr)->ptimer)
+
+/*!
+ * @def ptimer_long_expired(lptimerptr)
+ * @brief Checks if a long process timer has expired.
+ */
+#define ptimer_long_expired(lptimerptr) (timestamp_now64() >= (lptimerptr)->stop)
+
+#endif /* CONFIG_MYOS_TIMESTAMP_NOW64 */
+
 
 #endif /* PTIMER_H_ */
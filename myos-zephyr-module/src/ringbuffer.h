@@ -72,6 +72,8 @@
 #ifndef RINGBUFFER_H_
 #define RINGBUFFER_H_
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 
 /**
@@ -111,6 +113,59 @@
     } name##_ringbuffer_t
 
 
+/**
+ * @brief Declares a ringbuffer type with a power-of-two size.
+ * @details This macro works like `RINGBUFFER_TYPEDEF`, but the ringbuffer holds 2^bits items
+ *          and the 'head', 'tail' and 'count' fields use the smallest unsigned integer type
+ *          which can hold the value 2^bits (see `RINGBUFFER_POW2_INDEX_T`). For up to 128
+ *          items the bookkeeping takes 3 bytes instead of three `size_t`.
+ *
+ *          All other ringbuffer macros can be used unchanged. `RINGBUFFER_PUSH` and
+ *          `RINGBUFFER_POP` detect the power-of-two size at compile time and wrap the
+ *          indices with a mask instead of a compare and branch.
+ *
+ * Usage Example:
+ * @code
+ * RINGBUFFER_TYPEDEF_POW2(intRingBuffer, int, 4);  // Creates a ringbuffer type for 16 integers
+ * RINGBUFFER_T(intRingBuffer) myRingBuffer;
+ * RINGBUFFER_INIT(myRingBuffer);
+ * @endcode
+ *
+ * @param name The unique identification name for the ringbuffer type. The actual type will be `name##_ringbuffer_t`.
+ * @param type The data type of the items that the ringbuffer will hold.
+ * @param bits Base 2 logarithm of the number of items, a decimal literal from 1 to 15.
+ */
+#define RINGBUFFER_TYPEDEF_POW2(name,type,bits)     \
+    typedef struct {                                \
+        RINGBUFFER_POW2_INDEX_T(bits) head;         \
+        RINGBUFFER_POW2_INDEX_T(bits) tail;         \
+        RINGBUFFER_POW2_INDEX_T(bits) count;        \
+        type items [1u << (bits)];                  \
+    } name##_ringbuffer_t
+
+/**
+ * @brief Smallest unsigned integer type which holds the value 2^bits.
+ * @param bits Base 2 logarithm of the ringbuffer size, a decimal literal from 1 to 15.
+ */
+#define RINGBUFFER_POW2_INDEX_T(bits)           RINGBUFFER_POW2_INDEX_T_EXPAND(bits)
+#define RINGBUFFER_POW2_INDEX_T_EXPAND(bits)    RINGBUFFER_POW2_INDEX_T_##bits
+#define RINGBUFFER_POW2_INDEX_T_1               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_2               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_3               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_4               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_5               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_6               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_7               uint8_t
+#define RINGBUFFER_POW2_INDEX_T_8               uint16_t
+#define RINGBUFFER_POW2_INDEX_T_9               uint16_t
+#define RINGBUFFER_POW2_INDEX_T_10              uint16_t
+#define RINGBUFFER_POW2_INDEX_T_11              uint16_t
+#define RINGBUFFER_POW2_INDEX_T_12              uint16_t
+#define RINGBUFFER_POW2_INDEX_T_13              uint16_t
+#define RINGBUFFER_POW2_INDEX_T_14              uint16_t
+#define RINGBUFFER_POW2_INDEX_T_15              uint16_t
+
+
 /**
  * @brief Defines a ringbuffer variable of a specified type.
  * @details This macro is used to define a ringbuffer variable of the type created by
@@ -243,6 +298,17 @@
 #define RINGBUFFER_SIZE(ringbuffer) \
     (RINGBUFFER_SIZEOF(ringbuffer)/sizeof(RINGBUFFER_ITEMS(ringbuffer)[0]))
 
+/**
+ * @brief Checks whether the capacity of the ringbuffer is a power of two.
+ * @details The result is a compile time constant, so the branches depending on it
+ *          are removed by the compiler.
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @return Nonzero if `RINGBUFFER_SIZE(ringbuffer)` is a power of two.
+ */
+#define RINGBUFFER_IS_POW2(ringbuffer) \
+    ((RINGBUFFER_SIZE(ringbuffer) & (RINGBUFFER_SIZE(ringbuffer) - 1)) == 0)
+
 
 
 
@@ -511,7 +577,12 @@
  */
 #define RINGBUFFER_PUSH(ringbuffer)                                         \
     do {                                                                    \
-        if(++RINGBUFFER_TAIL(ringbuffer) == RINGBUFFER_SIZE(ringbuffer))    \
+        if(RINGBUFFER_IS_POW2(ringbuffer))                                  \
+        {                                                                   \
+             RINGBUFFER_TAIL(ringbuffer) = (RINGBUFFER_TAIL(ringbuffer) + 1) \
+                                         & (RINGBUFFER_SIZE(ringbuffer) - 1);\
+        }                                                                   \
+        else if(++RINGBUFFER_TAIL(ringbuffer) == RINGBUFFER_SIZE(ringbuffer)) \
         {                                                                   \
              RINGBUFFER_TAIL(ringbuffer) = 0;                               \
         }                                                                   \
@@ -553,7 +624,12 @@
  */
 #define RINGBUFFER_POP(ringbuffer)                                          \
     do {                                                                    \
-        if(++RINGBUFFER_HEAD(ringbuffer) == RINGBUFFER_SIZE(ringbuffer))    \
+        if(RINGBUFFER_IS_POW2(ringbuffer))                                  \
+        {                                                                   \
+             RINGBUFFER_HEAD(ringbuffer) = (RINGBUFFER_HEAD(ringbuffer) + 1) \
+                                         & (RINGBUFFER_SIZE(ringbuffer) - 1);\
+        }                                                                   \
+        else if(++RINGBUFFER_HEAD(ringbuffer) == RINGBUFFER_SIZE(ringbuffer)) \
         {                                                                   \
              RINGBUFFER_HEAD(ringbuffer) = 0;                               \
         }                                                                   \
@@ -707,4 +783,303 @@
     }while(0)
 
 
+/**
+ * @brief Returns the number of free slots in the ringbuffer.
+ * @param ringbuffer The ringbuffer instance.
+ * @return `RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_COUNT(ringbuffer)`.
+ */
+#define RINGBUFFER_FREE(ringbuffer) \
+    (RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_COUNT(ringbuffer))
+
+/**
+ * @brief Advances a ringbuffer index by a number of items.
+ * @details Helper for the bulk operations. The number of items must not exceed the
+ *          size of the ringbuffer. The wrap is done with a mask for power-of-two sizes,
+ *          otherwise with a compare and subtract.
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @param index The index to advance, `RINGBUFFER_HEAD(ringbuffer)` or `RINGBUFFER_TAIL(ringbuffer)`.
+ * @param n Number of items to advance the index by.
+ */
+#define RINGBUFFER_INDEX_ADVANCE(ringbuffer,index,n)                        \
+    do {                                                                    \
+        size_t __rb_index__ = (size_t)(index) + (size_t)(n);                \
+        if(RINGBUFFER_IS_POW2(ringbuffer))                                  \
+        {                                                                   \
+            __rb_index__ &= RINGBUFFER_SIZE(ringbuffer) - 1;                \
+        }                                                                   \
+        else if(__rb_index__ >= RINGBUFFER_SIZE(ringbuffer))                \
+        {                                                                   \
+            __rb_index__ -= RINGBUFFER_SIZE(ringbuffer);                    \
+        }                                                                   \
+        (index) = __rb_index__;                                             \
+    }while(0)
+
+/**
+ * @brief Returns the number of free slots which are contiguous from the tail on.
+ * @details These slots can be filled in place, e.g. by a DMA engine or a driver
+ *          receive function, starting at `RINGBUFFER_TAIL_PTR(ringbuffer)`. Once
+ *          filled, the items are added with `RINGBUFFER_COMMIT`. If the free space
+ *          wraps around the end of the items array, the span ends at the end of the
+ *          array and a second span starts at index 0 after the commit.
+ *
+ * Usage Example:
+ * @code
+ * size_t span = RINGBUFFER_CONTIG_TAIL_SPAN(rxbuffer);
+ * size_t received = uart_read(RINGBUFFER_TAIL_PTR(rxbuffer), span);
+ * RINGBUFFER_COMMIT(rxbuffer, received);
+ * @endcode
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @return The number of contiguous free slots at the tail position.
+ */
+#define RINGBUFFER_CONTIG_TAIL_SPAN(ringbuffer)                                         \
+    ((size_t)(RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_TAIL(ringbuffer)) < RINGBUFFER_FREE(ringbuffer) \
+        ? (size_t)(RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_TAIL(ringbuffer))           \
+        : (size_t)RINGBUFFER_FREE(ringbuffer))
+
+/**
+ * @brief Adds items which were written in place at the tail position.
+ * @param ringbuffer The ringbuffer instance.
+ * @param n Number of items written, at most `RINGBUFFER_CONTIG_TAIL_SPAN(ringbuffer)`.
+ */
+#define RINGBUFFER_COMMIT(ringbuffer,n)                                     \
+    do {                                                                    \
+        RINGBUFFER_INDEX_ADVANCE(ringbuffer,RINGBUFFER_TAIL(ringbuffer),n); \
+        RINGBUFFER_COUNT(ringbuffer) += (n);                                \
+    }while(0)
+
+/**
+ * @brief Returns the number of items which are contiguous from the head on.
+ * @details These items can be processed in place, e.g. handed to a DMA engine for
+ *          transmission, starting at `RINGBUFFER_HEAD_PTR(ringbuffer)`. Once they are
+ *          not needed anymore, they are removed with `RINGBUFFER_CONSUME`.
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @return The number of contiguous items at the head position.
+ */
+#define RINGBUFFER_CONTIG_HEAD_SPAN(ringbuffer)                                         \
+    ((size_t)(RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_HEAD(ringbuffer)) < (size_t)RINGBUFFER_COUNT(ringbuffer) \
+        ? (size_t)(RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_HEAD(ringbuffer))           \
+        : (size_t)RINGBUFFER_COUNT(ringbuffer))
+
+/**
+ * @brief Removes items which were processed in place at the head position.
+ * @param ringbuffer The ringbuffer instance.
+ * @param n Number of items to remove, at most `RINGBUFFER_COUNT(ringbuffer)`.
+ */
+#define RINGBUFFER_CONSUME(ringbuffer,n)                                    \
+    do {                                                                    \
+        RINGBUFFER_INDEX_ADVANCE(ringbuffer,RINGBUFFER_HEAD(ringbuffer),n); \
+        RINGBUFFER_COUNT(ringbuffer) -= (n);                                \
+    }while(0)
+
+/**
+ * @brief Writes a number of items to the ringbuffer.
+ * @details Copies the items with at most two `memcpy`, one up to the end of the items
+ *          array and one for the part which wraps to the beginning. The caller has to
+ *          ensure that at least `n` slots are free, see `RINGBUFFER_FREE`.
+ *
+ * Usage Example:
+ * @code
+ * if (RINGBUFFER_FREE(txbuffer) >= len) {
+ *     RINGBUFFER_WRITE_N(txbuffer, message, len);
+ * }
+ * @endcode
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @param src Pointer to the items to be written.
+ * @param n Number of items to be written.
+ */
+#define RINGBUFFER_WRITE_N(ringbuffer,src,n)                                            \
+    do {                                                                                \
+        size_t __rb_n__ = (n);                                                          \
+        size_t __rb_first__ = RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_TAIL(ringbuffer); \
+        if(__rb_first__ > __rb_n__)                                                     \
+        {                                                                               \
+            __rb_first__ = __rb_n__;                                                    \
+        }                                                                               \
+        memcpy(RINGBUFFER_TAIL_PTR(ringbuffer), (src),                                  \
+               __rb_first__ * sizeof(RINGBUFFER_ITEMS(ringbuffer)[0]));                 \
+        memcpy(RINGBUFFER_ITEMS(ringbuffer), (src) + __rb_first__,                      \
+               (__rb_n__ - __rb_first__) * sizeof(RINGBUFFER_ITEMS(ringbuffer)[0]));    \
+        RINGBUFFER_COMMIT(ringbuffer,__rb_n__);                                         \
+    }while(0)
+
+/**
+ * @brief Reads and removes a number of items from the ringbuffer.
+ * @details Copies the items with at most two `memcpy`, see `RINGBUFFER_WRITE_N`. The
+ *          caller has to ensure that at least `n` items are stored, see `RINGBUFFER_COUNT`.
+ *
+ * @param ringbuffer The ringbuffer instance.
+ * @param dst Pointer to the destination for the items.
+ * @param n Number of items to be read.
+ */
+#define RINGBUFFER_READ_N(ringbuffer,dst,n)                                             \
+    do {                                                                                \
+        size_t __rb_n__ = (n);                                                          \
+        size_t __rb_first__ = RINGBUFFER_SIZE(ringbuffer) - RINGBUFFER_HEAD(ringbuffer); \
+        if(__rb_first__ > __rb_n__)                                                     \
+        {                                                                               \
+            __rb_first__ = __rb_n__;                                                    \
+        }                                                                               \
+        memcpy((dst), RINGBUFFER_HEAD_PTR(ringbuffer),                                  \
+               __rb_first__ * sizeof(RINGBUFFER_ITEMS(ringbuffer)[0]));                 \
+        memcpy((dst) + __rb_first__, RINGBUFFER_ITEMS(ringbuffer),                      \
+               (__rb_n__ - __rb_first__) * sizeof(RINGBUFFER_ITEMS(ringbuffer)[0]));    \
+        RINGBUFFER_CONSUME(ringbuffer,__rb_n__);                                        \
+    }while(0)
+
+
+/**
+ * @brief Declares a lock-free single-producer/single-consumer ringbuffer type.
+ * @details This macro defines a ringbuffer type which can be shared between exactly one
+ *          producer and one consumer without any locking, e.g. an ISR posting items and
+ *          the main loop taking them. In contrast to `RINGBUFFER_TYPEDEF` there is no
+ *          shared 'count' field. The 'head' index is only written by the consumer and the
+ *          'tail' index only by the producer, so no read-modify-write of shared data is
+ *          needed on either side.
+ *
+ *          Both indices are free-running, they are never wrapped but incremented and
+ *          masked when accessing the items array. The number of items is the difference
+ *          `tail - head`, which stays correct when the indices overflow, because the size
+ *          is required to be a power of two. This is checked at compile time.
+ *
+ *          The index updates are published with release and read with acquire semantics,
+ *          so an item is completely written before the consumer sees it and completely
+ *          read before the producer can overwrite it.
+ *
+ *          Only the `RINGBUFFER_SPSC_*` macros may be used for the modifying operations
+ *          on such a ringbuffer, `RINGBUFFER_T`, `RINGBUFFER_ITEMS` and `RINGBUFFER_SIZE`
+ *          work for both flavors.
+ *
+ * Usage Example:
+ * @code
+ * RINGBUFFER_SPSC_TYPEDEF(isrQueue, int, 16);  // Creates a SPSC ringbuffer type for 16 integers
+ * static RINGBUFFER_T(isrQueue) queue;           // Declares a ringbuffer variable of the type
+ * RINGBUFFER_SPSC_INIT(queue);                   // Initializes the ringbuffer
+ *
+ * // Producer, e.g. in an ISR
+ * if (!RINGBUFFER_SPSC_FULL(queue)) {
+ *     *RINGBUFFER_SPSC_TAIL_PTR(queue) = value;
+ *     RINGBUFFER_SPSC_PUSH(queue);
+ * }
+ *
+ * // Consumer, e.g. in the main loop
+ * while (!RINGBUFFER_SPSC_EMPTY(queue)) {
+ *     handle(*RINGBUFFER_SPSC_HEAD_PTR(queue));
+ *     RINGBUFFER_SPSC_POP(queue);
+ * }
+ * @endcode
+ *
+ * @param name The unique identification name for the ringbuffer type. The actual type will be `name##_ringbuffer_t`.
+ * @param type The data type of the items that the ringbuffer will hold.
+ * @param size The number of items of \a type that the ringbuffer can hold, must be a power of two.
+ */
+#define RINGBUFFER_SPSC_TYPEDEF(name,type,size)                             \
+    typedef struct {                                                        \
+        size_t head;                                                        \
+        size_t tail;                                                        \
+        type items [size];                                                  \
+        _Static_assert((size) > 0 && ((size) & ((size) - 1)) == 0,          \
+                       "SPSC ringbuffer size must be a power of two");      \
+    } name##_ringbuffer_t
+
+/**
+ * @brief Returns the index mask of a SPSC ringbuffer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return `RINGBUFFER_SIZE(ringbuffer) - 1`.
+ */
+#define RINGBUFFER_SPSC_MASK(ringbuffer) \
+    (RINGBUFFER_SIZE(ringbuffer) - 1)
+
+/**
+ * @brief Initializes a SPSC ringbuffer.
+ * @details Must be called before producer and consumer start using the ringbuffer.
+ * @param ringbuffer The SPSC ringbuffer instance to be initialized.
+ */
+#define RINGBUFFER_SPSC_INIT(ringbuffer)    \
+    do{                                     \
+        (ringbuffer).head = 0;              \
+        (ringbuffer).tail = 0;              \
+    }while(0)
+
+/**
+ * @brief Returns the current number of items in a SPSC ringbuffer.
+ * @details The value is a snapshot. It may grow meanwhile if called by the consumer
+ *          and shrink meanwhile if called by the producer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return The number of items currently stored in the ringbuffer.
+ */
+#define RINGBUFFER_SPSC_COUNT(ringbuffer)                               \
+    ((size_t)(__atomic_load_n(&(ringbuffer).tail, __ATOMIC_ACQUIRE) -   \
+              __atomic_load_n(&(ringbuffer).head, __ATOMIC_ACQUIRE)))
+
+/**
+ * @brief Checks whether a SPSC ringbuffer is full, to be used by the producer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return Nonzero if no item can be pushed.
+ */
+#define RINGBUFFER_SPSC_FULL(ringbuffer) \
+    (RINGBUFFER_SPSC_COUNT(ringbuffer) >= RINGBUFFER_SIZE(ringbuffer))
+
+/**
+ * @brief Checks whether a SPSC ringbuffer is empty, to be used by the consumer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return Nonzero if no item can be popped.
+ */
+#define RINGBUFFER_SPSC_EMPTY(ringbuffer) \
+    (!RINGBUFFER_SPSC_COUNT(ringbuffer))
+
+/**
+ * @brief Returns a pointer to the slot the producer writes next.
+ * @details The slot must only be written if the ringbuffer is not full. The item
+ *          becomes visible to the consumer with `RINGBUFFER_SPSC_PUSH`.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return A pointer to the item at the tail position.
+ */
+#define RINGBUFFER_SPSC_TAIL_PTR(ringbuffer) \
+    (&RINGBUFFER_ITEMS(ringbuffer)[(ringbuffer).tail & RINGBUFFER_SPSC_MASK(ringbuffer)])
+
+/**
+ * @brief Returns a pointer to the oldest item, to be used by the consumer.
+ * @details The ringbuffer must not be empty. The slot stays valid until `RINGBUFFER_SPSC_POP`.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @return A pointer to the item at the head position.
+ */
+#define RINGBUFFER_SPSC_HEAD_PTR(ringbuffer) \
+    (&RINGBUFFER_ITEMS(ringbuffer)[(ringbuffer).head & RINGBUFFER_SPSC_MASK(ringbuffer)])
+
+/**
+ * @brief Publishes the item written at the tail position, to be used by the producer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ */
+#define RINGBUFFER_SPSC_PUSH(ringbuffer) \
+    __atomic_store_n(&(ringbuffer).tail, (ringbuffer).tail + 1, __ATOMIC_RELEASE)
+
+/**
+ * @brief Releases the item at the head position, to be used by the consumer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ */
+#define RINGBUFFER_SPSC_POP(ringbuffer) \
+    __atomic_store_n(&(ringbuffer).head, (ringbuffer).head + 1, __ATOMIC_RELEASE)
+
+/**
+ * @brief Publishes `n` items written from the tail position on, to be used by the producer.
+ * @details The items wrap around at the end of the items array, and there must be room for them.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @param n Number of items.
+ */
+#define RINGBUFFER_SPSC_PUSH_N(ringbuffer,n) \
+    __atomic_store_n(&(ringbuffer).tail, (ringbuffer).tail + (n), __ATOMIC_RELEASE)
+
+/**
+ * @brief Releases `n` items from the head position on, to be used by the consumer.
+ * @param ringbuffer The SPSC ringbuffer instance.
+ * @param n Number of items, at most `RINGBUFFER_SPSC_COUNT`.
+ */
+#define RINGBUFFER_SPSC_POP_N(ringbuffer,n) \
+    __atomic_store_n(&(ringbuffer).head, (ringbuffer).head + (n), __ATOMIC_RELEASE)
+
+
 #endif /* RINGBUFFER_H_ */
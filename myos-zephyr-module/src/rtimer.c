@@ -32,22 +32,55 @@
 
 
 #include "rtimer.h"
+#include "process.h"
+#include "utils.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include "mutex.h"
+#include "critical.h"
+#include "trace.h"
+#include <zephyr/kernel.h>
 
 
-rtimer_t *rtimer_next = NULL;
+/* Pending rtimers, ordered by their stop time. rtimer_queue[0] is the one
+   the hardware alarm is programmed for. */
+static rtimer_t *rtimer_queue[CONFIG_MYOS_RTIMER_QUEUE_SIZE];
+static uint8_t rtimer_queue_count = 0;
+
+/* Stop time the hardware alarm is currently programmed for. */
+static rtimer_timestamp_t rtimer_alarm_stop;
+static bool rtimer_alarm_armed = false;
+
 mutex_t rtimer_mutex = false;
 
+/* The process holding the rtimer lock and the rtimer it has started. The
+   lock is released once that rtimer has fired and its callback has not
+   started it again, or when it is stopped. */
+static process_t *rtimer_holder = NULL;
+static rtimer_t *rtimer_locked = NULL;
+
 bool rtimer_lock(void)
 {
-   return mutex_lock(&rtimer_mutex);
-}
+   bool status = false;
+
+   // An ISR has no process which could hold the lock.
+   if( k_is_in_isr() )
+   {
+      return false;
+   }
 
-void rtimer_release()
-{   
-   rtimer_next = NULL;
-   mutex_release(&rtimer_mutex);
+   CRITICAL_SECTION_BEGIN();
+
+   if( mutex_lock(&rtimer_mutex) )
+   {
+      rtimer_holder = PROCESS_THIS();
+      rtimer_locked = NULL;
+      status = true;
+   }
+
+   CRITICAL_SECTION_END();
+
+   return status;
 }
 
 bool rtimer_is_locked()
@@ -55,16 +88,203 @@ bool rtimer_is_locked()
    return mutex_is_locked(&rtimer_mutex);
 }
 
+bool rtimer_is_pending(rtimer_t *rtimer)
+{
+   bool status;
+   CRITICAL_STATEMENT(status = rtimer->pending);
+   return status;
+}
+
+
+/* Must be called inside a critical section. */
+static void rtimer_queue_remove(rtimer_t *rtimer)
+{
+   uint8_t idx = 0;
+
+   while( idx < rtimer_queue_count && rtimer_queue[idx] != rtimer )
+   {
+      idx++;
+   }
+
+   rtimer->pending = false;
+
+   if( idx == rtimer_queue_count )
+   {
+      return;
+   }
+
+   rtimer_queue_count--;
+
+   for( ; idx < rtimer_queue_count; idx++ )
+   {
+      rtimer_queue[idx] = rtimer_queue[idx+1];
+   }
+}
+
+/* Must be called inside a critical section. Releases the rtimer lock if the
+   rtimer is the one of the lock holder. */
+static void rtimer_unlock(rtimer_t *rtimer)
+{
+   if( rtimer == rtimer_locked )
+   {
+      rtimer_holder = NULL;
+      rtimer_locked = NULL;
+      mutex_release(&rtimer_mutex);
+   }
+}
 
-void rtimer_scheduler (void)
+/* Polls the process waiting for the rtimer, unless it is pending again. */
+static void rtimer_wakeup(rtimer_t *rtimer)
 {
-   rtimer_t *rtimer = rtimer_next;
-   rtimer_release();
+   process_t *waiter = NULL;
+
+   CRITICAL_SECTION_BEGIN();
 
-   if( rtimer->callback )
+   if( !rtimer->pending )
    {
-      rtimer->callback(rtimer->data);
+      waiter = rtimer->waiter;
+      rtimer->waiter = NULL;
    }
+
+   CRITICAL_SECTION_END();
+
+   if( waiter )
+   {
+      process_poll(waiter);
+   }
+}
+
+bool rtimer_wait(rtimer_t *rtimer, struct process_t *process)
+{
+   bool status;
+
+   CRITICAL_SECTION_BEGIN();
+
+   status = rtimer->pending;
+
+   if( status )
+   {
+      rtimer->waiter = process;
+   }
+
+   CRITICAL_SECTION_END();
+
+   return status;
+}
+
+/* Must be called inside a critical section. Programs the hardware alarm for
+   the head of the queue unless it is already programmed for that stop time. */
+static void rtimer_queue_update(void)
+{
+   if( rtimer_queue_count == 0 )
+   {
+      return;
+   }
+
+   rtimer_timestamp_t stop = rtimer_timestamp_stop(rtimer_queue[0]);
+
+   if( !rtimer_alarm_armed || stop != rtimer_alarm_stop )
+   {
+      rtimer_alarm_stop = stop;
+      rtimer_alarm_armed = true;
+      rtimer_arch_timer_set(stop);
+   }
+}
+
+/* With lock set, the rtimer keeps the rtimer lock until it has fired or is
+   stopped, unless another rtimer keeps it already. An rtimer keeping the
+   lock also keeps it when it is scheduled again. */
+static bool rtimer_schedule(rtimer_t *rtimer, bool lock)
+{
+   bool status = false;
+   rtimer_timestamp_t stop = rtimer_timestamp_stop(rtimer);
+
+   CRITICAL_SECTION_BEGIN();
+
+   if( rtimer->pending )
+   {
+      rtimer_queue_remove(rtimer);
+   }
+
+   if( rtimer_queue_count < CONFIG_MYOS_RTIMER_QUEUE_SIZE )
+   {
+      uint8_t idx = rtimer_queue_count++;
+
+      // Insert behind all rtimers stopping at the same time or earlier.
+      while( idx && rtimer_timestamp_less_than(stop, rtimer_timestamp_stop(rtimer_queue[idx-1])) )
+      {
+         rtimer_queue[idx] = rtimer_queue[idx-1];
+         idx--;
+      }
+
+      rtimer_queue[idx] = rtimer;
+      rtimer->pending = true;
+      status = true;
+
+      if( lock && rtimer_locked == NULL && mutex_is_locked(&rtimer_mutex) )
+      {
+         rtimer_locked = rtimer;
+      }
+   }
+
+   rtimer_queue_update();
+
+   CRITICAL_SECTION_END();
+
+   return status;
+}
+
+
+UTILS_HOT_FUNC void rtimer_scheduler (void)
+{
+   rtimer_t *rtimer;
+
+   CRITICAL_STATEMENT(rtimer_alarm_armed = false);
+
+   do
+   {
+      rtimer = NULL;
+
+      CRITICAL_SECTION_BEGIN();
+
+      if( rtimer_queue_count && rtimer_expired(rtimer_queue[0]) )
+      {
+         rtimer = rtimer_queue[0];
+         rtimer_queue_remove(rtimer);
+      }
+
+      CRITICAL_SECTION_END();
+
+      // The callback may start rtimers again, including the expired one.
+      if( rtimer && rtimer->callback )
+      {
+         TRACE(TRACE_RTIMER, 0, 0, rtimer, rtimer->callback);
+#if defined(CONFIG_MYOS_WCET_RTIMER)
+         wcet_time_t start = wcet_now();
+         rtimer->callback(rtimer->data);
+         wcet_count(&rtimer->wcet, WCET_PROBE_RTIMER, rtimer, wcet_now() - start);
+#else
+         rtimer->callback(rtimer->data);
+#endif
+      }
+
+      if( rtimer )
+      {
+         // The lock stays with an rtimer its callback has started again.
+         CRITICAL_SECTION_BEGIN();
+
+         if( !rtimer->pending )
+         {
+            rtimer_unlock(rtimer);
+         }
+
+         CRITICAL_SECTION_END();
+
+         rtimer_wakeup(rtimer);
+      }
+   } while( rtimer );
+
+   CRITICAL_STATEMENT(rtimer_queue_update());
 }
 
 rtimer_timespan_t rtimer_left(rtimer_t *rtimer)
@@ -80,26 +300,41 @@ rtimer_timespan_t rtimer_left(rtimer_t *rtimer)
     return 0;
 }
 
-void rtimer_start(rtimer_t *rtimer, rtimer_timespan_t span, rtimer_callback_t callback, void* data)
+bool rtimer_start(rtimer_t *rtimer, rtimer_timespan_t span, rtimer_callback_t callback, void* data)
 {
    rtimer->start = rtimer_now();
    rtimer->span = span;
    rtimer->callback = callback;
    rtimer->data = data;
-   rtimer_next = rtimer;
-   rtimer_arch_timer_set(rtimer_timestamp_stop(rtimer));
+   return rtimer_schedule(rtimer, !k_is_in_isr() && rtimer_holder == PROCESS_THIS());
 }
 
-void rtimer_restart(rtimer_t *rtimer)
+bool rtimer_restart(rtimer_t *rtimer)
 {
    rtimer->start = rtimer_now();
-   rtimer_next = rtimer;
-   rtimer_arch_timer_set(rtimer_timestamp_stop(rtimer));
+   return rtimer_schedule(rtimer, false);
 }
 
-void rtimer_reset(rtimer_t *rtimer)
+bool rtimer_reset(rtimer_t *rtimer)
 {
    rtimer->start += rtimer->span;
-   rtimer_next = rtimer;
-   rtimer_arch_timer_set(rtimer_timestamp_stop(rtimer));
+   return rtimer_schedule(rtimer, false);
+}
+
+void rtimer_stop(rtimer_t *rtimer)
+{
+   CRITICAL_SECTION_BEGIN();
+
+   if( rtimer->pending )
+   {
+      rtimer_queue_remove(rtimer);
+      rtimer_unlock(rtimer);
+
+      // A stale alarm for the removed head just finds nothing expired.
+      rtimer_queue_update();
+   }
+
+   CRITICAL_SECTION_END();
+
+   rtimer_wakeup(rtimer);
 }
@@ -38,6 +38,7 @@
 #include "rtimer_arch.h"
 #include "stdbool.h"
 #include "mutex.h"
+#include "wcet.h"
 
 typedef rtimer_arch_timestamp_t rtimer_timestamp_t;
 typedef rtimer_timestamp_t rtimer_timespan_t;
@@ -49,11 +50,18 @@ typedef rtimer_timestamp_t rtimer_timespan_t;
 #define rtimer_timestamp_less_than(a,b)    (RTIMER_TIMESTAMP_DIFF((a),(b)) < 0)
 typedef void(*rtimer_callback_t)(void* data);
 
+struct process_t;
+
 typedef struct {
    rtimer_timestamp_t start;
    rtimer_timespan_t span;
    rtimer_callback_t callback;
    void* data;
+   bool pending;
+   struct process_t *waiter;
+#if defined(CONFIG_MYOS_WCET_RTIMER)
+   wcet_probe_t wcet;
+#endif
 } rtimer_t;
 
 
@@ -73,15 +81,43 @@ typedef struct {
       }                                      \
    }while(0)
 
+/* Waits until the given rtimer has fired or has been stopped. Unlike
+   PROCESS_RTIMER_ACQUIRE()/PROCESS_RTIMER_JOIN() this does not serialize
+   against other processes using rtimers. The rtimer interrupt polls the
+   waiting process, it does not run in between. */
+#define PROCESS_RTIMER_WAIT(rtimerptr)                      \
+   do{                                                      \
+      while( rtimer_wait(rtimerptr, PROCESS_THIS()) )       \
+      {                                                     \
+         PROCESS_WAIT_EVENT(PROCESS_EVENT_POLL);            \
+      }                                                     \
+   }while(0)
+
 
 
 
 
-void rtimer_start(rtimer_t *rtimer, rtimer_timespan_t span, rtimer_callback_t callback, void* data);
-void rtimer_reset(rtimer_t *rtimer);
+/* Up to CONFIG_MYOS_RTIMER_QUEUE_SIZE rtimers can be pending at the same
+   time. They are kept in a queue ordered by their stop time and the
+   hardware alarm is only reprogrammed when the head of the queue changes.
+   Starting an rtimer which is already pending moves it to its new stop
+   time. The start functions return false if the queue is full. */
+bool rtimer_start(rtimer_t *rtimer, rtimer_timespan_t span, rtimer_callback_t callback, void* data);
+bool rtimer_restart(rtimer_t *rtimer);
+bool rtimer_reset(rtimer_t *rtimer);
+void rtimer_stop(rtimer_t *rtimer);
+bool rtimer_is_pending(rtimer_t *rtimer);
+/* Returns whether the rtimer is pending and, if so, has the process polled
+   once it has fired or has been stopped. Used by PROCESS_RTIMER_WAIT(). */
+bool rtimer_wait(rtimer_t *rtimer, struct process_t *process);
 rtimer_timespan_t rtimer_left(rtimer_t *rtimer);
 #define rtimer_expired(rtimerptr) (rtimer_left(rtimerptr) == 0)
-#define rtimer_timestamp_stop(rtimerptr) ((rtimerptr)->start+(rtimerptr)->span)
+#define rtimer_timestamp_stop(rtimerptr) ((rtimer_timestamp_t)((rtimerptr)->start+(rtimerptr)->span))
+
+/* The first rtimer the lock holder starts keeps the rtimer lock. The lock is
+   released after that rtimer has fired and its callback has run, unless the
+   callback started it again, or when it is stopped. Other pending rtimers do
+   not hold it. rtimer_lock() returns false in ISR context. */
 bool rtimer_lock(void);
 bool rtimer_is_locked();
 
@@ -99,11 +99,17 @@ slist_node_t* slist_prev_prev(slist_t *slist, void* node)
 
 slist_node_t* slist_prev(slist_t *slist, void* node)
 {
-    slist_node_t *iterator = node;
+    return slist_prev_from(slist != NULL ? slist : node, node);
+}
+
 
-    while( slist_next(slist,iterator) != node )
+slist_node_t* slist_prev_from(slist_node_t *from, void* node)
+{
+    slist_node_t *iterator = from;
+
+    while( slist_next(from,iterator) != node )
     {
-        iterator = slist_next(slist,iterator);
+        iterator = slist_next(from,iterator);
     }
 
     return iterator;
@@ -319,7 +319,7 @@
     do{ \
         ((slist_node_t*)(node_to_add))->next = (slist)->next; \
         (slist)->next=((slist_node_t*)(node_to_add)); \
-    }while(0);
+    }while(0)
 
 /**
  * @brief Removes the first element from a circular singly linked list.
@@ -530,6 +530,36 @@
         slist_prev(slistptr,nodeptr)->next = ((slist_node_t*)(nodeptr))->next;      \
     }while(0)
 
+/**
+ * @brief Removes a node from a circular singly linked list, starting the search for its predecessor at a hint.
+ * @details The hint is any node of the list in front of `nodeptr`, or the list head. While
+ *          iterating, the previously visited node is the predecessor itself, so the erase is
+ *          O(1). If the hint is not the predecessor the list is walked from the hint on.
+ *
+ * Usage:
+ * @code
+ * slist_node_t *prev = &mylist;
+ * slist_node_t *curr = slist_begin(&mylist);
+ * while (curr != slist_end(&mylist)) {
+ *     slist_node_t *next = slist_next(&mylist, curr);
+ *     if (done(curr)) {
+ *         slist_erase_hint(&mylist, prev, curr);
+ *     } else {
+ *         prev = curr;
+ *     }
+ *     curr = next;
+ * }
+ * @endcode
+ *
+ * @param slistptr A pointer to the head of the circular singly linked list.
+ * @param hintptr A pointer to the list head or a node in front of `nodeptr`.
+ * @param nodeptr A pointer to the node to be removed from the list.
+ */
+#define slist_erase_hint(slistptr,hintptr,nodeptr)                                  \
+    do{                                                                             \
+        slist_prev_from(hintptr,nodeptr)->next = ((slist_node_t*)(nodeptr))->next;  \
+    }while(0)
+
 /*!
  * @typedef slist_node_t
  * @brief Typedef for the structure representing a node in a circular singly linked list.
@@ -577,9 +607,11 @@ typedef slist_node_t slist_t; /*!< List instance is also a member of the list */
  * @brief Finds the previous node in a circular singly linked list.
  * @details This function searches for the node that precedes a specified node (`node`)
  *          in a circular singly linked list. Since the list is singly linked, the function
- *          traverses the list starting from the specified node and continues until it loops
- *          back to the same node. The node immediately before this loop-back is the predecessor
- *          of the given node.
+ *          traverses the list starting from the list head, so the cost grows with the
+ *          position of the node. Without a list head (`slist` is NULL) it starts from the
+ *          specified node and continues until it loops back to the same node, which always
+ *          visits the whole list. The node immediately before this loop-back is the
+ *          predecessor of the given node.
  *
  *          This traversal is necessary due to the singly linked nature of the list, as there
  *          are no direct pointers to previous nodes. The function is useful for operations
@@ -608,6 +640,16 @@ typedef slist_node_t slist_t; /*!< List instance is also a member of the list */
  */
 slist_node_t* slist_prev(slist_t *slist, void *existing_node);
 
+/**
+ * @brief Finds the previous node of `node`, walking forward from `from`.
+ * @details O(1) if `from` is the predecessor, see slist_erase_hint().
+ *
+ * @param from A pointer to the list head or a node in front of `node`.
+ * @param node A pointer to the node whose predecessor is to be found.
+ * @return A pointer to the predecessor of the specified node.
+ */
+slist_node_t* slist_prev_from(slist_node_t *from, void *node);
+
 /**
  * @brief Counts the number of nodes in a circular singly linked list.
  * @details This function calculates and returns the number of elements (nodes)
@@ -775,4 +817,96 @@ slist_node_t* slist_prev_prev(slist_t *slist, void* node);
  */
 slist_node_t* slist_find(slist_t *slist, void *node);
 
+
+/**
+ * @struct slistt_t
+ * @brief Circular singly linked list which also tracks its last node.
+ *
+ * @details The nodes are plain slist_node_t and the list is circular through `head` like an
+ *          slist_t, so all read-only slist operations work on `&list->head`. Keeping the
+ *          tail makes slistt_back() and slistt_push_back() O(1) at the cost of one pointer
+ *          per list instead of one per node as with a dlist. Only the slistt operations may
+ *          modify the list, they keep `tail` up to date.
+ *
+ * @var slistt_t::head
+ * Head node of the circular list.
+ * @var slistt_t::tail
+ * Last node of the list, `&head` if the list is empty.
+ */
+typedef struct {
+    slist_node_t head;
+    slist_node_t *tail;
+} slistt_t;
+
+/**
+ * @brief Static initializer of an empty slistt_t named `name`.
+ */
+#define SLISTT_INITIALIZER(name) {.head = {.next = &(name).head}, .tail = &(name).head}
+
+#define slistt_init(slisttptr) \
+    do{ \
+        slist_init(&(slisttptr)->head); \
+        (slisttptr)->tail = &(slisttptr)->head; \
+    }while(0)
+
+#define slistt_list(slisttptr)                  (&(slisttptr)->head)
+#define slistt_next(slisttptr,node)             slist_next(slistt_list(slisttptr),node)
+#define slistt_begin(slisttptr)                 slist_begin(slistt_list(slisttptr))
+#define slistt_front(slisttptr)                 slist_front(slistt_list(slisttptr))
+#define slistt_back(slisttptr)                  ((slisttptr)->tail)
+#define slistt_end(slisttptr)                   slist_end(slistt_list(slisttptr))
+#define slistt_empty(slisttptr)                 slist_empty(slistt_list(slisttptr))
+#define slistt_foreach(slisttptr,iterator)      slist_foreach(slistt_list(slisttptr),iterator)
+#define slistt_size(slisttptr)                  slist_size(slistt_list(slisttptr))
+#define slistt_find(slisttptr,nodeptr)          slist_find(slistt_list(slisttptr),nodeptr)
+
+#define slistt_push_front(slisttptr,nodeptr) \
+    do{ \
+        if(slistt_empty(slisttptr)) \
+        { \
+            (slisttptr)->tail = (slist_node_t*)(nodeptr); \
+        } \
+        slist_push_front(slistt_list(slisttptr),nodeptr); \
+    }while(0)
+
+#define slistt_push_back(slisttptr,nodeptr) \
+    do{ \
+        slist_insert_after(slistt_list(slisttptr),(slisttptr)->tail,nodeptr); \
+        (slisttptr)->tail = (slist_node_t*)(nodeptr); \
+    }while(0)
+
+#define slistt_insert_after(slisttptr,posptr,nodeptr) \
+    do{ \
+        slist_insert_after(slistt_list(slisttptr),posptr,nodeptr); \
+        if((slist_node_t*)(posptr) == (slisttptr)->tail) \
+        { \
+            (slisttptr)->tail = (slist_node_t*)(nodeptr); \
+        } \
+    }while(0)
+
+#define slistt_pop_front(slisttptr) \
+    do{ \
+        if(slistt_begin(slisttptr) == (slisttptr)->tail) \
+        { \
+            (slisttptr)->tail = slistt_list(slisttptr); \
+        } \
+        slist_pop_front(slistt_list(slisttptr)); \
+    }while(0)
+
+/**
+ * @brief Removes a node, see slist_erase_hint(). Without a better hint pass slistt_list().
+ */
+#define slistt_erase_hint(slisttptr,hintptr,nodeptr) \
+    do{ \
+        slist_node_t *__slistt_prev__ = slist_prev_from(hintptr,nodeptr); \
+        __slistt_prev__->next = ((slist_node_t*)(nodeptr))->next; \
+        if((slist_node_t*)(nodeptr) == (slisttptr)->tail) \
+        { \
+            (slisttptr)->tail = __slistt_prev__; \
+        } \
+    }while(0)
+
+#define slistt_erase(slisttptr,nodeptr) \
+    slistt_erase_hint(slisttptr,slistt_list(slisttptr),nodeptr)
+
 #endif /* SLIST_H_ */
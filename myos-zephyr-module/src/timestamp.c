@@ -1,4 +1,5 @@
 #include "timestamp.h"
+#include "myos.h"
 #include "debug.h"
 
 
@@ -12,4 +13,38 @@ void timestamp_module_init(void)
 {
       timestamp_arch_module_init();
       DBG("timestamp: initialized, ticks per sec: %d\n", TIMESTAMP_TICKS_PER_SEC);
-}
\ No newline at end of file
+}
+
+#if defined(CONFIG_MYOS_TIMESTAMP_NOW64) && CONFIG_MYOS_TIMESTAMP_SIZE < 64
+
+/* Last value handed out by timestamp_now64(), its low bits equal the timestamp at that time. */
+static timestamp64_t timestamp_last64;
+
+/* Calls timestamp_now64() often enough to never miss a wraparound. */
+static ptimer_t timestamp_epoch_ptimer;
+
+timestamp64_t timestamp_now64(void)
+{
+      timestamp64_t now64;
+
+      CRITICAL_SECTION_BEGIN();
+      timestamp_last64 += (timestamp_t)(timestamp_now() - (timestamp_t)timestamp_last64);
+      now64 = timestamp_last64;
+      CRITICAL_SECTION_END();
+
+      return now64;
+}
+
+static void timestamp_epoch_handler(ptimer_t *ptimer)
+{
+      timestamp_now64();
+      ptimer_reset(ptimer);
+}
+
+void timestamp64_module_init(void)
+{
+      timestamp_last64 = timestamp_now();
+      ptimer_start(&timestamp_epoch_ptimer, TIMESTAMP_QUARTER_RANGE, timestamp_epoch_handler);
+}
+
+#endif /* CONFIG_MYOS_TIMESTAMP_NOW64 */
@@ -171,6 +171,63 @@ void timestamp_module_init(void);
  */
 #define timestamp_now timestamp_arch_now
 
+#if defined(CONFIG_MYOS_TIMESTAMP_NOW64)
+
+/**
+ * @typedef timestamp64_t
+ * @brief Monotonic 64-bit timestamp which does not wrap around in practice.
+ */
+typedef uint64_t timestamp64_t;
+
+/**
+ * @def TIMESTAMP_QUARTER_RANGE
+ * @brief A quarter of the range of timestamp_t.
+ * @details Longest span the 64-bit layer arms a ptimer for. Staying well below half the range keeps
+ *          TIMESTAMP_DIFF() unambiguous even if the ptimer process runs late.
+ */
+#define TIMESTAMP_QUARTER_RANGE ((timespan_t)((timestamp_t)1 << (CONFIG_MYOS_TIMESTAMP_SIZE - 2)))
+
+#if CONFIG_MYOS_TIMESTAMP_SIZE < 64
+/**
+ * @brief Retrieves the current timestamp extended to 64 bits.
+ * @details The hot path keeps using the short timestamp_t. The wraparounds of timestamp_now() are
+ *          accumulated into a 64-bit epoch, which is brought up to date by every call and at least
+ *          once per TIMESTAMP_QUARTER_RANGE by a ptimer started in timestamp64_module_init(). Can be
+ *          called from ISRs.
+ * @return The current timestamp, continuing the value timestamp_now() had at timestamp64_module_init().
+ */
+timestamp64_t timestamp_now64(void);
+
+/**
+ * @brief Starts the ptimer which keeps the 64-bit epoch up to date.
+ * @details Must be called after ptimer_module_init().
+ */
+void timestamp64_module_init(void);
+#else
+#define timestamp_now64() ((timestamp64_t)timestamp_now())
+#define timestamp64_module_init() do{}while(0)
+#endif
+
+#endif /* CONFIG_MYOS_TIMESTAMP_NOW64 */
+
+/**
+ * @def timestamp_alarm_update
+ * @brief Tells the timestamp module that the next ptimer deadline may have changed.
+ * @details In tickless mode (CONFIG_MYOS_TIMESTAMP_TICKLESS) there is no periodic tick which
+ *          checks ptimer_next_stop. Instead the counter alarm is programmed for it, so it has to be
+ *          reprogrammed whenever ptimer_next_stop or ptimer_pending changed. Without tickless mode
+ *          this macro does nothing.
+ *
+ * @example
+ * ptimer_add_to_list(&my_ptimer);
+ * timestamp_alarm_update();
+ */
+#if defined(CONFIG_MYOS_TIMESTAMP_TICKLESS)
+#define timestamp_alarm_update() timestamp_arch_alarm_update()
+#else
+#define timestamp_alarm_update() do{}while(0)
+#endif
+
 
 /**
  * @def timestamp_less_than(a, b)
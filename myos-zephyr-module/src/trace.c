@@ -26,38 +26,43 @@
    OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include "trace.h"
 
-/*!
-    \file       timestamp_arch.h
+#if defined(CONFIG_MYOS_TRACE)
 
-    \brief      Architecture depending part of time stamp implementation
+#include <zephyr/sys/printk.h>
 
-    \details    Provides the architecture dependent part of time stamp implementation
-                for architecture hosted.
+_Static_assert((CONFIG_MYOS_TRACE_BUFFER_SIZE & TRACE_BUFFER_MASK) == 0,
+               "CONFIG_MYOS_TRACE_BUFFER_SIZE must be a power of two");
+_Static_assert(sizeof(trace_record_t) == 16, "trace records must be 16 bytes");
 
-                Hosted means that the myos runs in an own process on top of a host
-                operating system.
+trace_buffer_t trace_buffer = {
+   .magic = {'M','Y','T','R'},
+   .version = 1,
+   .record_size = sizeof(trace_record_t),
+   .timestamp_bits = 8 * sizeof(rtimer_timestamp_t),
+   .enabled = 1,
+   .ticks_per_sec = RTIMER_TICKS_PER_SEC,
+   .size = CONFIG_MYOS_TRACE_BUFFER_SIZE,
+   .count = 0
+};
 
-*/
-
-
-#ifndef TIMESTAMP_ARCH_H_
-#define TIMESTAMP_ARCH_H_
-
-#include <stdint.h>
-#include "utils.h"
- 
-
-#define TIMESTAMP_ARCH_TICKS_PER_SEC 1000
 
-typedef UTILS_UINT(CONFIG_MYOS_TIMESTAMP_SIZE) timestamp_arch_t;
+void trace_dump(void)
+{
+   const uint8_t *p = (const uint8_t*)&trace_buffer;
+   uint8_t enabled = trace_buffer.enabled;
 
-/* Safe wrap-around difference */
-#define TIMESTAMP_ARCH_DIFF(a, b) \
-    ((UTILS_INT(CONFIG_MYOS_TIMESTAMP_SIZE))((timestamp_arch_t)(a) - (timestamp_arch_t)(b)))
+   trace_buffer.enabled = 0;
 
+   printk("MYOS-TRACE-BEGIN\n");
+   for(size_t i = 0; i < sizeof(trace_buffer); i++)
+   {
+      printk("%02x%s", p[i], (i % 32) == 31 || i == sizeof(trace_buffer) - 1 ? "\n" : "");
+   }
+   printk("MYOS-TRACE-END\n");
 
-void timestamp_arch_module_init(void);
-timestamp_arch_t timestamp_arch_now(void);
+   trace_buffer.enabled = enabled;
+}
 
-#endif /* TIMESTAMP_ARCH_H_ */
+#endif /* CONFIG_MYOS_TRACE */
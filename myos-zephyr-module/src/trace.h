@@ -0,0 +1,163 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file trace.h
+ *
+ * @brief Binary event trace of the MyOS scheduler.
+ * @details Unlike the DBG_* printf output, tracing only stores fixed-size records in a RAM
+ *          ring, so it hardly changes the timing of the traced code. Every record holds an
+ *          rtimer timestamp, a record type, an event id and two addresses (processes, timers
+ *          or callbacks). The ring keeps the last CONFIG_MYOS_TRACE_BUFFER_SIZE records.
+ *
+ *          The trace is written by process_post(), process_post_isr(), process_post_remote(),
+ *          process_deliver_event(), the ptimer expiry and the rtimer scheduler. Applications
+ *          may add records of their own with trace_record() and a type from TRACE_USER on.
+ *
+ *          The ring is self-describing: it can be read by a debugger from the `trace_buffer`
+ *          symbol, e.g. with GDB's `dump binary value trace.bin trace_buffer`, or printed as
+ *          hex lines with trace_dump(). Both are decoded on the host with
+ *          scripts/myos_trace.py, which names the addresses if the ELF file is given.
+ *
+ * Usage Example:
+ * @code
+ *     trace_record(TRACE_USER, 1, adc_value, &adc_process, NULL);
+ *     ...
+ *     trace_dump();
+ * @endcode
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "critical.h"
+#include "rtimer.h"
+
+#if defined(CONFIG_MYOS_TRACE)
+
+#define TRACE_BUFFER_MASK (CONFIG_MYOS_TRACE_BUFFER_SIZE - 1)
+
+/*!
+ * @brief Record types. Record fields as (id, arg, a, b).
+ */
+enum {
+   TRACE_POST = 1,         /*!< (event id, priority, from, to) */
+   TRACE_POST_ISR,         /*!< (event id, 0, NULL, to) */
+   TRACE_POST_REMOTE,      /*!< (event id, 0, NULL, to) */
+   TRACE_DELIVER,          /*!< (event id, 0, from, to), the handler starts */
+   TRACE_DELIVER_DONE,     /*!< (event id, protothread state, from, to), the handler returned */
+   TRACE_PTIMER,           /*!< (0, 0, ptimer, handler), a ptimer expired */
+   TRACE_RTIMER,           /*!< (0, 0, rtimer, callback), an rtimer expired */
+   TRACE_POST_DEADLINE,    /*!< (event id, deadline, from, to) */
+   TRACE_DELIVER_FILTERED, /*!< (event id, 0, from, to), dropped by the event filter */
+   TRACE_DELIVER_SUSPENDED, /*!< (event id, 1 if parked or 0 if dropped, from, to), the target is suspended */
+   TRACE_USER = 0x80       /*!< First record type free for applications */
+};
+
+/*!
+ * @struct trace_record_t
+ * @brief A trace record, 16 bytes in target byte order.
+ */
+typedef struct {
+   uint32_t timestamp;  /*!< rtimer timestamp */
+   uint8_t type;        /*!< Record type */
+   uint8_t id;          /*!< Event id */
+   uint16_t arg;        /*!< Type specific argument */
+   uint32_t a;          /*!< First address */
+   uint32_t b;          /*!< Second address */
+}trace_record_t;
+
+/*!
+ * @struct trace_buffer_t
+ * @brief The trace ring with a header describing its layout to the host decoder.
+ */
+typedef struct {
+   char magic[4];             /*!< "MYTR" */
+   uint8_t version;           /*!< Layout version, currently 1 */
+   uint8_t record_size;       /*!< sizeof(trace_record_t) */
+   uint8_t timestamp_bits;    /*!< Width of the rtimer timestamps */
+   volatile uint8_t enabled;  /*!< Records are only written while set */
+   uint32_t ticks_per_sec;    /*!< RTIMER_TICKS_PER_SEC */
+   uint32_t size;             /*!< Number of records of the ring */
+   volatile uint32_t count;   /*!< Number of records written so far, the next one goes to count % size */
+   trace_record_t records[CONFIG_MYOS_TRACE_BUFFER_SIZE];
+}trace_buffer_t;
+
+extern trace_buffer_t trace_buffer;
+
+/*!
+ * @brief Writes a trace record.
+ * @details Safe to be called from ISRs, the slot is claimed in a short critical section.
+ */
+static inline void trace_record(uint8_t type, uint8_t id, uint16_t arg, const void *a, const void *b)
+{
+   if(!trace_buffer.enabled)
+   {
+      return;
+   }
+
+   CRITICAL_SECTION_BEGIN();
+
+   trace_record_t *record = &trace_buffer.records[trace_buffer.count++ & TRACE_BUFFER_MASK];
+   record->timestamp = rtimer_now();
+   record->type = type;
+   record->id = id;
+   record->arg = arg;
+   record->a = (uint32_t)(uintptr_t)a;
+   record->b = (uint32_t)(uintptr_t)b;
+
+   CRITICAL_SECTION_END();
+}
+
+/*!
+ * @brief Enables or disables tracing. Tracing is enabled from reset.
+ */
+#define trace_enable(on) (trace_buffer.enabled = (on))
+
+/*!
+ * @brief Discards all records.
+ */
+#define trace_clear() CRITICAL_STATEMENT(trace_buffer.count = 0)
+
+/*!
+ * @brief Prints the trace ring as hex lines, for scripts/myos_trace.py.
+ * @details Tracing is paused while the ring is printed.
+ */
+void trace_dump(void);
+
+#define TRACE(type, id, arg, a, b) trace_record(type, id, arg, a, b)
+
+#else
+
+#define TRACE(type, id, arg, a, b) do{}while(0)
+
+#endif /* CONFIG_MYOS_TRACE */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,158 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "uartsink.h"
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_MYOS_UARTSINK)
+
+RINGBUFFER_T(uartsink_buffer) uartsink_buffer;
+
+static const struct device *const uartsink_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+
+// Set once the asynchronous API of the UART has been set up.
+static bool uartsink_ready;
+
+// Length of the running transfer, 0 if the UART is idle. Only used by the MyOS thread.
+static size_t uartsink_busy;
+
+// Bytes sent by the last transfer, written by the UART callback.
+static size_t uartsink_sent;
+
+static process_t *uartsink_listener;
+static process_event_id_t uartsink_evtid;
+
+
+static void uartsink_callback(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+   ARG_UNUSED(dev);
+   ARG_UNUSED(user_data);
+
+   if(evt->type == UART_TX_DONE || evt->type == UART_TX_ABORTED)
+   {
+      __atomic_store_n(&uartsink_sent, evt->data.tx.len, __ATOMIC_RELEASE);
+      process_poll(&uartsink_process);
+   }
+}
+
+
+// Starts a transfer of the bytes up to the end of the ringbuffer storage or its tail.
+static void uartsink_start(void)
+{
+   size_t count = RINGBUFFER_SPSC_COUNT(uartsink_buffer);
+   size_t head = uartsink_buffer.head & RINGBUFFER_SPSC_MASK(uartsink_buffer);
+   size_t len = MIN(count, RINGBUFFER_SIZE(uartsink_buffer) - head);
+
+   if(!uartsink_ready || uartsink_busy || !len)
+   {
+      return;
+   }
+
+   uartsink_busy = len;
+   if(uart_tx(uartsink_dev, &RINGBUFFER_ITEMS(uartsink_buffer)[head], len, SYS_FOREVER_US) != 0)
+   {
+      // Retried with the next write.
+      uartsink_busy = 0;
+   }
+}
+
+
+size_t uartsink_write(const void *buf, size_t len)
+{
+   const uint8_t *src = buf;
+   size_t n = MIN(len, uartsink_space());
+   size_t tail = uartsink_buffer.tail & RINGBUFFER_SPSC_MASK(uartsink_buffer);
+   size_t first = MIN(n, RINGBUFFER_SIZE(uartsink_buffer) - tail);
+
+   memcpy(&RINGBUFFER_ITEMS(uartsink_buffer)[tail], src, first);
+   memcpy(RINGBUFFER_ITEMS(uartsink_buffer), src + first, n - first);
+   RINGBUFFER_SPSC_PUSH_N(uartsink_buffer, n);
+
+   uartsink_start();
+
+   return n;
+}
+
+
+void uartsink_notify(process_t *to, process_event_id_t evtid)
+{
+   uartsink_listener = to;
+   uartsink_evtid = evtid;
+}
+
+
+PROCESS(uartsink_process, uartsink_process);
+PROCESS_THREAD(uartsink_process)
+{
+   PROCESS_BEGIN();
+
+   for(;;)
+   {
+      PROCESS_WAIT_EVENT(PROCESS_EVENT_POLL);
+
+      if(uartsink_busy)
+      {
+         // An aborted transfer releases only what was sent, the rest goes out again.
+         RINGBUFFER_SPSC_POP_N(uartsink_buffer, __atomic_load_n(&uartsink_sent, __ATOMIC_ACQUIRE));
+         uartsink_busy = 0;
+         uartsink_start();
+
+         if(uartsink_listener)
+         {
+            process_post(uartsink_listener, uartsink_evtid, NULL);
+         }
+      }
+   }
+
+   PROCESS_END();
+}
+
+
+void uartsink_module_init(void)
+{
+   RINGBUFFER_SPSC_INIT(uartsink_buffer);
+   uartsink_busy = 0;
+   uartsink_listener = NULL;
+   uartsink_ready = false;
+
+   if(!device_is_ready(uartsink_dev) || uart_callback_set(uartsink_dev, uartsink_callback, NULL) != 0)
+   {
+      // Without the asynchronous API all output is dropped once the ringbuffer is full.
+      return;
+   }
+
+   uartsink_ready = true;
+   process_start(&uartsink_process, NULL);
+}
+
+#endif /* CONFIG_MYOS_UARTSINK */
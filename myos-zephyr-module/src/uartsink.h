@@ -0,0 +1,122 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file uartsink.h
+ *
+ * @brief Asynchronous console output of MyOS processes.
+ * @details printk() and the immediate logging mode write the console UART by polling,
+ *          so a process printing a screenful blocks the MyOS thread for the whole time on
+ *          the wire. uartsink_write() only copies the bytes into a ringbuffer. The
+ *          uartsink process hands the longest contiguous part of the ringbuffer to
+ *          uart_tx() of the UART asynchronous API, which the STM32 driver serves by DMA,
+ *          and starts the next transfer when the driver signals completion.
+ *
+ *          After every completed transfer the process registered with uartsink_notify()
+ *          receives an event, so a writer which found the ringbuffer full can wait for
+ *          room instead of dropping output. The functions may only be called by the MyOS
+ *          thread. The sink uses the zephyr,console UART, printk() can still be used on
+ *          it meanwhile.
+ *
+ * Usage Example:
+ * @code
+ *     uartsink_notify(PROCESS_THIS(), UARTSINK_EVENT);
+ *
+ *     for(row = 0; row < ROWS; row++)
+ *     {
+ *        if(uartsink_space() < sizeof(line))
+ *        {
+ *           PROCESS_WAIT_EVENT_UNTIL(uartsink_space() >= sizeof(line));
+ *        }
+ *        uartsink_write(line, sizeof(line));
+ *     }
+ * @endcode
+ */
+
+#ifndef UARTSINK_H_
+#define UARTSINK_H_
+
+#include "myos.h"
+#include "ringbuffer.h"
+
+#if defined(CONFIG_MYOS_UARTSINK)
+
+RINGBUFFER_SPSC_TYPEDEF(uartsink_buffer,uint8_t,CONFIG_MYOS_UARTSINK_BUFFER_SIZE);
+
+extern RINGBUFFER_T(uartsink_buffer) uartsink_buffer;
+
+PROCESS_EXTERN(uartsink_process);
+
+/*!
+ * @brief Queues bytes for output.
+ * @param[in] buf The bytes.
+ * @param[in] len Number of bytes.
+ * @return Number of bytes queued, less than len if the ringbuffer is full.
+ */
+size_t uartsink_write(const void *buf, size_t len);
+
+/*!
+ * @brief Queues a character for output.
+ * @return False if the ringbuffer is full.
+ */
+static inline bool uartsink_putc(char c)
+{
+   return uartsink_write(&c, 1) == 1;
+}
+
+/*!
+ * @brief Number of bytes uartsink_write() accepts right now.
+ */
+static inline size_t uartsink_space(void)
+{
+   return RINGBUFFER_SIZE(uartsink_buffer) - RINGBUFFER_SPSC_COUNT(uartsink_buffer);
+}
+
+/*!
+ * @brief Number of bytes which are not on the wire yet.
+ */
+static inline size_t uartsink_pending(void)
+{
+   return RINGBUFFER_SPSC_COUNT(uartsink_buffer);
+}
+
+/*!
+ * @brief Sets the process informed about completed transfers.
+ * @param[in] to The process, NULL for none.
+ * @param[in] evtid Event id, the event data is NULL.
+ */
+void uartsink_notify(process_t *to, process_event_id_t evtid);
+
+/*!
+ * @brief Initializes the sink and starts the uartsink process.
+ */
+void uartsink_module_init(void);
+
+#endif /* CONFIG_MYOS_UARTSINK */
+
+#endif /* UARTSINK_H_ */
@@ -19,4 +19,25 @@
 #define UTILS_INT_32          int32_t
 #define UTILS_INT_64          int64_t
 
+/*
+ * Placement of the scheduler hot paths in zero wait state memory. UTILS_HOT_FUNC moves a
+ * function to .ramfunc with CONFIG_MYOS_HOT_RAMFUNC, UTILS_HOT_BSS a zero initialized
+ * variable to DTCM with CONFIG_MYOS_HOT_DTCM.
+ */
+#if defined(CONFIG_MYOS_HOT_RAMFUNC) || defined(CONFIG_MYOS_HOT_DTCM)
+#include <zephyr/linker/section_tags.h>
+#endif
+
+#if defined(CONFIG_MYOS_HOT_RAMFUNC)
+#define UTILS_HOT_FUNC        __ramfunc
+#else
+#define UTILS_HOT_FUNC
+#endif
+
+#if defined(CONFIG_MYOS_HOT_DTCM)
+#define UTILS_HOT_BSS         __dtcm_bss_section
+#else
+#define UTILS_HOT_BSS
+#endif
+
 #endif /* UTILS_H_ */
@@ -0,0 +1,125 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "wcet.h"
+#include "critical.h"
+
+#if defined(CONFIG_MYOS_WCET)
+
+static wcet_probe_t *wcet_head;
+static wcet_probe_t *wcet_tail;
+
+
+void wcet_count(wcet_probe_t *probe, wcet_kind_t kind, const void *site, wcet_time_t time)
+{
+   // rtimer callbacks count from the interrupt, readers copy the probes in other threads.
+   CRITICAL_SECTION_BEGIN();
+
+   if(!probe->listed)
+   {
+      probe->kind = kind;
+      probe->site = site;
+      probe->next = NULL;
+      probe->listed = true;
+
+      if(wcet_tail)
+      {
+         wcet_tail->next = probe;
+      }
+      else
+      {
+         wcet_head = probe;
+      }
+      wcet_tail = probe;
+   }
+
+   if(probe->count == 0 || time < probe->min)
+   {
+      probe->min = time;
+   }
+   if(time > probe->max)
+   {
+      probe->max = time;
+   }
+   probe->count++;
+   probe->sum += time;
+
+   CRITICAL_SECTION_END();
+}
+
+
+void wcet_probe_get(const wcet_probe_t *probe, wcet_probe_t *copy)
+{
+   CRITICAL_STATEMENT(*copy = *probe);
+}
+
+
+wcet_probe_t* wcet_probe_next(wcet_probe_t *probe)
+{
+   wcet_probe_t *next;
+
+   CRITICAL_STATEMENT(next = probe ? probe->next : wcet_head);
+
+   return next;
+}
+
+
+void wcet_reset(void)
+{
+   CRITICAL_SECTION_BEGIN();
+
+   for(wcet_probe_t *probe = wcet_head; probe != NULL; probe = probe->next)
+   {
+      probe->count = 0;
+      probe->min = 0;
+      probe->max = 0;
+      probe->sum = 0;
+   }
+
+   CRITICAL_SECTION_END();
+}
+
+
+void wcet_module_init(void)
+{
+#if defined(CONFIG_MYOS_WCET_DWT)
+#if defined(CONFIG_ARMV8_M_MAINLINE)
+   DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+#if defined(CONFIG_CPU_CORTEX_M7)
+   // The DWT of the Cortex-M7 ignores writes until its lock access register is unlocked.
+   DWT->LAR = 0xC5ACCE55;
+#endif
+   // Not reset, the timing API and the benchmarks may be using it. The probes take differences.
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+#endif
@@ -0,0 +1,213 @@
+/*! \copyright
+ 
+   https://opensource.org/license/mit/
+
+   Copyright 2013-2023 Marco Bacchi <marco@bacchi.at>
+   
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use,
+   copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following
+   conditions:
+   
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+   
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+   OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+   HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+   WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+   OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*!
+ * @file wcet.h
+ *
+ * @brief Execution time probes of process threads, ctimer and rtimer callbacks.
+ * @details A probe records the number, the minimum, the maximum and the sum of the
+ *          execution times it has measured, so the observed worst case of every handler
+ *          can be checked against its budget. With CONFIG_MYOS_WCET_DWT the times are
+ *          CPU cycles of the DWT cycle counter (Cortex-M3 and up), otherwise rtimer
+ *          ticks, see WCET_TICKS_PER_SEC.
+ *
+ *          The scheduler probes the handlers selected in Kconfig, with a probe in every
+ *          process_t, ctimer_t and rtimer_t:
+ *          - CONFIG_MYOS_WCET_PROCESS: every delivery of an event to a process thread,
+ *            including the events it delivers synchronously to other processes.
+ *          - CONFIG_MYOS_WCET_CTIMER: every ctimer callback.
+ *          - CONFIG_MYOS_WCET_RTIMER: every rtimer callback, in the rtimer interrupt.
+ *
+ *          Interrupts which preempt a handler count to its time. A probe is listed by
+ *          wcet_probe_next() after its first measurement and must stay valid from then
+ *          on, so probed processes and timers must be static. Any other code is measured
+ *          with a probe of its own.
+ *
+ * Usage Example:
+ * @code
+ *     WCET_PROBE_DEFINE(fft_probe);
+ *
+ *     WCET_PROBE_BEGIN(fft_probe);
+ *     fft(samples);
+ *     WCET_PROBE_END(fft_probe);
+ *
+ *     wcet_probe_t probe;
+ *     wcet_probe_get(&fft_probe, &probe);
+ *     printk("fft: max %u, mean %u\n", probe.max, wcet_probe_mean(&probe));
+ * @endcode
+ */
+
+#ifndef WCET_H_
+#define WCET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtimer_arch.h"
+
+#if defined(CONFIG_MYOS_WCET)
+
+#if defined(CONFIG_MYOS_WCET_DWT)
+#include <cmsis_core.h>
+
+typedef uint32_t wcet_time_t;
+
+/*!
+ * @brief Ticks of the execution times per second, the CPU clock with the DWT.
+ */
+#define WCET_TICKS_PER_SEC    SystemCoreClock
+#else
+typedef rtimer_arch_timestamp_t wcet_time_t;
+
+#define WCET_TICKS_PER_SEC    RTIMER_ARCH_TICKS_PER_SEC
+#endif
+
+/*!
+ * @brief Kind of code a probe measures, see wcet_probe_t::site.
+ */
+typedef enum {
+   WCET_PROBE_USER,     /*!< Probe of WCET_PROBE_DEFINE(), site is NULL */
+   WCET_PROBE_PROCESS,  /*!< site is the process_t */
+   WCET_PROBE_CTIMER,   /*!< site is the ctimer_t */
+   WCET_PROBE_RTIMER    /*!< site is the rtimer_t */
+} wcet_kind_t;
+
+/*!
+ * @struct wcet_probe_t
+ * @brief Execution time statistics of one handler.
+ *
+ * @var wcet_probe_t::next
+ *      Next listed probe.
+ * @var wcet_probe_t::name
+ *      Name of a WCET_PROBE_DEFINE() probe, NULL otherwise.
+ * @var wcet_probe_t::site
+ *      Process or timer the probe belongs to.
+ * @var wcet_probe_t::kind
+ *      Kind of the site.
+ * @var wcet_probe_t::listed
+ *      Set once the probe is in the list of wcet_probe_next().
+ * @var wcet_probe_t::count
+ *      Number of measurements.
+ * @var wcet_probe_t::min
+ *      Shortest time, only valid if count is not 0.
+ * @var wcet_probe_t::max
+ *      Longest time.
+ * @var wcet_probe_t::sum
+ *      Sum of all times.
+ */
+typedef struct wcet_probe_t {
+   struct wcet_probe_t *next;
+   const char *name;
+   const void *site;
+   uint8_t kind;
+   bool listed;
+   uint32_t count;
+   wcet_time_t min;
+   wcet_time_t max;
+   uint64_t sum;
+} wcet_probe_t;
+
+/*!
+ * @brief Defines a probe for any code.
+ */
+#define WCET_PROBE_DEFINE(probe) \
+   wcet_probe_t probe = { .name = #probe, .kind = WCET_PROBE_USER }
+
+/*!
+ * @brief Starts measuring with a probe, must be followed by WCET_PROBE_END() in the same
+ *        block and must not span a protothread wait.
+ */
+#define WCET_PROBE_BEGIN(probe) \
+   { wcet_time_t wcet_start_ = wcet_now();
+
+/*!
+ * @brief Stops measuring with a probe and counts the time.
+ */
+#define WCET_PROBE_END(probe) \
+   wcet_count(&(probe), WCET_PROBE_USER, NULL, wcet_now() - wcet_start_); }
+
+/*!
+ * @brief Returns the current time of the execution time clock.
+ */
+static inline wcet_time_t wcet_now(void)
+{
+#if defined(CONFIG_MYOS_WCET_DWT)
+   return DWT->CYCCNT;
+#else
+   return rtimer_arch_now();
+#endif
+}
+
+/*!
+ * @brief Counts a measured time, lists the probe on its first measurement.
+ * @param[in] probe The probe.
+ * @param[in] kind Kind of the site, see wcet_kind_t.
+ * @param[in] site Process or timer the probe belongs to.
+ * @param[in] time Execution time, the difference of two wcet_now().
+ */
+void wcet_count(wcet_probe_t *probe, wcet_kind_t kind, const void *site, wcet_time_t time);
+
+/*!
+ * @brief Copies a probe, callable from any thread.
+ */
+void wcet_probe_get(const wcet_probe_t *probe, wcet_probe_t *copy);
+
+/*!
+ * @brief Mean time of a probe, 0 without measurements.
+ */
+static inline wcet_time_t wcet_probe_mean(const wcet_probe_t *probe)
+{
+   return probe->count ? (wcet_time_t)(probe->sum / probe->count) : 0;
+}
+
+/*!
+ * @brief Iterates the probes with measurements, in the order of their first measurement.
+ * @param[in] probe The current probe, NULL to get the first one.
+ * @return The next probe, NULL after the last one.
+ */
+wcet_probe_t* wcet_probe_next(wcet_probe_t *probe);
+
+/*!
+ * @brief Clears the measurements of all listed probes, they stay listed.
+ */
+void wcet_reset(void);
+
+/*!
+ * @brief Starts the DWT cycle counter, without resetting it.
+ */
+void wcet_module_init(void);
+
+#else
+
+#define WCET_PROBE_DEFINE(probe)    extern int wcet_unused_##probe
+#define WCET_PROBE_BEGIN(probe)     {
+#define WCET_PROBE_END(probe)       }
+
+#endif
+
+#endif /* WCET_H_ */